@@ -73,3 +73,13 @@ function Entity:GetRigidBodyComponent()
 
     return rigidBody
 end
+
+-- name is the C++ name of the component (e.g. "PointLightComponent")
+function Entity:HasComponent(name)
+    return InternalCalls.Entity.HasComponent(self.Handle, self.Scene, name)
+end
+
+-- NOTE: The component gets added once the scripts are done updating
+function Entity:AddComponent(name)
+    InternalCalls.Entity.AddComponent(self.Handle, self.Scene, name)
+end
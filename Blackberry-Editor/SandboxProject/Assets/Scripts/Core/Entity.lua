@@ -16,4 +16,47 @@ function Entity.new(handle, scene)
     return entity
 end
 
+-- Creates a new entity (optionally as a child of parent)
+-- NOTE: The entity only exists once the scripts are done updating (see Scene::OnUpdateRuntime), the handle can be used right away though
+function Entity.Create(scene, name, parent)
+    local handle = InternalCalls.Entity.Create(scene, name, parent and parent.Handle or 0)
+
+    return Entity.new(handle, scene)
+end
+
+-- Destroys the entity (and all of its children) once the scripts are done updating
+function Entity:Destroy()
+    InternalCalls.Entity.Destroy(self.Handle, self.Scene)
+end
+
+-- Name -> hash, so every name only gets hashed once per script (lookups after that only pass the hash over)
+local NameHashes = {}
+
+-- Returns the entity with the name (nil if there is none)
+function Entity.Find(scene, name)
+    local hash = NameHashes[name]
+
+    if not hash then
+        hash = InternalCalls.Entity.HashName(name)
+        NameHashes[name] = hash
+    end
+
+    local handle = InternalCalls.Entity.FindByName(scene, hash)
+    if handle == 0 then return nil end
+
+    return Entity.new(handle, scene)
+end
+
+-- Returns every entity (with a mesh, light or collider) whose bounds are within radius of position ({ x, y, z })
+-- NOTE: This goes by the bounds as of the last update, so entities created/moved this update don't show up yet
+function Entity.FindInRadius(scene, position, radius)
+    local entities = {}
+
+    for i, handle in ipairs(InternalCalls.Entity.QuerySphere(scene, position, radius)) do
+        entities[i] = Entity.new(handle, scene)
+    end
+
+    return entities
+end
+
 return Entity
@@ -6,6 +6,7 @@
 
 #include <fstream>
 #include <algorithm>
+#include <type_traits>
 
 using namespace Blackberry; // don't care about your personal opinion, this is fine
 
@@ -15,9 +16,11 @@ namespace BlackberryEditor {
 
 #pragma region HelperFunctions
     
+    // Returns true if the component got edited (uiFunctions which return a bool report whether they changed anything)
     template <typename T, typename F>
-    static void DrawComponent(const std::string& name, Entity entity, F uiFunction) {
+    static bool DrawComponent(const std::string& name, Entity entity, F uiFunction) {
         bool useUIFunction = false;
+        bool changed = false;
 
         ImGui::PushID(name.c_str());
 
@@ -37,11 +40,17 @@ namespace BlackberryEditor {
             }
 
             if (useUIFunction) {
-                uiFunction(component);
+                if constexpr (std::is_same_v<std::invoke_result_t<F, T&>, bool>) {
+                    changed = uiFunction(component);
+                } else {
+                    uiFunction(component);
+                }
             }
         }
 
         ImGui::PopID();
+
+        return changed;
     }
     
     template <typename T>
@@ -120,7 +129,7 @@ namespace BlackberryEditor {
     
         ImGui::SameLine();
         ImGui::PushItemWidth(sliderSize);
-        used = (used || ImGui::DragFloat("##DragX", &vec->x, 1.0f, 0.0f, 0.0f, "%.2f")); ImGui::SameLine();
+        used |= ImGui::DragFloat("##DragX", &vec->x, 1.0f, 0.0f, 0.0f, "%.2f"); ImGui::SameLine();
         ImGui::PopItemWidth();
     
         // y axis control
@@ -134,7 +143,7 @@ namespace BlackberryEditor {
     
         ImGui::SameLine();
         ImGui::PushItemWidth(sliderSize);
-        used = (used || ImGui::DragFloat("##DragY", &vec->y, 1.0f, 0.0f, 0.0f, "%.2f")); ImGui::SameLine();
+        used |= ImGui::DragFloat("##DragY", &vec->y, 1.0f, 0.0f, 0.0f, "%.2f"); ImGui::SameLine();
         ImGui::PopItemWidth();
 
         // z axis control
@@ -148,7 +157,7 @@ namespace BlackberryEditor {
     
         ImGui::SameLine();
         ImGui::PushItemWidth(sliderSize);
-        used = (used || ImGui::DragFloat("##DragZ", &vec->z, 1.0f, 0.0f, 0.0f, "%.2f")); ImGui::SameLine();
+        used |= ImGui::DragFloat("##DragZ", &vec->z, 1.0f, 0.0f, 0.0f, "%.2f"); ImGui::SameLine();
         ImGui::PopItemWidth();
 
         ImGui::TableNextColumn();
@@ -233,7 +242,7 @@ namespace BlackberryEditor {
         quat->w = vec.w;
     }
 
-    static void DrawEulerFromQuatControl(const std::string& label, BlQuat* quat) {
+    static bool DrawEulerFromQuatControl(const std::string& label, BlQuat* quat) {
         BlVec3 euler = glm::degrees(glm::eulerAngles(*quat));
 
         bool used = DrawVec3Control(label, &euler);
@@ -246,9 +255,14 @@ namespace BlackberryEditor {
             quat->z = outQuat.z;
             quat->w = outQuat.w;
         }
+
+        return used;
     }
 
-    static void DrawAssetBox(const std::string& label, AssetType desiredType, u64* handle) {
+    // Returns true if the handle changed
+    static bool DrawAssetBox(const std::string& label, AssetType desiredType, u64* handle) {
+        u64 previous = *handle;
+
         ImGui::Text(label.c_str());
         ImGui::TableNextColumn();
 
@@ -289,6 +303,8 @@ namespace BlackberryEditor {
         }
 
         ImGui::TableNextColumn();
+
+        return *handle != previous;
     }
 
 #pragma endregion
@@ -437,22 +453,42 @@ namespace BlackberryEditor {
                     f32 u = pos.x / m_ViewportBounds.w;
                     f32 v = 1.0 - pos.y / m_ViewportBounds.h; // NOTE: The ImGui image is technically being rendered "upside down" so we need to flip the y axis
 
-                    u32 fbX = static_cast<u32>(u * 1920);
-                    u32 fbY = static_cast<u32>(v * 1080);
+                    // Unproject the mouse position onto the near and far planes and shoot a ray through the scene's spatial index first,
+                    // if it doesn't hit any bounds there is nothing under the mouse and we don't have to read back the GBuffer (which stalls the GPU)
+                    // NOTE: The bounds are only a broad phase (a light's box covers its whole radius, a ground plane's box covers everything on it),
+                    // the entity id in the GBuffer is what actually got drawn at that pixel
+                    BlMat4 inverse = glm::inverse(m_EditorCamera.GetCameraMatrix());
+                    BlVec4 start = inverse * BlVec4(u * 2.0f - 1.0f, v * 2.0f - 1.0f, -1.0f, 1.0f);
+                    BlVec4 end = inverse * BlVec4(u * 2.0f - 1.0f, v * 2.0f - 1.0f, 1.0f, 1.0f);
 
-                    f32* pixel = reinterpret_cast<f32*>(m_SavedGBuffer->ReadPixels(4, BlVec2(fbX, fbY), BlVec2(1, 1), sizeof(f32)));
-                    int id = static_cast<int>(*pixel);
-                    free(pixel);
-                    
-                    if (id != -1) {
-                        m_SelectedEntity = static_cast<EntityID>(id);
+                    Ray ray;
+                    ray.Origin = BlVec3(start) / start.w;
+                    ray.Direction = BlVec3(end) / end.w - ray.Origin;
+
+                    EntityID hit = entt::null;
+
+                    if (m_CurrentScene->Raycast(ray, 1.0f) != entt::null) { // the direction spans the whole frustum, so 1 is the far plane
+                        u32 fbX = static_cast<u32>(u * m_SavedGBuffer->Specification.Width);
+                        u32 fbY = static_cast<u32>(v * m_SavedGBuffer->Specification.Height);
+
+                        f32* pixel = reinterpret_cast<f32*>(m_SavedGBuffer->ReadPixels(4, BlVec2(fbX, fbY), BlVec2(1, 1), sizeof(f32)));
+                        int id = static_cast<int>(*pixel);
+                        free(pixel);
+
+                        if (id != -1) {
+                            hit = static_cast<EntityID>(id);
+                        }
+                    }
+
+                    if (hit != entt::null) {
+                        m_SelectedEntity = hit;
                         m_IsEntitySelected = true;
                     } else {
                         m_SelectedEntity = entt::null;
                         m_IsEntitySelected = false;
                     }
 
-                    BL_CORE_INFO("press, pos: {}, {}, id {}", fbX, fbY, id);
+                    BL_CORE_INFO("press, pos: {}, {}, id {}", u, v, static_cast<u32>(hit));
                 }
             }
         }
@@ -508,6 +544,7 @@ namespace BlackberryEditor {
                 ImGui::MenuItem("Material Editor", nullptr, &m_MaterialEditorPanelOpen);
                 ImGui::MenuItem("Scene Renderer", nullptr, &m_SceneRendererPanelOpen);
                 ImGui::MenuItem("Asset Manager", nullptr, &m_AssetManagerPanelOpen);
+                ImGui::MenuItem("ECS Stats", nullptr, &m_ECSStatsPanelOpen);
 
                 ImGui::EndMenu();
             }
@@ -537,6 +574,8 @@ namespace BlackberryEditor {
         m_SceneRendererPanel.SetContext(m_CurrentScene);
         m_SceneRendererPanel.OnUIRender(m_SceneRendererPanelOpen);
         m_AssetManagerPanel.OnUIRender(m_AssetManagerPanelOpen);
+        m_ECSStatsPanel.SetContext(m_CurrentScene);
+        m_ECSStatsPanel.OnUIRender(m_ECSStatsPanelOpen);
     
         if (m_ShowDemoWindow) {
             ImGui::ShowDemoWindow(&m_ShowDemoWindow);
@@ -918,6 +957,7 @@ namespace BlackberryEditor {
 
         u64 entityToDelete = 0;
         u64 entityToDuplicate = 0;
+        u64 entityToSaveAsPrefab = 0;
 
         if (ImGui::Begin("Explorer")) {
             ImGui::SeparatorText("Entities: ");
@@ -1053,9 +1093,8 @@ namespace BlackberryEditor {
                 ImGui::EndPopup();
             };
 
-            std::function<void(u64, u32)> traverse = [&](u64 entityUUID, u32 depth) {
-                Entity e(m_CurrentScene->GetEntityFromUUID(entityUUID), m_CurrentScene);
-                auto& rel = e.GetComponent<RelationshipComponent>();
+            auto drawEntity = [&](const SceneHierarchy::Node& node) {
+                Entity e(node.Entity, m_CurrentScene);
 
                 ImGui::PushID(static_cast<int>(e.ID));
 
@@ -1068,13 +1107,13 @@ namespace BlackberryEditor {
                 flags |= ImGuiTreeNodeFlags_OpenOnDoubleClick;
                 flags |= ImGuiTreeNodeFlags_SpanAvailWidth;
 
-                if (!rel.FirstChild) {
+                if (node.SubtreeSize == 1) {
                     flags |= ImGuiTreeNodeFlags_Leaf;
                 }
 
                 bool opened = false;
 
-                opened = ImGui::TreeNodeEx(e.GetComponent<TagComponent>().Name.c_str(), flags);
+                opened = ImGui::TreeNodeEx(e.GetComponent<const TagComponent>().Name.CStr(), flags);
 
                 if (ImGui::IsItemClicked(ImGuiMouseButton_Left)) {
                     m_SelectedEntity = e.ID;
@@ -1083,16 +1122,20 @@ namespace BlackberryEditor {
 
                 if (ImGui::BeginPopupContextItem()) {  
                     if (ImGui::MenuItem("Delete Entity")) {
-                        entityToDelete = e.GetComponent<TagComponent>().UUID;
+                        entityToDelete = node.UUID;
+                    }
+
+                    if (ImGui::MenuItem("Save As Prefab")) {
+                        entityToSaveAsPrefab = node.UUID;
                     }
 
                     ImGui::EndPopup();
                 }
 
                 if (ImGui::BeginDragDropSource()) {
-                    ImGui::SetDragDropPayload("EXPLORER_ENTITY_DRAG_DROP", &e.GetComponent<TagComponent>().UUID, sizeof(u64));
+                    ImGui::SetDragDropPayload("EXPLORER_ENTITY_DRAG_DROP", &node.UUID, sizeof(u64));
 
-                    ImGui::Text(e.GetComponent<TagComponent>().Name.c_str());
+                    ImGui::Text(e.GetComponent<const TagComponent>().Name.CStr());
                 
                     ImGui::EndDragDropSource();
                 }
@@ -1104,38 +1147,50 @@ namespace BlackberryEditor {
                         u64 childUUID = *reinterpret_cast<u64*>(payload->Data);
                 
                         entityToParent = childUUID;
-                        parentForEntityToParent = e.GetComponent<TagComponent>().UUID;
+                        parentForEntityToParent = node.UUID;
                     }
                 
                     ImGui::EndDragDropTarget();
                 }
 
-                if (opened) {
-                    u64 child = rel.FirstChild;
-                    while (child != 0) {
-                        Entity childEntity = Entity(m_CurrentScene->GetEntityFromUUID(child), m_CurrentScene);
-                        auto& childRel = childEntity.GetComponent<RelationshipComponent>();
-
-                        traverse(child, depth + 1);
-
-                        child = childRel.NextSibling;
-                    }
-
-                    ImGui::TreePop();
-                }
-
-                ImGui::PopID();
+                return opened;
             };
 
-            auto& rootEntities = m_CurrentScene->GetRootEntities();
+            const SceneHierarchy& hierarchy = m_CurrentScene->GetHierarchy();
 
             ImGui::PushStyleVarY(ImGuiStyleVar_ItemSpacing, 0.0f);
             ImGui::PushStyleColor(ImGuiCol_Header, ImVec4(0.9f, 0.5f, 0.3f, 1));
             ImGui::PushStyleColor(ImGuiCol_HeaderHovered, ImVec4(0.9f, 0.7f, 0.5f, 1.0f));
             ImGui::PushStyleColor(ImGuiCol_HeaderActive, ImVec4(0.9f, 0.8f, 0.6f, 1.0f));
 
-            for (u64 uuid : rootEntities) {
-                traverse(uuid, 0);
+            // The hierarchy is stored depth first, so the explorer is just a linear scan:
+            // closed tree nodes skip their whole subtree and opened ones get popped once we are past their subtree
+            std::vector<u32> openedSubtreeEnds;
+
+            u32 index = 0;
+            while (index < hierarchy.Size()) {
+                while (!openedSubtreeEnds.empty() && index >= openedSubtreeEnds.back()) {
+                    ImGui::TreePop();
+                    ImGui::PopID();
+                    openedSubtreeEnds.pop_back();
+                }
+
+                const SceneHierarchy::Node& node = hierarchy[index];
+                u32 subtreeSize = node.SubtreeSize;
+
+                if (drawEntity(node)) {
+                    openedSubtreeEnds.push_back(index + subtreeSize);
+                    index++;
+                } else {
+                    ImGui::PopID();
+                    index += subtreeSize;
+                }
+            }
+
+            while (!openedSubtreeEnds.empty()) {
+                ImGui::TreePop();
+                ImGui::PopID();
+                openedSubtreeEnds.pop_back();
             }
 
             ImGui::PopStyleColor(3);
@@ -1166,6 +1221,14 @@ namespace BlackberryEditor {
             }
         }
 
+        if (entityToSaveAsPrefab) {
+            Entity e(m_CurrentScene->GetEntityFromUUID(entityToSaveAsPrefab), m_CurrentScene);
+            FS::Path p = m_CurrentDirectory / (e.GetComponent<const TagComponent>().Name.String() + ".blprefab");
+
+            Prefab::Save(m_CurrentScene, entityToSaveAsPrefab, p);
+            Project::GetAssetManager().AddAsset({FS::Relative(p, m_BaseDirectory), AssetType::Prefab, Prefab::Create(p)});
+        }
+
         if (entityToDuplicate) {
             m_CurrentScene->DuplicateEntity(entityToDuplicate);
         }
@@ -1197,30 +1260,48 @@ namespace BlackberryEditor {
                     ImGui::EndPopup();
                 }
     
-                TagComponent& tag = entity.GetComponent<TagComponent>();
+                const TagComponent& tag = entity.GetComponent<const TagComponent>();
+
+                // NOTE: Renaming goes through the scene so the entity can still be found by its (new) name
+                std::string name = tag.Name.String();
 
                 ImGui::Text("Name: "); ImGui::SameLine();
-                ImGui::InputText("##EntityName", &tag.Name);
+                if (ImGui::InputText("##EntityName", &name)) {
+                    m_CurrentScene->SetEntityName(tag.UUID, name);
+                }
                 ImGui::TextDisabled("UUID: %llu", tag.UUID); ImGui::SameLine();
                 ImGui::TextDisabled("EntityID: %u", entity.ID);
 
                 ImGui::SeparatorText("Components: ");
 
-                DrawComponent<TransformComponent>("Transform", entity, [](TransformComponent& transform) {
+                // NOTE: The fields write to the components directly, so the change trackers and the spatial index only hear about
+                // an edit from us. Only the fields which change an entity's size matter to the spatial index (moving it already shows up
+                // through the world transform)
+                bool boundsChanged = false;
+
+                bool transformChanged = DrawComponent<TransformComponent>("Transform", entity, [](TransformComponent& transform) {
                     ImGui::BeginTable("##TheTable", 2, ImGuiTableFlags_Resizable);
                     ImGui::TableNextColumn();
 
-                    DrawVec3Control("Position: ", &transform.Position);
-                    DrawEulerFromQuatControl("Rotation: ", &transform.Rotation);
-                    DrawVec3Control("Scale: ", &transform.Scale);
+                    bool changed = false;
+                    changed |= DrawVec3Control("Position: ", &transform.Position);
+                    changed |= DrawEulerFromQuatControl("Rotation: ", &transform.Rotation);
+                    changed |= DrawVec3Control("Scale: ", &transform.Scale);
 
                     ImGui::EndTable();
+
+                    return changed;
                 });
-                DrawComponent<MeshComponent>("Mesh", entity, [this](MeshComponent& mesh) {
+                bool meshChanged = DrawComponent<MeshComponent>("Mesh", entity, [this, &boundsChanged](MeshComponent& mesh) {
                     ImGui::BeginTable("##TheTable", 2, ImGuiTableFlags_Resizable);
                     ImGui::TableNextColumn();
 
-                    DrawAssetBox("Mesh: ", AssetType::Model, &mesh.MeshHandle);
+                    bool changed = false;
+
+                    if (DrawAssetBox("Mesh: ", AssetType::Model, &mesh.MeshHandle)) {
+                        changed = true;
+                        boundsChanged = true;
+                    }
 
                     ImGui::EndTable();
 
@@ -1237,7 +1318,16 @@ namespace BlackberryEditor {
                         for (u32 i = 0; i < model.Materials.size(); i++) {
                             ImGui::PushID(i);
                     
-                            DrawAssetBox(fmt::format("Material [{}]: ", i), AssetType::Material, &mesh.MaterialHandles[i]);
+                            u64 handle = mesh.MaterialHandles.Get(i);
+                            DrawAssetBox(fmt::format("Material [{}]: ", i), AssetType::Material, &handle);
+
+                            if (handle != mesh.MaterialHandles.Get(i)) {
+                                if (mesh.MaterialHandles.Set(i, handle)) {
+                                    changed = true;
+                                } else {
+                                    BL_WARN("A mesh can only override {} materials!", MaterialOverrides::s_Capacity);
+                                }
+                            }
 
                             ImGui::PopID();
                         }
@@ -1246,6 +1336,8 @@ namespace BlackberryEditor {
                     ImGui::Unindent();
 
                     ImGui::EndTable();
+
+                    return changed;
                 });
                 DrawComponent<TextComponent>("Text", entity, [this](TextComponent& text) {
                     ImGui::Text("Contents: ");
@@ -1340,8 +1432,8 @@ namespace BlackberryEditor {
                     ImGui::Text("Module Path: "); ImGui::SameLine();
                     ImGui::InputText("##ModulePath", &stringPath);
 
-                    if (!stringPath.empty()) {
-                        script.ModulePath = stringPath;
+                    if (!stringPath.empty() && stringPath != script.ModulePath.String()) {
+                        script.ModulePath = FS::Path(stringPath).String();
                     }
                 });
                 DrawComponent<RigidBodyComponent>("Rigid Body", entity, [](RigidBodyComponent& rigidBody) {
@@ -1381,15 +1473,17 @@ namespace BlackberryEditor {
 
                     ImGui::EndTable();
                 });
-                DrawComponent<BoxColliderComponent>("Box Collider", entity, [](BoxColliderComponent& collider) {
+                boundsChanged |= DrawComponent<BoxColliderComponent>("Box Collider", entity, [](BoxColliderComponent& collider) {
                     ImGui::BeginTable("##TheTable", 2, ImGuiTableFlags_Resizable);
                     ImGui::TableNextColumn();
 
-                    DrawVec3Control("Scale: ", &collider.Scale);
+                    bool changed = DrawVec3Control("Scale: ", &collider.Scale);
 
                     ImGui::EndTable();
+
+                    return changed;
                 });
-                DrawComponent<SphereColliderComponent>("Sphere Collider", entity, [](SphereColliderComponent& collider) {
+                boundsChanged |= DrawComponent<SphereColliderComponent>("Sphere Collider", entity, [](SphereColliderComponent& collider) {
                     ImGui::BeginTable("##TheTable", 2, ImGuiTableFlags_Resizable);
                     ImGui::TableNextColumn();
 
@@ -1397,12 +1491,14 @@ namespace BlackberryEditor {
                     ImGui::TableNextColumn();
 
                     ImGui::PushItemWidth(ImGui::GetContentRegionAvail().x);
-                    ImGui::DragFloat("##Radius", &collider.Radius, 0.05f);
+                    bool changed = ImGui::DragFloat("##Radius", &collider.Radius, 0.05f);
                     ImGui::PopItemWidth();
 
                     ImGui::EndTable();
+
+                    return changed;
                 });
-                DrawComponent<DirectionalLightComponent>("Directional Light", entity, [](DirectionalLightComponent& light) {
+                bool directionalLightChanged = DrawComponent<DirectionalLightComponent>("Directional Light", entity, [](DirectionalLightComponent& light) {
                     ImGui::BeginTable("##TheTable", 2, ImGuiTableFlags_Resizable);
                     ImGui::TableNextColumn();
 
@@ -1411,8 +1507,10 @@ namespace BlackberryEditor {
 
                     f32 size = ImGui::GetContentRegionAvail().x;
 
+                    bool changed = false;
+
                     ImGui::PushItemWidth(size);
-                    ImGui::ColorEdit3("##Color", &light.Color.x);
+                    changed |= ImGui::ColorEdit3("##Color", &light.Color.x);
                     ImGui::TableNextColumn();
                     ImGui::PopItemWidth();
 
@@ -1420,13 +1518,15 @@ namespace BlackberryEditor {
                     ImGui::TableNextColumn();
 
                     ImGui::PushItemWidth(size);
-                    ImGui::DragFloat("##Intensity", &light.Intensity, 0.5f, 0.0f, 500.0f);
+                    changed |= ImGui::DragFloat("##Intensity", &light.Intensity, 0.5f, 0.0f, 500.0f);
                     ImGui::TableNextColumn();
                     ImGui::PopItemWidth();
 
                     ImGui::EndTable();
+
+                    return changed;
                 });
-                DrawComponent<PointLightComponent>("Point Light", entity, [](PointLightComponent& light) {
+                bool pointLightChanged = DrawComponent<PointLightComponent>("Point Light", entity, [&boundsChanged](PointLightComponent& light) {
                     ImGui::BeginTable("##TheTable", 2, ImGuiTableFlags_Resizable);
                     ImGui::TableNextColumn();
 
@@ -1435,8 +1535,10 @@ namespace BlackberryEditor {
 
                     f32 size = ImGui::GetContentRegionAvail().x;
 
+                    bool changed = false;
+
                     ImGui::PushItemWidth(size);
-                    ImGui::ColorEdit3("##Color", &light.Color.x);
+                    changed |= ImGui::ColorEdit3("##Color", &light.Color.x);
                     ImGui::TableNextColumn();
                     ImGui::PopItemWidth();
 
@@ -1444,7 +1546,10 @@ namespace BlackberryEditor {
                     ImGui::TableNextColumn();
 
                     ImGui::PushItemWidth(size);
-                    ImGui::DragFloat("##Radius", &light.Radius, 0.5f, 0.0f, 500.0f);
+                    if (ImGui::DragFloat("##Radius", &light.Radius, 0.5f, 0.0f, 500.0f)) {
+                        changed = true;
+                        boundsChanged = true;
+                    }
                     ImGui::TableNextColumn();
                     ImGui::PopItemWidth();
 
@@ -1452,17 +1557,22 @@ namespace BlackberryEditor {
                     ImGui::TableNextColumn();
 
                     ImGui::PushItemWidth(size);
-                    ImGui::DragFloat("##Intensity", &light.Intensity, 0.5f, 0.0f, 500.0f);
+                    changed |= ImGui::DragFloat("##Intensity", &light.Intensity, 0.5f, 0.0f, 500.0f);
                     ImGui::TableNextColumn();
                     ImGui::PopItemWidth();
 
                     ImGui::EndTable();
+
+                    return changed;
                 });
-                DrawComponent<SpotLightComponent>("Point Light", entity, [](SpotLightComponent& light) {
-                    ImGui::ColorEdit3("Color", &light.Color.x);
+                bool spotLightChanged = DrawComponent<SpotLightComponent>("Point Light", entity, [](SpotLightComponent& light) {
+                    bool changed = false;
+                    changed |= ImGui::ColorEdit3("Color", &light.Color.x);
 
-                    ImGui::DragFloat("Cutoff", &light.Cutoff, 0.1f);
-                    ImGui::DragFloat("Intensity", &light.Intensity, 0.5f);
+                    changed |= ImGui::DragFloat("Cutoff", &light.Cutoff, 0.1f);
+                    changed |= ImGui::DragFloat("Intensity", &light.Intensity, 0.5f);
+
+                    return changed;
                 });
                 DrawComponent<EnvironmentComponent>("Environment", entity, [](EnvironmentComponent& env) {
                     ImGui::BeginTable("##TheTable", 2, ImGuiTableFlags_Resizable);
@@ -1496,6 +1606,18 @@ namespace BlackberryEditor {
 
                     ImGui::EndTable();
                 });
+
+                ECS* ecs = m_CurrentScene->GetECS();
+
+                if (transformChanged) ecs->MarkChanged<TransformComponent>(m_SelectedEntity);
+                if (meshChanged) ecs->MarkChanged<MeshComponent>(m_SelectedEntity);
+                if (directionalLightChanged) ecs->MarkChanged<DirectionalLightComponent>(m_SelectedEntity);
+                if (pointLightChanged) ecs->MarkChanged<PointLightComponent>(m_SelectedEntity);
+                if (spotLightChanged) ecs->MarkChanged<SpotLightComponent>(m_SelectedEntity);
+
+                if (boundsChanged) {
+                    m_CurrentScene->MarkBoundsDirty(m_SelectedEntity);
+                }
             }
         }
         ImGui::End();
@@ -1618,9 +1740,7 @@ namespace BlackberryEditor {
                         transform.Scale    = BlVec3(scale[0], scale[1], scale[2]);
 
                         // We still want to keep the transform local (but we need to draw it correctly)
-                        transform.Position -= m_CurrentScene->GetEntityParentTransform(m_SelectedEntity).Position;
-
-                        e.GetComponent<TransformComponent>() = transform;
+                        m_CurrentScene->SetEntityWorldTransform(m_SelectedEntity, transform);
                     }
                 }
             }
@@ -1750,6 +1870,11 @@ namespace BlackberryEditor {
         BL_INFO("Reverted to editing scene.");
         m_EditorState = EditorState::Edit;
         m_CurrentScene = m_EditingScene;
+
+        // NOTE: The runtime scene shares its component pools with the editing scene (copy-on-write),
+        // so it has to go away, otherwise every edit would still clone pools into it
+        m_RuntimeScene->Delete();
+        m_RuntimeScene = nullptr;
     }
 
     void EditorLayer::OnScenePause() {
@@ -3,6 +3,7 @@
 #include "panels/material_editor_panel.hpp"
 #include "panels/scene_renderer_panel.hpp"
 #include "panels/asset_manager_panel.hpp"
+#include "panels/ecs_stats_panel.hpp"
 
 #include "blackberry.hpp"
 
@@ -67,6 +68,9 @@ namespace BlackberryEditor {
         AssetManagerPanel m_AssetManagerPanel;
         bool m_AssetManagerPanelOpen = false;
 
+        ECSStatsPanel m_ECSStatsPanel;
+        bool m_ECSStatsPanelOpen = false;
+
         bool m_ShowNewProjectWindow = false;
         bool m_ShowNewSceneWindow = false;
     
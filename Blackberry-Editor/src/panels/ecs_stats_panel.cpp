@@ -0,0 +1,103 @@
+#include "ecs_stats_panel.hpp"
+
+#include "blackberry.hpp"
+
+using namespace Blackberry;
+
+namespace BlackberryEditor {
+
+    static std::string FormatBytes(u64 bytes) {
+        char buffer[32];
+
+        if (bytes >= 1024 * 1024) {
+            snprintf(buffer, sizeof(buffer), "%.2f MB", bytes / (1024.0 * 1024.0));
+        } else if (bytes >= 1024) {
+            snprintf(buffer, sizeof(buffer), "%.2f KB", bytes / 1024.0);
+        } else {
+            snprintf(buffer, sizeof(buffer), "%llu B", static_cast<unsigned long long>(bytes));
+        }
+
+        return buffer;
+    }
+
+    void ECSStatsPanel::OnUIRender(bool& open) {
+        if (!open) return;
+
+        if (ImGui::Begin("ECS Stats", &open)) {
+            // NOTE: Gathering walks every component which owns heap memory, so it only happens on request unless auto refresh is on
+            bool refresh = ImGui::Button("Refresh") || m_AutoRefresh || m_Stats.Pools.empty();
+            ImGui::SameLine();
+            ImGui::Checkbox("Auto Refresh", &m_AutoRefresh);
+            ImGui::SameLine();
+            ImGui::Checkbox("Hide Empty Pools", &m_HideEmptyPools);
+            ImGui::SameLine();
+
+            if (ImGui::Button("Dump JSON")) {
+                m_Stats.WriteJson("ecs_stats.json");
+                BL_CORE_INFO("Wrote ECS stats to ecs_stats.json");
+            }
+
+            if (refresh && m_Context) {
+                m_Stats = m_Context->GetECS()->GetStats();
+            }
+
+            ImGui::Separator();
+
+            ImGui::Text("Entities: %u alive, %u slots", m_Stats.AliveEntities, m_Stats.EntitySlots);
+            ImGui::Text("Entity storage: %s", FormatBytes(m_Stats.EntityBytes).c_str());
+            ImGui::Text("Change trackers: %s", FormatBytes(m_Stats.ChangeTrackerBytes).c_str());
+            ImGui::Text("Total: %s", FormatBytes(m_Stats.GetTotalBytes()).c_str());
+            ImGui::TextDisabled("Interned strings (shared by every scene): %u, %s", m_Stats.InternedStrings, FormatBytes(m_Stats.InternedStringBytes).c_str());
+
+            ImGui::Separator();
+
+            ImGuiTableFlags flags = ImGuiTableFlags_Resizable | ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_ScrollX;
+            if (ImGui::BeginTable("##ECSStatsTable", 9, flags)) {
+                ImGui::TableSetupColumn("Component");
+                ImGui::TableSetupColumn("Count");
+                ImGui::TableSetupColumn("Capacity");
+                ImGui::TableSetupColumn("Dense");
+                ImGui::TableSetupColumn("Sparse");
+                ImGui::TableSetupColumn("Heap");
+                ImGui::TableSetupColumn("Total");
+                ImGui::TableSetupColumn("Dense Use");
+                ImGui::TableSetupColumn("Sparse Use");
+                ImGui::TableHeadersRow();
+
+                for (const ComponentPoolStats& pool : m_Stats.Pools) {
+                    if (m_HideEmptyPools && pool.Capacity == 0) continue;
+
+                    ImGui::TableNextRow();
+
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%s%s", pool.Name, pool.Shared ? " (shared)" : "");
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%u", pool.Count);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%u", pool.Capacity);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%s", FormatBytes(pool.DenseBytes).c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%s", FormatBytes(pool.SparseBytes).c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%s", FormatBytes(pool.HeapBytes).c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%s", FormatBytes(pool.GetTotalBytes()).c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.1f%%", pool.DenseOccupancy * 100.0f);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.1f%%", pool.SparseOccupancy * 100.0f);
+                }
+
+                ImGui::EndTable();
+            }
+        }
+
+        ImGui::End();
+    }
+
+    void ECSStatsPanel::SetContext(Ref<Scene> scene) {
+        m_Context = scene;
+    }
+
+} // namespace BlackberryEditor
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "blackberry.hpp"
+
+namespace BlackberryEditor {
+
+    // Memory usage and occupancy of the current scene's component pools (see ECS::GetStats)
+    class ECSStatsPanel {
+    public:
+        void OnUIRender(bool& open);
+
+        void SetContext(Blackberry::Ref<Blackberry::Scene> scene);
+
+    private:
+        Blackberry::Ref<Blackberry::Scene> m_Context;
+        Blackberry::ECSStats m_Stats;
+
+        bool m_AutoRefresh = false;
+        bool m_HideEmptyPools = true;
+    };
+
+} // namespace BlackberryEditor
@@ -43,8 +43,9 @@ namespace BlackberryEditor {
 
             if (Project::GetAssetManager().ContainsAsset(m_Context)) {
                 Material& mat = std::get<Material>(Project::GetAssetManager().GetAsset(m_Context).Data);
+                bool changed = false;
 
-                ImGui::Checkbox("Use Albedo Texture", &mat.UseAlbedoTexture);
+                changed |= ImGui::Checkbox("Use Albedo Texture", &mat.UseAlbedoTexture);
 
                 if (mat.UseAlbedoTexture) {
                     ImGui::ImageButton("##AlbedoTexture", mat.AlbedoTexture->ID, ImVec2(128.0f, 128.0f)); ImGui::SameLine();
@@ -57,16 +58,17 @@ namespace BlackberryEditor {
 
                             mat.AlbedoTexturePath = FS::Relative(path, Project::GetAssetDirecory());
                             mat.AlbedoTexture = Texture2D::Create(path);
+                            changed = true;
                         } 
                     }
 
                     ImGui::Text("Albedo");
                 } else {
-                    ImGui::ColorEdit4("##AlbedoColor", &mat.AlbedoColor.x); ImGui::SameLine();
+                    changed |= ImGui::ColorEdit4("##AlbedoColor", &mat.AlbedoColor.x); ImGui::SameLine();
                     ImGui::Text("Albedo");
                 }
 
-                ImGui::Checkbox("Use Metallic Texture", &mat.UseMetallicTexture);
+                changed |= ImGui::Checkbox("Use Metallic Texture", &mat.UseMetallicTexture);
 
                 if (mat.UseMetallicTexture) {
                     ImGui::ImageButton("##MetallicTexture", mat.MetallicTexture->ID, ImVec2(128.0f, 128.0f)); ImGui::SameLine();
@@ -79,16 +81,17 @@ namespace BlackberryEditor {
 
                             mat.MetallicTexturePath = FS::Relative(path, Project::GetAssetDirecory());
                             mat.MetallicTexture = Texture2D::Create(path);
+                            changed = true;
                         } 
                     }
 
                     ImGui::Text("Metallic");
                 } else {
-                    ImGui::SliderFloat("##MetallicFactor", &mat.MetallicFactor, 0.0f, 1.0f); ImGui::SameLine();
+                    changed |= ImGui::SliderFloat("##MetallicFactor", &mat.MetallicFactor, 0.0f, 1.0f); ImGui::SameLine();
                     ImGui::Text("Metallic");
                 }
 
-                ImGui::Checkbox("Use Roughness Texture", &mat.UseRoughnessTexture);
+                changed |= ImGui::Checkbox("Use Roughness Texture", &mat.UseRoughnessTexture);
 
                 if (mat.UseRoughnessTexture) {
                     ImGui::ImageButton("##RoughnessTexture", mat.RoughnessTexture->ID, ImVec2(128.0f, 128.0f)); ImGui::SameLine();
@@ -101,28 +104,34 @@ namespace BlackberryEditor {
 
                             mat.RoughnessTexturePath = FS::Relative(path, Project::GetAssetDirecory());
                             mat.RoughnessTexture = Texture2D::Create(path);
+                            changed = true;
                         } 
                     }
 
                     ImGui::Text("Roughness");
                 } else {
-                    ImGui::SliderFloat("##RoughnessFactor", &mat.RoughnessFactor, 0.0f, 1.0f); ImGui::SameLine();
+                    changed |= ImGui::SliderFloat("##RoughnessFactor", &mat.RoughnessFactor, 0.0f, 1.0f); ImGui::SameLine();
                     ImGui::Text("Roughness");
                 }
 
-                ImGui::Checkbox("Use AO Texture", &mat.UseAOTexture);
+                changed |= ImGui::Checkbox("Use AO Texture", &mat.UseAOTexture);
 
                 if (mat.UseAOTexture) {
                     ImGui::Image(mat.AOTexture->ID, ImVec2(128.0f, 128.0f)); ImGui::SameLine();
                     ImGui::Text("AO");
                 } else {
-                    ImGui::SliderFloat("##AOFactor", &mat.AOFactor, 0.0f, 1.0f); ImGui::SameLine();
+                    changed |= ImGui::SliderFloat("##AOFactor", &mat.AOFactor, 0.0f, 1.0f); ImGui::SameLine();
                     ImGui::Text("AO");
                 }
 
-                ImGui::SliderFloat("##Emission", &mat.Emission, 0.0f, 1.0f); ImGui::SameLine();
+                changed |= ImGui::SliderFloat("##Emission", &mat.Emission, 0.0f, 1.0f); ImGui::SameLine();
                 ImGui::Text("Emission");
 
+                // NOTE: The renderer only uploads the material again once its version changes
+                if (changed) {
+                    mat.MarkChanged();
+                }
+
                 if (ImGui::Button("Save")) {
                     auto path = Project::GetAssetPath(Project::GetAssetManager().GetAsset(m_Context).FilePath);
 
@@ -27,6 +27,12 @@ namespace BlackberryEditor {
             auto* renderer = m_Context->GetSceneRenderer();
             auto& state = renderer->GetState();
 
+            ImGui::Text("Mesh draw calls: %u", state.MeshDrawCalls);
+            ImGui::Checkbox("Cull meshes", &state.MeshCullingEnabled);
+            ImGui::Text("SceneRenderer::CullMeshInstances %fms", Instrumentor::GetTimePoint("SceneRenderer::CullMeshInstances").Milliseconds());
+            ImGui::Text("Visible mesh instances: %llu", static_cast<unsigned long long>(Instrumentor::GetCount("SceneRenderer::VisibleMeshInstances")));
+            ImGui::Text("Culled mesh instances: %llu", static_cast<unsigned long long>(Instrumentor::GetCount("SceneRenderer::CulledMeshInstances")));
+
             f32 sizeX = ImGui::GetContentRegionAvail().x;
             f32 sizeY = sizeX / 1.7778f;
             
@@ -7,23 +7,18 @@ layout (location = 2) in vec3 a_FragPos;
 layout (location = 3) in flat int a_MaterialIndex;
 layout (location = 4) in flat int a_EntityID;
 
+// NOTE: Has to match GPUMaterial (scene_renderer.hpp), a texture handle of 0 means the texture isn't used
 struct Material {
-    int UseAlbedoTexture;
     uvec2 AlbedoTexture;
+    uvec2 MetallicTexture;
+    uvec2 RoughnessTexture;
+    uvec2 AOTexture;
+
     vec4 AlbedoColor;
 
-    int UseMetallicTexture;
-    uvec2 MetallicTexture;
     float MetallicFactor;
-
-    int UseRoughnessTexture;
-    uvec2 RoughnessTexture;
     float RoughnessFactor;
-
-    int UseAOTexture;
-    uvec2 AOTexture;
     float AOFactor;
-
     float Emission;
 };
 
@@ -43,25 +38,25 @@ void main() {
     // Store the normal in the second buffer
     o_GNormal.rgb = normalize(a_Normal);
     // Store the albedo color in the third buffer
-    if (Materials[a_MaterialIndex].UseAlbedoTexture == 1 && Materials[a_MaterialIndex].AlbedoTexture != uvec2(0.0)) {
+    if (Materials[a_MaterialIndex].AlbedoTexture != uvec2(0)) {
         o_GAlbedo.rgb = texture(sampler2D(Materials[a_MaterialIndex].AlbedoTexture), a_TexCoord).rgb;
     } else {
         o_GAlbedo.rgb = Materials[a_MaterialIndex].AlbedoColor.rgb;
     }
     // Store material information in the fourth buffer
-    if (Materials[a_MaterialIndex].UseMetallicTexture == 1 && Materials[a_MaterialIndex].MetallicTexture != uvec2(0.0)) {
+    if (Materials[a_MaterialIndex].MetallicTexture != uvec2(0)) {
         o_GMat.r = texture(sampler2D(Materials[a_MaterialIndex].MetallicTexture), a_TexCoord).r;
     } else {
         o_GMat.r = Materials[a_MaterialIndex].MetallicFactor;
     }
     
-    if (Materials[a_MaterialIndex].UseRoughnessTexture == 1 && Materials[a_MaterialIndex].RoughnessTexture != uvec2(0.0)) {
+    if (Materials[a_MaterialIndex].RoughnessTexture != uvec2(0)) {
         o_GMat.g = texture(sampler2D(Materials[a_MaterialIndex].RoughnessTexture), a_TexCoord).r;
     } else {
         o_GMat.g = Materials[a_MaterialIndex].RoughnessFactor;
     }
     
-    if (Materials[a_MaterialIndex].UseAOTexture == 1 && Materials[a_MaterialIndex].AOTexture != uvec2(0.0)) {
+    if (Materials[a_MaterialIndex].AOTexture != uvec2(0)) {
         o_GMat.b = texture(sampler2D(Materials[a_MaterialIndex].AOTexture), a_TexCoord).r;
     } else {
         o_GMat.b = Materials[a_MaterialIndex].AOFactor;
@@ -24,15 +24,18 @@ layout (location = 3) out flat int o_MaterialIndex;
 layout (location = 4) out flat int o_EntityID;
 
 void main() {
-    vec4 worldPos = Instances[gl_InstanceID].Transform * vec4(a_Pos, 1.0);
+    // NOTE: Every draw's instances start at gl_BaseInstance in the buffer (see SceneRenderer::GeometryPass)
+    InstanceData instance = Instances[gl_BaseInstance + gl_InstanceID];
+
+    vec4 worldPos = instance.Transform * vec4(a_Pos, 1.0);
 
     gl_Position = u_ViewProjection * worldPos;
 
-    mat3 normalMatrix = transpose(inverse(mat3(Instances[gl_InstanceID].Transform)));
+    mat3 normalMatrix = transpose(inverse(mat3(instance.Transform)));
     o_Normal = normalMatrix * a_Normal;
 
     o_TexCoord = a_TexCoord;
     o_FragPos = worldPos.xyz;
-    o_MaterialIndex = Instances[gl_InstanceID].MaterialIndex;
-    o_EntityID = Instances[gl_InstanceID].EntityID;
+    o_MaterialIndex = instance.MaterialIndex;
+    o_EntityID = instance.EntityID;
 }
\ No newline at end of file
@@ -10,6 +10,14 @@ namespace BlackberryRuntime {
         virtual void OnAttach() override {
             auto commandLineArgs = BL_APP.GetSpecification().CommandLineArgs;
             const char* path = commandLineArgs.Args[1];
+
+            // --ecs-stats <file>: writes the ECS memory stats (see ECS::GetStats) on exit, e.g. to compare builds
+            for (u32 i = 2; i + 1 < commandLineArgs.Count; i++) {
+                if (std::string(commandLineArgs.Args[i]) == "--ecs-stats") {
+                    m_ECSStatsPath = commandLineArgs.Args[i + 1];
+                }
+            }
+
             Project::Load(path);
             m_CurrentScene = Project::GetStartScene();
 
@@ -28,6 +36,10 @@ namespace BlackberryRuntime {
         }
 
         virtual void OnDetach() override {
+            if (!m_ECSStatsPath.empty()) {
+                m_CurrentScene->GetECS()->GetStats().WriteJson(m_ECSStatsPath);
+            }
+
             m_CurrentScene->OnRuntimeStop();
         }
 
@@ -50,6 +62,7 @@ namespace BlackberryRuntime {
     private:
         Ref<Scene> m_CurrentScene;
         Ref<Framebuffer> m_RenderTarget;
+        std::string m_ECSStatsPath;
     };
     
 } // namespace BlackberryRuntime
@@ -36,9 +36,11 @@
 #include "blackberry/core/memory.hpp"
 #include "blackberry/core/path.hpp"
 #include "blackberry/core/timer.hpp"
+#include "blackberry/core/thread_pool.hpp"
 
 // rendering abstractions
 #include "blackberry/renderer/debug_renderer.hpp"
+#include "blackberry/renderer/mesh_arena.hpp"
 #include "blackberry/renderer/texture.hpp"
 #include "blackberry/renderer/shader.hpp"
 
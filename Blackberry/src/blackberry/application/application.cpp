@@ -11,6 +11,7 @@
 #include "blackberry/lua/lua.hpp"
 #include "blackberry/core/timer.hpp"
 #include "blackberry/renderer/debug_renderer.hpp"
+#include "blackberry/renderer/mesh_arena.hpp"
 
 #define IMGUI_DEFINE_MATH_OPERATORS
 #include "imgui.h"
@@ -40,6 +41,7 @@ namespace Blackberry {
         m_RendererAPI->SetViewportSize(viewport);
 
         DebugRenderer::Initialize();
+        MeshArena::Initialize();
 
         m_TargetFPS = spec.FPS;
         m_LastTime = m_Window->GetTime();
@@ -57,8 +59,10 @@ namespace Blackberry {
     Application::~Application() {
         delete m_LayerStack; // we want on detach to be called right here
 
+        MeshArena::Shutdown(); // needs the GL context, so before the window goes
+
+        delete m_RendererAPI; // frees GL objects, so before the window (and its context) goes
         delete m_Window;
-        delete m_RendererAPI;
     }
 
     void Application::Run() {
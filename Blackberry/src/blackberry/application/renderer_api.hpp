@@ -5,6 +5,8 @@
 #include "blackberry/renderer/shader.hpp"
 #include "blackberry/renderer/vertex_buffer.hpp"
 
+#include <vector>
+
 namespace Blackberry {
 
     enum class RendererCapability {
@@ -48,8 +50,19 @@ namespace Blackberry {
         Always
     };
 
+    // One draw of an indirect draw (laid out the way the GPU reads them)
+    struct DrawIndexedIndirectCommand {
+        u32 IndexCount = 0;
+        u32 InstanceCount = 0;
+        u32 FirstIndex = 0;
+        i32 BaseVertex = 0;
+        u32 BaseInstance = 0; // shaders see it as gl_BaseInstance, gl_InstanceID still starts at 0
+    };
+
     class RendererAPI {
     public:
+        virtual ~RendererAPI() = default;
+
         virtual void SetViewportSize(BlVec2 size) const = 0;
         virtual void ClearFramebuffer(const BlVec4& color = BlVec4(0.0f)) const = 0;
 
@@ -64,6 +77,10 @@ namespace Blackberry {
         
         virtual void DrawVertexArray(const Ref<VertexArray>& vertexArray) const = 0;
         virtual void DrawVertexArrayInstanced(const Ref<VertexArray>& vertexArray, u32 count) const = 0;
+        // Draws indexCount indices starting at firstIndex of vertexArray's index buffer (every index gets baseVertex added)
+        virtual void DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, u32 indexCount, u32 firstIndex, u32 baseVertex, u32 count, u32 baseInstance) const = 0;
+        // Submits every command with a single call
+        virtual void DrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const std::vector<DrawIndexedIndirectCommand>& commands) const = 0;
 
         virtual void BindShader(const Ref<Shader>& shader) const = 0;
 
@@ -1,6 +1,8 @@
 #include "blackberry/assets/asset_manager.hpp"
 #include "blackberry/renderer/texture.hpp"
+#include "blackberry/renderer/mesh_arena.hpp"
 #include "blackberry/project/project.hpp"
+#include "blackberry/core/timer.hpp"
 
 namespace Blackberry {
 
@@ -11,6 +13,8 @@ namespace Blackberry {
             newAssetManager->AddAssetWithHandle(handle, asset);
         }
 
+        newAssetManager->m_UnloadedAssets = current->m_UnloadedAssets;
+
         return newAssetManager;
     }
 
@@ -59,6 +63,54 @@ namespace Blackberry {
         return m_AssetMap;
     }
 
+    void AssetManager::UnloadAsset(AssetHandle handle) {
+        auto it = m_AssetMap.find(handle);
+        if (it == m_AssetMap.end()) return;
+
+        Asset& asset = it->second;
+
+        // NOTE: The rest of the asset types free themselves, models also have their meshes in the mesh arena
+        if (asset.Type == AssetType::Model) {
+            for (const Mesh& mesh : std::get<Model>(asset.Data).Meshes) {
+                MeshArena::Free(mesh.Allocation);
+            }
+        }
+
+        m_UnloadedAssets[handle] = { asset.FilePath, asset.Type, {}, handle };
+
+        m_AssetHandleMap.erase(asset.FilePath);
+        m_AssetMap.erase(it);
+    }
+
+    void AssetManager::LoadAsset(AssetHandle handle) {
+        BL_PROFILE_SCOPE("AssetManager::LoadAsset");
+
+        auto it = m_UnloadedAssets.find(handle);
+        if (it == m_UnloadedAssets.end()) return;
+
+        Asset asset = it->second;
+        m_UnloadedAssets.erase(it);
+
+        // NOTE: Scenes keep their full path (see LoadSceneFromPath)
+        FS::Path full = asset.Type == AssetType::Scene ? asset.FilePath : Project::GetAssetPath(asset.FilePath);
+
+        switch (asset.Type) {
+            case AssetType::Texture: asset.Data = Texture2D::Create(full); break;
+            case AssetType::Font: asset.Data = Font::Create(full); break;
+            case AssetType::Model: asset.Data = Model::Create(full); break;
+            case AssetType::Material: asset.Data = Material::Create(full); break;
+            case AssetType::EnvironmentMap: asset.Data = EnvironmentMap::Create(full); break;
+            case AssetType::Scene: asset.Data = Scene::Create(full); break;
+            case AssetType::Prefab: asset.Data = Prefab::Create(full); break;
+        }
+
+        AddAssetWithHandle(handle, asset);
+    }
+
+    bool AssetManager::IsAssetUnloaded(AssetHandle handle) const {
+        return m_UnloadedAssets.contains(handle);
+    }
+
     void AssetManager::LoadTextureFromPath(const FS::Path& path) {
         FS::Path full = Project::GetAssetPath(path);
         Ref<Texture> tex = Texture2D::Create(full);
@@ -95,6 +147,12 @@ namespace Blackberry {
         AddAsset({full, AssetType::Scene, scene});
     }
 
+    void AssetManager::LoadPrefabFromPath(const FS::Path& path) {
+        FS::Path full = Project::GetAssetPath(path);
+        Ref<Prefab> prefab = Prefab::Create(full);
+        AddAsset({path, AssetType::Prefab, prefab});
+    }
+
     void AssetManager::LoadAssetFromPath(const FS::Path& path) {
         std::string ext = path.Extension();
         std::transform(ext.begin(), ext.end(), ext.begin(),
@@ -112,6 +170,8 @@ namespace Blackberry {
             LoadEnvironmentMapFromPath(path);
         } else if (ext == ".blscene") {
             LoadSceneFromPath(path);
+        } else if (ext == ".blprefab") {
+            LoadPrefabFromPath(path);
         }
     }
 
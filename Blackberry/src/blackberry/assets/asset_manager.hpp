@@ -9,6 +9,7 @@
 #include "blackberry/core/util.hpp"
 #include "blackberry/renderer/environment_map.hpp"
 #include "blackberry/scene/scene.hpp"
+#include "blackberry/scene/prefab.hpp"
 
 #include <unordered_map>
 #include <variant>
@@ -23,7 +24,8 @@ namespace Blackberry {
         Model = 2,
         Material = 3,
         EnvironmentMap = 4,
-        Scene = 5
+        Scene = 5,
+        Prefab = 6
     };
 
     inline const char* AssetTypeToString(AssetType type) {
@@ -34,6 +36,7 @@ namespace Blackberry {
             case AssetType::Material: return "Material"; break;
             case AssetType::EnvironmentMap: return "Environment Map"; break;
             case AssetType::Scene: return "Scene"; break;
+            case AssetType::Prefab: return "Prefab"; break;
         }
 
         BL_ASSERT(false, "Unknown asset type! (memory corruption potential)");
@@ -47,6 +50,7 @@ namespace Blackberry {
         if (type == "Material") return AssetType::Material;
         if (type == "Environment Map") return AssetType::EnvironmentMap;
         if (type == "Scene") return AssetType::Scene;
+        if (type == "Prefab") return AssetType::Prefab;
 
         BL_ASSERT(false, "Unknown asset type {}", type);
         return AssetType::Texture;
@@ -55,7 +59,7 @@ namespace Blackberry {
     struct Asset {
         FS::Path FilePath;
         AssetType Type;
-        std::variant<Ref<Texture>, Font, Model, Material, Ref<EnvironmentMap>, Ref<Scene>> Data;
+        std::variant<Ref<Texture>, Font, Model, Material, Ref<EnvironmentMap>, Ref<Scene>, Ref<Prefab>> Data;
         AssetHandle Handle = 0;
     };
 
@@ -80,6 +84,14 @@ namespace Blackberry {
 
         AssetHandle GetHandleFromPath(const FS::Path& path) const;
 
+        // Frees the asset's data but remembers where it came from, so LoadAsset can bring it back with the same handle
+        // (e.g. the models only unloaded world partition cells use), ContainsAsset is false until then
+        // NOTE: Must be called from the main thread (it frees GPU resources)
+        void UnloadAsset(AssetHandle handle);
+        // Loads an asset which got unloaded with UnloadAsset again (from its file)
+        void LoadAsset(AssetHandle handle);
+        bool IsAssetUnloaded(AssetHandle handle) const;
+
         const HandleMap& GetAllAssets() const;
 
         // helper functions (all you really need is AddAsset)
@@ -89,6 +101,7 @@ namespace Blackberry {
         void LoadMaterialFromPath(const FS::Path& path);
         void LoadEnvironmentMapFromPath(const FS::Path& path);
         void LoadSceneFromPath(const FS::Path& path);
+        void LoadPrefabFromPath(const FS::Path& path);
 
         void LoadAssetFromPath(const FS::Path& path);
 
@@ -98,6 +111,7 @@ namespace Blackberry {
     private:
         HandleMap m_AssetMap;
         std::unordered_map<FS::Path, AssetHandle> m_AssetHandleMap;
+        HandleMap m_UnloadedAssets; // without their data
     };
 
 } // namespace Blackberry
\ No newline at end of file
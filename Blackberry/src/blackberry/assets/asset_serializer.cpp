@@ -61,6 +61,9 @@ namespace Blackberry {
             } else if (asset.Type == AssetType::Scene) {
                 Ref<Scene> scene = Scene::Create(Project::GetAssetPath(assetPath));
                 asset.Data = scene;
+            } else if (asset.Type == AssetType::Prefab) {
+                Ref<Prefab> prefab = Prefab::Create(Project::GetAssetPath(assetPath));
+                asset.Data = prefab;
             }
 
             m_AssetManager->AddAssetWithHandle(jsonAsset.at("Handle"), asset);
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "blackberry/core/types.hpp"
+
+#include <string>
+#include <string_view>
+
+namespace Blackberry {
+
+    // A name reduced to its 64 bit FNV-1a hash, used as a cheap key for name lookups (see Scene::FindEntity)
+    //
+    // The hash gets computed at compile time for string literals ("Player"_hs always is, a plain "Player" is whenever
+    // the compiler can), so looking a name up never has to touch (or allocate) the string itself
+    //
+    // NOTE: Only the hash is kept, two different names with the same hash are treated as the same name
+    class HashedString {
+    public:
+        using HashType = u64;
+
+        constexpr HashedString() = default;
+
+        constexpr HashedString(const char* str)
+            : m_Hash(Hash(std::string_view(str))) {}
+
+        constexpr HashedString(std::string_view str)
+            : m_Hash(Hash(str)) {}
+
+        HashedString(const std::string& str)
+            : m_Hash(Hash(str)) {}
+
+        // For hashes which were computed somewhere else (e.g. by a script)
+        static constexpr HashedString FromHash(HashType hash) {
+            HashedString str;
+            str.m_Hash = hash;
+            return str;
+        }
+
+        static constexpr HashType Hash(std::string_view str) {
+            HashType hash = 0xcbf29ce484222325ull;
+
+            for (char c : str) {
+                hash ^= static_cast<u8>(c);
+                hash *= 0x100000001b3ull;
+            }
+
+            return hash;
+        }
+
+        constexpr HashType GetHash() const { return m_Hash; }
+        constexpr operator HashType() const { return m_Hash; }
+
+        constexpr bool operator==(const HashedString& other) const { return m_Hash == other.m_Hash; }
+
+    private:
+        HashType m_Hash = Hash("");
+    };
+
+    // "Name"_hs, always hashed at compile time
+    consteval HashedString operator""_hs(const char* str, std::size_t length) {
+        return HashedString(std::string_view(str, length));
+    }
+
+} // namespace Blackberry
@@ -0,0 +1,110 @@
+#include "blackberry/core/interned_string.hpp"
+#include "blackberry/core/util.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <unordered_map>
+
+namespace Blackberry {
+
+    struct PoolEntry {
+        std::string String;
+        HashedString Hash;
+    };
+
+    // NOTE: The entries live in fixed size chunks which never move, so readers can look strings up without the lock
+    // (only the chunk pointers are shared, and those only ever go from nullptr to a chunk)
+    struct StringPool {
+        static constexpr u32 s_ChunkSize = 4096;
+        static constexpr u32 s_MaxChunks = 4096;
+
+        std::mutex Mutex;
+        std::unordered_map<std::string_view, u32> Indices; // the views point into the entries
+        std::unique_ptr<std::atomic<PoolEntry*>[]> Chunks;
+        u32 Count = 0;
+        u64 MemorySize = 0;
+
+        StringPool()
+            : Chunks(new std::atomic<PoolEntry*>[s_MaxChunks]) {
+            for (u32 i = 0; i < s_MaxChunks; i++) {
+                Chunks[i].store(nullptr, std::memory_order_relaxed);
+            }
+
+            Intern(""); // index 0, what a default constructed InternedString points at
+        }
+
+        ~StringPool() {
+            for (u32 i = 0; i < s_MaxChunks; i++) {
+                delete[] Chunks[i].load(std::memory_order_relaxed);
+            }
+        }
+
+        u32 Intern(std::string_view str) {
+            std::lock_guard lock(Mutex);
+
+            if (auto it = Indices.find(str); it != Indices.end()) {
+                return it->second;
+            }
+
+            u32 index = Count;
+            u32 chunk = index / s_ChunkSize;
+            BL_ASSERT(chunk < s_MaxChunks, "String pool is full!");
+
+            PoolEntry* entries = Chunks[chunk].load(std::memory_order_relaxed);
+            if (!entries) {
+                entries = new PoolEntry[s_ChunkSize];
+                Chunks[chunk].store(entries, std::memory_order_release);
+
+                MemorySize += s_ChunkSize * sizeof(PoolEntry);
+            }
+
+            PoolEntry& entry = entries[index % s_ChunkSize];
+            entry.String = str;
+            entry.Hash = HashedString(str);
+
+            Indices.emplace(entry.String, index);
+            MemorySize += Util::GetHeapSize(entry.String);
+            Count++;
+
+            return index;
+        }
+
+        const PoolEntry& Get(u32 index) const {
+            return Chunks[index / s_ChunkSize].load(std::memory_order_acquire)[index % s_ChunkSize];
+        }
+    };
+
+    // NOTE: A function static so the pool exists before any (static) InternedString gets created
+    static StringPool& GetStringPool() {
+        static StringPool pool;
+        return pool;
+    }
+
+    InternedString::InternedString(std::string_view str)
+        : m_Index(str.empty() ? 0 : GetStringPool().Intern(str)) {}
+
+    const std::string& InternedString::String() const {
+        return GetStringPool().Get(m_Index).String;
+    }
+
+    HashedString InternedString::GetHash() const {
+        return GetStringPool().Get(m_Index).Hash;
+    }
+
+    u32 InternedString::GetPoolSize() {
+        StringPool& pool = GetStringPool();
+        std::lock_guard lock(pool.Mutex);
+
+        return pool.Count;
+    }
+
+    u64 InternedString::GetPoolMemorySize() {
+        StringPool& pool = GetStringPool();
+        std::lock_guard lock(pool.Mutex);
+
+        // NOTE: The lookup table's nodes are an estimate (the key, the index and the next pointer plus the cached hash)
+        return pool.MemorySize + pool.Indices.bucket_count() * sizeof(void*) + pool.Count * (sizeof(std::string_view) + 2 * sizeof(u64) + sizeof(void*));
+    }
+
+} // namespace Blackberry
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "blackberry/core/types.hpp"
+#include "blackberry/core/hashed_string.hpp"
+
+#include <string>
+#include <string_view>
+
+namespace Blackberry {
+
+    // A handle to a string in the global string pool, every distinct string is only stored once
+    //
+    // Used for the strings components hold (entity names, script paths...), so the components stay trivially copyable:
+    // copying a scene or duplicating an entity copies a 4 byte index instead of allocating a new string
+    //
+    // NOTE: Strings never get removed from the pool, so only intern strings which are likely to come up again (names, paths)
+    // and not ones which change all the time. Interning takes a lock, reading (String, GetHash) doesn't
+    class InternedString {
+    public:
+        InternedString() = default; // the empty string
+        InternedString(std::string_view str);
+        InternedString(const char* str)
+            : InternedString(std::string_view(str)) {}
+        InternedString(const std::string& str)
+            : InternedString(std::string_view(str)) {}
+
+        // NOTE: The reference stays valid forever
+        const std::string& String() const;
+        const char* CStr() const { return String().c_str(); }
+        // The hash is computed once when interning, so this doesn't touch the string
+        HashedString GetHash() const;
+
+        bool Empty() const { return m_Index == 0; }
+        u32 GetIndex() const { return m_Index; }
+
+        operator const std::string&() const { return String(); }
+
+        bool operator==(const InternedString& other) const { return m_Index == other.m_Index; }
+
+        // How many distinct strings the pool holds and how much memory they take up (see ECSStats)
+        static u32 GetPoolSize();
+        static u64 GetPoolMemorySize();
+
+    private:
+        u32 m_Index = 0;
+    };
+
+} // namespace Blackberry
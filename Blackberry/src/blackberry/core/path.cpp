@@ -1,6 +1,7 @@
 #include "blackberry/core/path.hpp"
 #include "blackberry/os/os.hpp"
 #include "blackberry/core/log.hpp"
+#include "blackberry/core/util.hpp"
 
 namespace Blackberry::FS {
 
@@ -144,6 +145,16 @@ namespace Blackberry::FS {
         // }
     }
 
+    u64 Path::GetHeapSize() const {
+        u64 size = m_Components.capacity() * sizeof(std::string);
+
+        for (const std::string& component : m_Components) {
+            size += Util::GetHeapSize(component);
+        }
+
+        return size;
+    }
+
     DirectoryIterator::DirectoryIterator(const Path& base) {
         m_Files = OS::RetrieveDirectoryFiles(base.String());
     }
@@ -40,6 +40,9 @@ namespace Blackberry::FS {
         // Validates a path and turns an invalid path into a valid one if needed
         void Validate();
 
+        // Bytes the path allocated on the heap (for memory stats)
+        u64 GetHeapSize() const;
+
     private:
         std::vector<std::string> m_Components;
     };
@@ -0,0 +1,140 @@
+#include "blackberry/core/thread_pool.hpp"
+
+#include <atomic>
+#include <memory>
+#include <algorithm>
+
+namespace Blackberry {
+
+    ThreadPool::ThreadPool(u32 threadCount) {
+        m_Workers.reserve(threadCount);
+
+        for (u32 i = 0; i < threadCount; i++) {
+            m_Workers.emplace_back([this]() { WorkerLoop(); });
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stopping = true;
+        }
+
+        m_JobAvailable.notify_all();
+
+        for (auto& worker : m_Workers) {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::Submit(const std::function<void()>& job) {
+        if (m_Workers.empty()) {
+            job();
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Jobs.push(job);
+            m_ActiveJobs++;
+        }
+
+        m_JobAvailable.notify_one();
+    }
+
+    void ThreadPool::Wait() {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_JobsFinished.wait(lock, [this]() { return m_ActiveJobs == 0; });
+    }
+
+    void ThreadPool::ParallelFor(u32 count, const std::function<void(u32 begin, u32 end)>& func) {
+        if (count == 0) return;
+
+        u32 threads = GetThreadCount() + 1; // the calling thread works as well
+        if (threads == 1 || count == 1) {
+            func(0, count);
+            return;
+        }
+
+        // Use more batches than threads so uneven batches (e.g. one huge subtree) get balanced out
+        u32 batchCount = std::min(count, threads * 4);
+        u32 batchSize = (count + batchCount - 1) / batchCount;
+
+        // NOTE: Helpers which only start after every batch is done must not touch the caller's stack anymore,
+        // so everything they look at before claiming a batch lives in state they keep alive themselves
+        struct State {
+            std::atomic<u32> NextBatch = 0;
+            u32 FinishedBatches = 0;
+
+            std::mutex Mutex;
+            std::condition_variable AllFinished;
+        };
+
+        std::shared_ptr<State> state = std::make_shared<State>();
+
+        // NOTE: func only gets called for a claimed batch, which the caller waits for, so taking it by reference is fine
+        auto worker = [state, &func, batchCount, batchSize, count]() {
+            u32 batch;
+            while ((batch = state->NextBatch.fetch_add(1)) < batchCount) {
+                u32 begin = batch * batchSize;
+                u32 end = std::min(begin + batchSize, count);
+
+                if (begin < end) {
+                    func(begin, end);
+                }
+
+                std::lock_guard<std::mutex> lock(state->Mutex);
+                if (++state->FinishedBatches == batchCount) {
+                    state->AllFinished.notify_all();
+                }
+            }
+        };
+
+        u32 helpers = std::min(threads - 1, batchCount - 1);
+        for (u32 i = 0; i < helpers; i++) {
+            Submit(worker);
+        }
+
+        worker();
+
+        // Only wait for our own batches (not for every job in the pool like Wait does), so this also works from inside a job:
+        // if no worker is free the calling thread just ends up doing every batch itself
+        std::unique_lock<std::mutex> lock(state->Mutex);
+        state->AllFinished.wait(lock, [&]() { return state->FinishedBatches == batchCount; });
+    }
+
+    u32 ThreadPool::GetThreadCount() const {
+        return static_cast<u32>(m_Workers.size());
+    }
+
+    ThreadPool& ThreadPool::Get() {
+        static ThreadPool pool(std::max(std::thread::hardware_concurrency(), 2u) - 1); // - 1 since the main thread works as well
+        return pool;
+    }
+
+    void ThreadPool::WorkerLoop() {
+        while (true) {
+            std::function<void()> job;
+
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_JobAvailable.wait(lock, [this]() { return m_Stopping || !m_Jobs.empty(); });
+
+                if (m_Stopping && m_Jobs.empty()) return;
+
+                job = std::move(m_Jobs.front());
+                m_Jobs.pop();
+            }
+
+            job();
+
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_ActiveJobs--;
+            }
+
+            m_JobsFinished.notify_all();
+        }
+    }
+
+} // namespace Blackberry
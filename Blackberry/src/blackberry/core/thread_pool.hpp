@@ -0,0 +1,54 @@
+#pragma once
+
+#include "blackberry/core/types.hpp"
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace Blackberry {
+
+    // Simple fixed size pool of worker threads
+    // NOTE: Do NOT call Wait() from inside a job, it will deadlock! (ParallelFor is fine, it only waits for its own batches)
+    class ThreadPool {
+    public:
+        // threadCount is the number of worker threads, 0 means everything runs on the calling thread
+        ThreadPool(u32 threadCount = std::thread::hardware_concurrency());
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        void Submit(const std::function<void()>& job);
+
+        // Blocks until every submitted job has finished
+        void Wait();
+
+        // Splits [0, count) into batches and runs func(begin, end) on every batch, blocks until all of them are done
+        // NOTE: The calling thread also works on batches, so this is safe to use even with 0 worker threads (or from inside a job)
+        void ParallelFor(u32 count, const std::function<void(u32 begin, u32 end)>& func);
+
+        u32 GetThreadCount() const;
+
+        // Global pool shared by the engine (sized to the hardware concurrency)
+        static ThreadPool& Get();
+
+    private:
+        void WorkerLoop();
+
+    private:
+        std::vector<std::thread> m_Workers;
+        std::queue<std::function<void()>> m_Jobs;
+
+        std::mutex m_Mutex;
+        std::condition_variable m_JobAvailable;
+        std::condition_variable m_JobsFinished;
+
+        u32 m_ActiveJobs = 0; // queued + currently running
+        bool m_Stopping = false;
+    };
+
+} // namespace Blackberry
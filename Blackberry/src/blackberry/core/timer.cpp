@@ -2,10 +2,13 @@
 #include "blackberry/core/log.hpp"
 
 #include <chrono>
+#include <mutex>
 
 namespace Blackberry {
 
     std::unordered_map<const char*, TimePoint> s_TimePoints;
+    static std::unordered_map<const char*, u64> s_Counts;
+    static std::mutex s_TimePointMutex; // scenes may get updated on several threads at once (see Scene::StepParallel)
 
 #pragma region TimePoint
 
@@ -34,10 +37,15 @@ namespace Blackberry {
 #pragma region Instrumentor
 
     void Instrumentor::NewFrame() {
+        std::lock_guard<std::mutex> lock(s_TimePointMutex);
+
         s_TimePoints.clear();
+        s_Counts.clear();
     }
 
     void Instrumentor::SetTimePoint(const char* name, TimePoint timePoint) {
+        std::lock_guard<std::mutex> lock(s_TimePointMutex);
+
         if (s_TimePoints.contains(name)) {
             s_TimePoints[name] += timePoint;
         } else {
@@ -46,6 +54,8 @@ namespace Blackberry {
     }
 
     TimePoint Instrumentor::GetTimePoint(const char* name) {
+        std::lock_guard<std::mutex> lock(s_TimePointMutex);
+
         if (!s_TimePoints.contains(name)) {
             BL_CORE_WARN("Trying to access non-existent TimePoint {}!", name);
             return {};
@@ -54,6 +64,19 @@ namespace Blackberry {
         return s_TimePoints.at(name);
     }
 
+    void Instrumentor::AddCount(const char* name, u64 count) {
+        std::lock_guard<std::mutex> lock(s_TimePointMutex);
+
+        s_Counts[name] += count;
+    }
+
+    u64 Instrumentor::GetCount(const char* name) {
+        std::lock_guard<std::mutex> lock(s_TimePointMutex);
+
+        auto it = s_Counts.find(name);
+        return it != s_Counts.end() ? it->second : 0;
+    }
+
 #pragma endregion
 
 #pragma region Timer
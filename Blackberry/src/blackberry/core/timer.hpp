@@ -23,6 +23,10 @@ namespace Blackberry {
 
         static void SetTimePoint(const char* name, TimePoint timePoint);
         static TimePoint GetTimePoint(const char* name);
+
+        // Counters work like time points (added up over the frame), but hold how many times something happened
+        static void AddCount(const char* name, u64 count);
+        static u64 GetCount(const char* name); // 0 if nothing got counted this frame
     };
     
     class Timer {
@@ -50,4 +50,13 @@ namespace Blackberry::Util {
         return contents; // implicit move
     }
 
+    // Bytes the string allocated on the heap (0 if it fits into the string object itself)
+    inline u64 GetHeapSize(const std::string& str) {
+        const char* data = str.data();
+        const char* object = reinterpret_cast<const char*>(&str);
+
+        if (data >= object && data < object + sizeof(std::string)) return 0;
+        return str.capacity() + 1;
+    }
+
 } // namespace Blackberry::Util
\ No newline at end of file
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "blackberry/core/types.hpp"
+
+#include "entt.hpp"
+
+#include <vector>
+#include <atomic>
+#include <algorithm>
+
+namespace Blackberry {
+
+    // Remembers in which version (see ECS::AdvanceVersion) an entity's component last changed (got added, removed or written to),
+    // so systems can only look at what changed since they last ran instead of re-reading the whole pool every frame
+    //
+    // Besides the version of every entity there is one version per block of 64 entities (the newest change in the block),
+    // EachChangedSince skips every block which didn't change, so finding a few changes in a big scene stays cheap
+    //
+    // NOTE: Entities are stored with their entt version, so a removed component (or destroyed entity) shows up as a change
+    // whose entity isn't in the pool anymore. Key per entity data by entt::to_entity, a reused index overwrites the old entry
+    class ChangeTracker {
+    public:
+        static constexpr u32 s_BlockSize = 64;
+
+        // Makes room for entities with an index below count
+        void Reserve(u32 count) {
+            if (count <= m_Entries.size()) return;
+
+            m_Entries.resize(count);
+            m_BlockVersions.resize((count + s_BlockSize - 1) / s_BlockSize, 0);
+        }
+
+        // NOTE: Can be called from multiple threads at once (for different entities) as long as Reserve made room for them first
+        void MarkChanged(entt::entity entity, u32 version) {
+            u32 index = entt::to_entity(entity);
+
+            if (index >= m_Entries.size()) {
+                Reserve(std::max(index + 1, static_cast<u32>(m_Entries.size()) * 2));
+            }
+
+            m_Entries[index] = { entity, version };
+
+            // Versions only ever go up, so the newest change is always the latest one
+            // NOTE: Neighbouring entities share a block, hence the atomic store
+            std::atomic_ref<u32>(m_BlockVersions[index / s_BlockSize]).store(version, std::memory_order_relaxed);
+        }
+
+        // Calls func(entt::entity) for every entity which changed after version (so pass the version you got the last time)
+        template <typename Func>
+        void EachChangedSince(u32 version, Func&& func) const {
+            for (u32 block = 0; block < m_BlockVersions.size(); block++) {
+                if (m_BlockVersions[block] <= version) continue;
+
+                u32 end = std::min((block + 1) * s_BlockSize, static_cast<u32>(m_Entries.size()));
+
+                for (u32 i = block * s_BlockSize; i < end; i++) {
+                    if (m_Entries[i].Version > version) {
+                        func(m_Entries[i].Entity);
+                    }
+                }
+            }
+        }
+
+        bool HasChangedSince(entt::entity entity, u32 version) const {
+            u32 index = entt::to_entity(entity);
+            return index < m_Entries.size() && m_Entries[index].Entity == entity && m_Entries[index].Version > version;
+        }
+
+        u64 GetMemorySize() const {
+            return m_Entries.capacity() * sizeof(Entry) + m_BlockVersions.capacity() * sizeof(u32);
+        }
+
+        void Clear() {
+            m_Entries.clear();
+            m_BlockVersions.clear();
+        }
+
+    private:
+        struct Entry {
+            entt::entity Entity = entt::null;
+            u32 Version = 0;
+        };
+
+        std::vector<Entry> m_Entries; // entt::to_entity -> last change
+        std::vector<u32> m_BlockVersions;
+    };
+
+} // namespace Blackberry
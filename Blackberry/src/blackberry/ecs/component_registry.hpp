@@ -0,0 +1,97 @@
+#pragma once
+
+#include "blackberry/ecs/components.hpp"
+
+#include <type_traits>
+
+namespace Blackberry {
+
+    // Compile time info about a component
+    // Every component in AllComponents MUST have a specialization of this (use BL_REGISTER_COMPONENT)
+    template <typename T>
+    struct ComponentTraits;
+
+    // Name: the name used in scene files and scripts
+    // Serializable: gets saved to/loaded from scene files (needs SerializeComponent/DeserializeComponent overloads in scene_serializer.cpp)
+    // ScriptVisible: scripts can query/add the component by name
+    #define BL_REGISTER_COMPONENT(type, serializable, scriptVisible) \
+        template <> \
+        struct ComponentTraits<type> { \
+            static constexpr const char* Name = #type; \
+            static constexpr bool TriviallyCopyable = std::is_trivially_copyable_v<type>; \
+            static constexpr bool Serializable = serializable; \
+            static constexpr bool ScriptVisible = scriptVisible; \
+        }
+
+    BL_REGISTER_COMPONENT(TagComponent,              true,  false);
+    BL_REGISTER_COMPONENT(RelationshipComponent,     true,  false);
+    BL_REGISTER_COMPONENT(TransformComponent,        true,  true);
+    BL_REGISTER_COMPONENT(WorldTransformComponent,   false, false);
+    BL_REGISTER_COMPONENT(MeshComponent,             true,  true);
+    BL_REGISTER_COMPONENT(CameraComponent,           true,  true);
+    BL_REGISTER_COMPONENT(ScriptComponent,           true,  false);
+    BL_REGISTER_COMPONENT(RigidBodyComponent,        true,  true);
+    BL_REGISTER_COMPONENT(BoxColliderComponent,      true,  true);
+    BL_REGISTER_COMPONENT(SphereColliderComponent,   true,  true);
+    BL_REGISTER_COMPONENT(TextComponent,             true,  true);
+    BL_REGISTER_COMPONENT(DirectionalLightComponent, true,  true);
+    BL_REGISTER_COMPONENT(PointLightComponent,       true,  true);
+    BL_REGISTER_COMPONENT(SpotLightComponent,        true,  true);
+    BL_REGISTER_COMPONENT(EnvironmentComponent,      true,  true);
+    BL_REGISTER_COMPONENT(PrefabInstanceComponent,   true,  false);
+
+    #undef BL_REGISTER_COMPONENT
+
+    template <typename... T>
+    struct ComponentList {
+        static constexpr u32 Count = sizeof...(T);
+
+        // Index of a component in the list
+        template <typename U>
+        static constexpr u32 IndexOf() {
+            u32 index = 0;
+            u32 result = Count;
+            ((std::is_same_v<U, T> ? (result = index++) : index++), ...);
+
+            static_assert(((std::is_same_v<U, T>) || ...), "Component is not in the list!");
+            return result;
+        }
+
+        // Bitmask of a set of components (bit N = the Nth component in the list), e.g. to describe what a system accesses
+        template <typename... U>
+        static constexpr u32 MaskOf() {
+            return ((1u << IndexOf<std::remove_const_t<U>>()) | ... | 0u);
+        }
+
+        static constexpr u32 AllMask = Count == 32 ? ~0u : (1u << Count) - 1;
+
+        // Calls func.template operator()<Component>() for every component (in order), use it with a template lambda:
+        // AllComponents::ForEach([&]<typename T>() { ... });
+        template <typename Func>
+        static void ForEach(Func&& func) {
+            (func.template operator()<T>(), ...);
+        }
+    };
+
+    // NOTE: The order matters! Components get copied/serialized in this order
+    // (e.g. TransformComponent has to come before WorldTransformComponent, see ECS::ECS)
+    using AllComponents = ComponentList<
+        TagComponent,
+        RelationshipComponent,
+        TransformComponent,
+        WorldTransformComponent,
+        MeshComponent,
+        CameraComponent,
+        ScriptComponent,
+        RigidBodyComponent,
+        BoxColliderComponent,
+        SphereColliderComponent,
+        TextComponent,
+        DirectionalLightComponent,
+        PointLightComponent,
+        SpotLightComponent,
+        EnvironmentComponent,
+        PrefabInstanceComponent
+    >;
+
+} // namespace Blackberry
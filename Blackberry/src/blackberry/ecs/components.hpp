@@ -3,6 +3,7 @@
 #include "blackberry/core/types.hpp"
 #include "blackberry/core/path.hpp"
 #include "blackberry/core/util.hpp"
+#include "blackberry/core/interned_string.hpp"
 
 #include "glm/glm.hpp"
 #include "glm/ext/matrix_transform.hpp"
@@ -11,7 +12,7 @@
 #include <glm/gtx/quaternion.hpp>
 
 #include <string>
-#include <map>
+#include <type_traits>
 
 namespace Blackberry {
 
@@ -49,7 +50,7 @@ namespace Blackberry {
     };
 
     struct TagComponent {
-        std::string Name;
+        InternedString Name; // NOTE: Use Scene::SetEntityName to rename entities
         u64 UUID = 0;
     };
 
@@ -72,11 +73,84 @@ namespace Blackberry {
 
             return pos * rot * scale;
         }
+
+        inline bool operator==(const TransformComponent& other) const {
+            return Position == other.Position && Rotation == other.Rotation && Scale == other.Scale;
+        }
+    };
+
+    // Cached world space transform of an entity (managed by the scene, NOT serialized!)
+    // Gets recomputed in Scene::UpdateWorldTransforms only when the entity's (or a parent's) transform got marked as changed
+    struct WorldTransformComponent {
+        BlMat4 Matrix = BlMat4(1.0f);
+
+        BlVec3 Position = BlVec3(0.0f);
+        BlQuat Rotation = BlQuat(1.0f, 0.0f, 0.0f, 0.0f);
+        BlVec3 Scale = BlVec3(1.0f);
+    };
+
+    // The materials a mesh uses instead of its model's ones (material index -> material asset handle)
+    // Stored inline so mesh components stay trivially copyable, which limits how many materials one entity can override
+    struct MaterialOverrides {
+        static constexpr u32 s_Capacity = 4;
+        static constexpr u32 s_MaxMaterialIndex = 0xFFFF; // the indices are stored as u16
+
+        // Returns 0 if the material isn't overridden
+        u64 Get(u32 materialIndex) const {
+            for (u32 i = 0; i < Count; i++) {
+                if (Indices[i] == materialIndex) return Handles[i];
+            }
+
+            return 0;
+        }
+
+        // A handle of 0 removes the override, returns false if there is no room left for another one
+        // NOTE: The material index MUST be at most s_MaxMaterialIndex
+        bool Set(u32 materialIndex, u64 handle) {
+            BL_ASSERT(materialIndex <= s_MaxMaterialIndex, "Material index {} doesn't fit into a MaterialOverrides!", materialIndex);
+
+            for (u32 i = 0; i < Count; i++) {
+                if (Indices[i] != materialIndex) continue;
+
+                if (handle != 0) {
+                    Handles[i] = handle;
+                } else {
+                    Count--;
+                    Indices[i] = Indices[Count];
+                    Handles[i] = Handles[Count];
+                }
+
+                return true;
+            }
+
+            if (handle == 0) return true;
+            if (Count == s_Capacity) return false;
+
+            Indices[Count] = static_cast<u16>(materialIndex);
+            Handles[Count] = handle;
+            Count++;
+
+            return true;
+        }
+
+        // Calls func(u32 materialIndex, u64 handle) for every override
+        template <typename Func>
+        void Each(Func&& func) const {
+            for (u32 i = 0; i < Count; i++) {
+                func(static_cast<u32>(Indices[i]), Handles[i]);
+            }
+        }
+
+        u32 Size() const { return Count; }
+
+        u64 Handles[s_Capacity] = {};
+        u16 Indices[s_Capacity] = {};
+        u8 Count = 0;
     };
 
     struct MeshComponent {
         u64 MeshHandle = 0;
-        std::map<u32, u64> MaterialHandles;
+        MaterialOverrides MaterialHandles; // material overrides over the model's materials (over the prefab's defaults for prefab instances)
     };
 
     struct CameraComponent {
@@ -89,7 +163,7 @@ namespace Blackberry {
     };
 
     struct ScriptComponent {
-        FS::Path ModulePath;
+        InternedString ModulePath; // normalized (FS::Path::String), also the name of the script's Lua module
     };
 
     struct RigidBodyComponent {
@@ -140,4 +214,15 @@ namespace Blackberry {
         f32 BloomThreshold = 3.0f;
     };
 
+    // Marks an entity as one of the nodes of a prefab instance (see Prefab and Scene::InstantiatePrefab)
+    struct PrefabInstanceComponent {
+        u64 Prefab = 0; // asset handle
+        u32 Node = 0; // index into Prefab::GetNodes
+    };
+
+    // NOTE: These get copied around in bulk (scene copies, prefab instances, duplicating entities), keep them free of heap memory
+    static_assert(std::is_trivially_copyable_v<TagComponent>);
+    static_assert(std::is_trivially_copyable_v<MeshComponent>);
+    static_assert(std::is_trivially_copyable_v<ScriptComponent>);
+
 } // namespace Blackberry
\ No newline at end of file
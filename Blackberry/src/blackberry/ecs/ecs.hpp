@@ -1,122 +1,337 @@
 #pragma once
 
 #include "blackberry/ecs/components.hpp"
+#include "blackberry/ecs/component_registry.hpp"
+#include "blackberry/ecs/change_tracker.hpp"
+#include "blackberry/ecs/ecs_stats.hpp"
 #include "blackberry/core/log.hpp"
 #include "blackberry/scene/uuid.hpp"
 
 #include "entt.hpp"
 
+#include <cstring>
+#include <algorithm>
+#include <bit>
+#include <utility>
+#include <array>
+
 namespace Blackberry {
 
     using EntityID = entt::entity;
 
     template <typename T>
     inline static void CopyComponent(entt::registry* src, entt::registry* dest, entt::entity srcEntity, entt::entity destEntity) {
-        if (src->any_of<T>(srcEntity)) {
-            BL_CORE_TRACE("Copying component {} of entity {}", typeid(T).name(), static_cast<u32>(srcEntity));
-            dest->emplace<T>(destEntity, src->get<T>(srcEntity));
+        if (const T* component = src->try_get<T>(srcEntity)) {
+            // NOTE: emplace_or_replace since some components get added automatically (e.g. WorldTransformComponent)
+            dest->emplace_or_replace<T>(destEntity, *component);
+        }
+    }
+
+    // Copies a whole component pool at once (the entities MUST already exist in dest and the pool in dest MUST be empty)
+    // NOTE: This goes through the underlying storage so no construct signals get fired, every pool gets copied as is anyway
+    template <typename T>
+    inline static void CopyComponentPool(const entt::storage<T>& src, entt::registry& dest) {
+        const entt::storage<T>* srcStorage = &src;
+        if (srcStorage->empty()) return;
+
+        auto& destSignalStorage = dest.storage<T>();
+        BL_ASSERT(destSignalStorage.empty(), "Component pool {} is not empty!", ComponentTraits<T>::Name);
+
+        entt::storage<T>& destStorage = destSignalStorage;
+
+        const entt::sparse_set& srcEntities = *srcStorage;
+        u32 count = static_cast<u32>(srcStorage->size());
+
+        destStorage.reserve(count);
+
+        if constexpr (ComponentTraits<T>::TriviallyCopyable) {
+            // Add the entities in the same order (so both pools have the exact same layout) and then memcpy the pages
+            destStorage.insert(srcEntities.rbegin(), srcEntities.rend());
+
+            constexpr u32 pageSize = static_cast<u32>(entt::component_traits<T>::page_size);
+            for (u32 page = 0; page * pageSize < count; page++) {
+                u32 elements = std::min(pageSize, count - page * pageSize);
+                std::memcpy(destStorage.raw()[page], srcStorage->raw()[page], elements * sizeof(T));
+            }
+        } else {
+            destStorage.insert(srcEntities.rbegin(), srcEntities.rend(), srcStorage->rbegin());
         }
     }
 
+    // Minimal in memory archive for entt snapshots (only used for the entity storage)
+    struct EntitySnapshotArchive {
+        std::vector<u32> Data;
+        u32 ReadPosition = 0;
+
+        void operator()(u32 value) { Data.push_back(value); }
+        void operator()(entt::entity entity) { Data.push_back(static_cast<u32>(entity)); }
+    };
+
+    struct EntitySnapshotLoader {
+        EntitySnapshotArchive* Archive = nullptr;
+
+        void operator()(u32& value) { value = Archive->Data[Archive->ReadPosition++]; }
+        void operator()(entt::entity& entity) { entity = static_cast<entt::entity>(Archive->Data[Archive->ReadPosition++]); }
+    };
+
+    // An owning entt group: the owned pools get sorted so the entities with all the components are packed at the front
+    // of every owned pool (in the same order), so iterating the group walks the owned pools in lockstep without any lookups
+    template <typename Owned, typename Get>
+    struct ComponentGroup;
+
+    template <typename... Owned, typename... Get>
+    struct ComponentGroup<entt::owned_t<Owned...>, entt::get_t<Get...>> {
+        static constexpr u32 OwnedMask = AllComponents::MaskOf<Owned...>();
+        static constexpr u32 Mask = AllComponents::MaskOf<Owned..., Get...>();
+    };
+
+    template <typename... Groups>
+    struct ComponentGroupList {
+        template <typename Group>
+        static constexpr bool Contains() {
+            return (std::is_same_v<Group, Groups> || ...);
+        }
+
+        template <typename Group>
+        static constexpr u32 IndexOf() {
+            u32 index = 0;
+            u32 result = sizeof...(Groups);
+            ((std::is_same_v<Group, Groups> ? (result = index++) : index++), ...);
+
+            return result;
+        }
+
+        template <typename Func>
+        static void ForEach(Func&& func) {
+            (func.template operator()<Groups>(), ...);
+        }
+    };
+
+    // The groups for the engine's hot loops (see ECS::GetGroup)
+    // NOTE: entt doesn't allow a component to be owned by more than one group, the mesh group owns the world transforms
+    // so the others only observe them (they still pack their own pool and only look the world transform up)
+    using MeshGroup = ComponentGroup<entt::owned_t<WorldTransformComponent, MeshComponent>, entt::get_t<>>;
+    using PointLightGroup = ComponentGroup<entt::owned_t<PointLightComponent>, entt::get_t<WorldTransformComponent>>;
+    using SpotLightGroup = ComponentGroup<entt::owned_t<SpotLightComponent>, entt::get_t<WorldTransformComponent>>;
+    using RigidBodyGroup = ComponentGroup<entt::owned_t<RigidBodyComponent>, entt::get_t<TransformComponent>>;
+
+    using EngineGroups = ComponentGroupList<MeshGroup, PointLightGroup, SpotLightGroup, RigidBodyGroup>;
+
+    // The components whose changes get tracked (see ECS::GetChanges)
+    using TrackedComponents = ComponentList<
+        TransformComponent,
+        WorldTransformComponent,
+        MeshComponent,
+        DirectionalLightComponent,
+        PointLightComponent,
+        SpotLightComponent
+    >;
+
+    // Thin wrapper around an entt registry
+    //
+    // ECSs can be copy-on-write copies of another ECS (see CreateCopyOnWrite): the copy gets its own entities
+    // but reads every component pool from the original until one of them writes to that pool, only then the pool gets cloned.
+    // Because of this, component access goes through GetPool/GetComponent/TryGetComponent where a const T means read only access
+    // (e.g. GetComponent<const TagComponent>), everything else is treated as a write and clones the pool if it is shared
     class ECS {
     public:
-        ECS() = default;
-        ~ECS() = default;
+        ECS() {
+            // Every entity with a transform also gets a cached world transform (see Scene::UpdateWorldTransforms)
+            // NOTE: This way the world transform update never has to add/remove components, so it can run on multiple threads
+            m_Registry.on_construct<TransformComponent>().connect<&ECS::OnTransformConstructed>(*this);
+            m_Registry.on_destroy<TransformComponent>().connect<&ECS::OnTransformDestroyed>(*this);
+
+            // NOTE: Only real adds/removes fire these, cloning a shared pool doesn't (the copies get the trackers of the source)
+            TrackedComponents::ForEach([&]<typename T>() {
+                m_Registry.on_construct<T>().template connect<&ECS::OnTrackedComponentChanged<T>>(*this);
+                m_Registry.on_update<T>().template connect<&ECS::OnTrackedComponentChanged<T>>(*this);
+                m_Registry.on_destroy<T>().template connect<&ECS::OnTrackedComponentChanged<T>>(*this);
+            });
+        }
+
+        ~ECS() {
+            // Copies which still read from us need their own pools now
+            std::vector<ECS*> copies = m_CopyOnWriteCopies;
+            for (ECS* copy : copies) {
+                copy->MakeAllWritable();
+            }
+
+            DetachFromBase();
+        }
+
+        ECS(const ECS&) = delete;
+        ECS& operator=(const ECS&) = delete;
 
         // literally copies entity (NOTE: does NOT create new UUIDs!!)
         // be VERY careful using this!
         static void DuplicateEntity(entt::entity target, entt::registry* srcReg, entt::registry* destReg) {
-            BL_CORE_INFO("DUPLICATING entity {}", static_cast<u32>(target));
-
-            entt::registry* src = srcReg;
-            entt::registry* dest = destReg;
+            const auto newEntity = destReg->create(target);
 
-            const auto newEntity = dest->create(target);
-
-            CopyComponent<TagComponent>(src, dest, target, newEntity);
-            CopyComponent<RelationshipComponent>(src, dest, target, newEntity);
-            CopyComponent<TransformComponent>(src, dest, target, newEntity);
-            CopyComponent<MeshComponent>(src, dest, target, newEntity);
-            CopyComponent<CameraComponent>(src, dest, target, newEntity);
-            CopyComponent<TextComponent>(src, dest, target, newEntity);
-            CopyComponent<ScriptComponent>(src, dest, target, newEntity);
-            CopyComponent<RigidBodyComponent>(src, dest, target, newEntity);
-            CopyComponent<BoxColliderComponent>(src, dest, target, newEntity);
-            CopyComponent<SphereColliderComponent>(src, dest, target, newEntity);
-            CopyComponent<DirectionalLightComponent>(src, dest, target, newEntity);
-            CopyComponent<PointLightComponent>(src, dest, target, newEntity);
-            CopyComponent<EnvironmentComponent>(src, dest, target, newEntity);
+            AllComponents::ForEach([&]<typename T>() {
+                CopyComponent<T>(srcReg, destReg, target, newEntity);
+            });
         }
 
         // safer version on duplicate entity (generates new UUIDs)
         static EntityID CopyEntity(entt::entity target, entt::registry* srcReg, entt::registry* destReg) {
             BL_CORE_INFO("COPYING entity {}", static_cast<u32>(target));
 
-            entt::registry* src = srcReg;
-            entt::registry* dest = destReg;
+            const auto newEntity = destReg->create(target);
 
-            const auto newEntity = dest->create(target);
             TagComponent tag;
-            tag.Name = src->get<TagComponent>(target).Name;
+            tag.Name = srcReg->get<TagComponent>(target).Name;
             tag.UUID = UUID();
 
-            dest->emplace<TagComponent>(newEntity, tag);
-
-            CopyComponent<TransformComponent>(src, dest, target, newEntity);
-            CopyComponent<RelationshipComponent>(src, dest, target, newEntity);
-            CopyComponent<MeshComponent>(src, dest, target, newEntity);
-            CopyComponent<CameraComponent>(src, dest, target, newEntity);
-            CopyComponent<TextComponent>(src, dest, target, newEntity);
-            CopyComponent<ScriptComponent>(src, dest, target, newEntity);
-            CopyComponent<RigidBodyComponent>(src, dest, target, newEntity);
-            CopyComponent<BoxColliderComponent>(src, dest, target, newEntity);
-            CopyComponent<SphereColliderComponent>(src, dest, target, newEntity);
-            CopyComponent<DirectionalLightComponent>(src, dest, target, newEntity);
-            CopyComponent<PointLightComponent>(src, dest, target, newEntity);
-            CopyComponent<EnvironmentComponent>(src, dest, target, newEntity);
+            destReg->emplace<TagComponent>(newEntity, tag);
+
+            AllComponents::ForEach([&]<typename T>() {
+                if constexpr (!std::is_same_v<T, TagComponent>) {
+                    CopyComponent<T>(srcReg, destReg, target, newEntity);
+                }
+            });
+
+            return newEntity;
+        }
+
+        // Same as the static version but copies inside of this ECS (and only clones the pools the entity actually uses)
+        EntityID CopyEntity(EntityID target) {
+            BL_CORE_INFO("COPYING entity {}", static_cast<u32>(target));
+
+            const auto newEntity = m_Registry.create();
+
+            TagComponent tag;
+            tag.Name = GetComponent<const TagComponent>(target).Name;
+            tag.UUID = UUID();
+
+            AddComponent<TagComponent>(newEntity, tag);
+
+            AllComponents::ForEach([&]<typename T>() {
+                if constexpr (!std::is_same_v<T, TagComponent>) {
+                    if (const T* component = TryGetComponent<const T>(target)) {
+                        T copy = *component; // NOTE: copy first, adding the component may move the pool around
+                        auto& pool = GetPool<T>();
+
+                        // NOTE: Some components get added automatically (e.g. WorldTransformComponent)
+                        if (pool.contains(newEntity)) {
+                            pool.get(newEntity) = copy;
+                        } else {
+                            pool.emplace(newEntity, copy);
+                        }
+                    }
+                }
+            });
 
             return newEntity;
         }
 
+        // Copies every entity (with the same ids) and then every component pool in one go
         static ECS* Copy(ECS* current) {
             ECS* newECS = new ECS();
 
-            auto view = current->m_Registry.view<entt::entity>();
+            CopyEntities(current->m_Registry, newECS->m_Registry);
 
-            for (auto it = view.rbegin(); it < view.rend(); it++) {
-                auto entity = *it;
-                DuplicateEntity(entity, &current->m_Registry, &newECS->m_Registry);
-            }
+            AllComponents::ForEach([&]<typename T>() {
+                CopyComponentPool<T>(current->GetPool<const T>(), newECS->m_Registry);
+            });
+
+            newECS->m_Changes = current->m_Changes;
+            newECS->m_Version = current->m_Version;
 
             return newECS;
         }
 
+        // Creates a copy which shares every component pool with base until either one of them writes to a pool
+        // NOTE: Only the entities get copied right away
+        static ECS* CreateCopyOnWrite(ECS* base) {
+            ECS* copy = new ECS();
+
+            CopyEntities(base->m_Registry, copy->m_Registry);
+
+            copy->m_Base = base;
+            copy->m_SharedPools = AllComponents::AllMask;
+            base->m_CopyOnWriteCopies.push_back(copy);
+
+            copy->m_Changes = base->m_Changes;
+            copy->m_Version = base->m_Version;
+
+            return copy;
+        }
+
+        // Clones every pool which is still shared with the base (after this the ECS is completely independent)
+        void MakeAllWritable() {
+            AllComponents::ForEach([&]<typename T>() {
+                CloneSharedPool<T>();
+            });
+        }
+
+        // Returns how many component pools are still shared with the base ECS
+        u32 GetSharedPoolCount() const {
+            return static_cast<u32>(std::popcount(m_SharedPools));
+        }
+
         EntityID CreateEntity() {
             return m_Registry.create();
         }
 
+        // Fills entities with new entities in one go (e.g. when spawning lots of prefab instances)
+        void CreateEntities(std::vector<EntityID>& entities) {
+            m_Registry.create(entities.begin(), entities.end());
+        }
+
         void DestroyEntity(EntityID entity) {
+            if (m_SharedPools != 0 || !m_CopyOnWriteCopies.empty()) {
+                // Destroying an entity writes to every pool it is in
+                AllComponents::ForEach([&]<typename T>() {
+                    if (HasComponent<T>(entity)) {
+                        MakeWritable<T>();
+                    }
+                });
+            }
+
             m_Registry.destroy(entity);
         }
 
+        // Destroys a batch of entities (only checks for shared pools once instead of once per entity)
+        void DestroyEntities(const std::vector<EntityID>& entities) {
+            if (m_SharedPools != 0 || !m_CopyOnWriteCopies.empty()) {
+                AllComponents::ForEach([&]<typename T>() {
+                    auto& pool = GetPool<const T>();
+
+                    if (std::any_of(entities.begin(), entities.end(), [&](EntityID entity) { return pool.contains(entity); })) {
+                        MakeWritable<T>();
+                    }
+                });
+            }
+
+            m_Registry.destroy(entities.begin(), entities.end());
+        }
+
         template <typename T>
         void AddComponent(EntityID entity, const T& component) {
-            m_Registry.emplace<T>(entity, component);
+            GetPool<T>().emplace(entity, component);
         }
 
         template <typename... T>
         bool HasComponent(EntityID entity) {
-            return m_Registry.any_of<T...>(entity);
+            return (GetPool<const T>().contains(entity) || ...);
         }
 
+        // NOTE: Use a const T for read only access
         template <typename T>
         T& GetComponent(EntityID entity) {
-            return m_Registry.get<T>(entity);
+            return GetPool<T>().get(entity);
+        }
+
+        // NOTE: Use a const T for read only access
+        template <typename T>
+        T* TryGetComponent(EntityID entity) {
+            auto& pool = GetPool<T>();
+            return pool.contains(entity) ? &pool.get(entity) : nullptr;
         }
 
         template <typename T>
         void RemoveComponent(EntityID entity) {
-            m_Registry.remove<T>(entity);
+            GetPool<T>().remove(entity);
         }
 
         std::vector<EntityID> GetAllEntities() {
@@ -127,15 +342,256 @@ namespace Blackberry {
             return entities;
         }
 
+        // NOTE: Use const components for the ones you only read from (e.g. GetEntitiesWithComponents<const TagComponent>)
         template <typename... T>
         auto GetEntitiesWithComponents() {
-            return m_Registry.view<T...>();
+            return entt::basic_view<entt::get_t<entt::registry::storage_for_type<T>...>, entt::exclude_t<>>{ GetPool<T>()... };
+        }
+
+        // Returns the storage of a component, a const T gives read only access (which may be the base's pool)
+        // NOTE: This may create the pool, so call it once up front if the pool will be used from multiple threads
+        template <typename T>
+        using PoolType = std::conditional_t<std::is_const_v<T>,
+            const entt::registry::storage_for_type<std::remove_const_t<T>>,
+            entt::registry::storage_for_type<T>>;
+
+        template <typename T>
+        PoolType<T>& GetPool() {
+            using Component = std::remove_const_t<T>;
+
+            if constexpr (std::is_const_v<T>) {
+                if (IsPoolShared<Component>()) {
+                    return m_Base->GetPool<T>();
+                }
+
+                return std::as_const(m_Registry.storage<Component>());
+            } else {
+                MakeWritable<Component>();
+                return m_Registry.storage<Component>();
+            }
+        }
+
+        // Creates the pools of the read components and makes the written ones writable up front, after this
+        // GetPool never modifies the registry for those components (so they can be used from multiple threads, see SystemScheduler)
+        void PreparePools(u32 reads, u32 writes) {
+            AllComponents::ForEach([&]<typename T>() {
+                u32 bit = 1u << AllComponents::IndexOf<T>();
+
+                if (writes & bit) {
+                    GetPool<T>();
+                } else if (reads & bit) {
+                    GetPool<const T>();
+                }
+            });
+        }
+
+        // Creates every engine group made up of only the given components up front (so GetGroup is safe to use from multiple threads)
+        void PrepareGroups(u32 components) {
+            EngineGroups::ForEach([&]<typename Group>() {
+                if ((Group::Mask & components) == Group::Mask) {
+                    CreateGroup(Group{});
+                }
+            });
+        }
+
+        // Returns one of the engine groups (EngineGroups), a const component means read only access (same as GetEntitiesWithComponents)
+        // e.g. GetGroup<const WorldTransformComponent, const MeshComponent>() or GetGroup<const PointLightComponent>(entt::get<const WorldTransformComponent>)
+        // NOTE: The group gets created on first use, which sorts the owned pools (so a copy-on-write ECS clones all the pools of the group)
+        template <typename... Owned, typename... Get>
+        auto GetGroup(entt::get_t<Get...> = entt::get_t<Get...>{}) {
+            using Group = ComponentGroup<entt::owned_t<std::remove_const_t<Owned>...>, entt::get_t<std::remove_const_t<Get>...>>;
+            static_assert(EngineGroups::Contains<Group>(), "Only the groups in EngineGroups can be used!");
+
+            CreateGroup(Group{});
+
+            return m_Registry.group<Owned...>(entt::get<Get...>);
+        }
+
+        // Change tracking (see ChangeTracker), every change gets stamped with the current version.
+        // A system which only wants to look at what changed since it last ran does:
+        //
+        //   u32 last = m_LastVersion;
+        //   m_LastVersion = ecs->AdvanceVersion();
+        //   ecs->GetChanges<PointLightComponent>().EachChangedSince(last, [&](EntityID entity) { ... });
+        //
+        // NOTE: Adding/removing components gets tracked automatically, writing through GetComponent doesn't (call MarkChanged after it).
+        // Scene::UpdateWorldTransforms only recomputes the entities whose TransformComponent got marked (and marks every world transform it recomputed)
+        u32 GetVersion() const { return m_Version; }
+
+        // Returns the current version and starts a new one (so every change from now on is newer than the returned version)
+        u32 AdvanceVersion() { return m_Version++; }
+
+        template <typename T>
+        void MarkChanged(EntityID entity) {
+            GetChanges<T>().MarkChanged(entity, m_Version);
+        }
+
+        template <typename T>
+        ChangeTracker& GetChanges() {
+            return m_Changes[TrackedComponents::IndexOf<T>()];
+        }
+
+        template <typename T>
+        const ChangeTracker& GetChanges() const {
+            return m_Changes[TrackedComponents::IndexOf<T>()];
+        }
+
+        // Memory usage and occupancy of the entities and every component pool
+        // NOTE: Walks every component which owns heap memory, so it's meant for tools (not for every frame).
+        // Creates the pools which don't exist yet, so it must not run alongside systems
+        ECSStats GetStats() {
+            ECSStats stats;
+
+            const auto& entities = m_Registry.storage<entt::entity>();
+            stats.AliveEntities = static_cast<u32>(entities.free_list());
+            stats.EntitySlots = static_cast<u32>(entities.size());
+            stats.EntityBytes = (entities.entt::sparse_set::capacity() + entities.extent()) * sizeof(entt::entity);
+
+            for (const ChangeTracker& changes : m_Changes) {
+                stats.ChangeTrackerBytes += changes.GetMemorySize();
+            }
+
+            stats.InternedStrings = InternedString::GetPoolSize();
+            stats.InternedStringBytes = InternedString::GetPoolMemorySize();
+
+            stats.Pools.reserve(AllComponents::Count);
+
+            AllComponents::ForEach([&]<typename T>() {
+                ComponentPoolStats pool = GetPoolStats<T>(GetPool<const T>());
+                pool.Shared = IsPoolShared<T>();
+
+                stats.Pools.push_back(pool);
+            });
+
+            return stats;
+        }
+
+        template <typename T>
+        bool IsPoolShared() const {
+            return m_SharedPools & (1u << AllComponents::IndexOf<T>());
+        }
+
+    private:
+        static void CopyEntities(const entt::registry& src, entt::registry& dest) {
+            // The entity storage goes through a snapshot so the ids, versions and free list all stay the same
+            EntitySnapshotArchive archive;
+            EntitySnapshotLoader loader{ &archive };
+
+            entt::snapshot{ src }.get<entt::entity>(archive);
+            entt::snapshot_loader{ dest }.get<entt::entity>(loader);
+        }
+
+        // Must be called before writing to a pool: copies which still share the pool with us get their own version first,
+        // then we get our own version if we are sharing it with our base
+        template <typename T>
+        void MakeWritable() {
+            if (m_SharedPools == 0 && m_CopyOnWriteCopies.empty()) return; // nothing is shared (the common case)
+
+            // NOTE: Adding/removing a component of one of our groups also reorders the pools owned by the group
+            if (m_GroupedComponents & (1u << AllComponents::IndexOf<T>())) {
+                u32 owned = 0;
+                EngineGroups::ForEach([&]<typename Group>() {
+                    if (IsGroupCreated<Group>() && (Group::Mask & (1u << AllComponents::IndexOf<T>()))) {
+                        owned |= Group::OwnedMask;
+                    }
+                });
+
+                AllComponents::ForEach([&]<typename Component>() {
+                    if (!std::is_same_v<Component, T> && (owned & (1u << AllComponents::IndexOf<Component>()))) {
+                        MakePoolWritable<Component>();
+                    }
+                });
+            }
+
+            MakePoolWritable<T>();
+        }
+
+        template <typename T>
+        void MakePoolWritable() {
+            if (!m_CopyOnWriteCopies.empty()) {
+                std::vector<ECS*> copies = m_CopyOnWriteCopies; // cloning may detach the copy (which modifies the list)
+                for (ECS* copy : copies) {
+                    copy->CloneSharedPool<T>();
+                }
+            }
+
+            CloneSharedPool<T>();
+        }
+
+        template <typename T>
+        void CloneSharedPool() {
+            if (!IsPoolShared<T>()) return;
+
+            BL_CORE_TRACE("Cloning shared component pool {}", ComponentTraits<T>::Name);
+
+            m_SharedPools &= ~(1u << AllComponents::IndexOf<T>());
+            CopyComponentPool<T>(m_Base->GetPool<const T>(), m_Registry);
+
+            if (m_SharedPools == 0) {
+                DetachFromBase();
+            }
+        }
+
+        template <typename... Owned, typename... Get>
+        void CreateGroup(ComponentGroup<entt::owned_t<Owned...>, entt::get_t<Get...>> group) {
+            using Group = decltype(group);
+            if (IsGroupCreated<Group>()) return;
+
+            // The group sorts the owned pools right away and has to see every component of the group,
+            // so none of them can be shared with our base or our copies from now on
+            (MakeWritable<Owned>(), ...);
+            (MakeWritable<Get>(), ...);
+
+            m_Registry.group<Owned...>(entt::get<Get...>);
+
+            m_CreatedGroups |= 1u << EngineGroups::IndexOf<Group>();
+            m_GroupedComponents |= Group::Mask;
+        }
+
+        template <typename Group>
+        bool IsGroupCreated() const {
+            return m_CreatedGroups & (1u << EngineGroups::IndexOf<Group>());
+        }
+
+        void DetachFromBase() {
+            if (!m_Base) return;
+
+            std::erase(m_Base->m_CopyOnWriteCopies, this);
+            m_Base = nullptr;
+            m_SharedPools = 0;
+        }
+
+        void OnTransformConstructed(entt::registry& registry, entt::entity entity) {
+            MakeWritable<WorldTransformComponent>();
+            registry.emplace_or_replace<WorldTransformComponent>(entity);
+        }
+
+        void OnTransformDestroyed(entt::registry& registry, entt::entity entity) {
+            MakeWritable<WorldTransformComponent>();
+            registry.remove<WorldTransformComponent>(entity);
+        }
+
+        template <typename T>
+        void OnTrackedComponentChanged(entt::registry&, entt::entity entity) {
+            MarkChanged<T>(entity);
         }
 
     private:
         entt::registry m_Registry;
 
+        // Copy-on-write state
+        ECS* m_Base = nullptr; // The ECS we are sharing pools with (if any)
+        u32 m_SharedPools = 0; // Bit N set means the pool of the Nth component in AllComponents is read from m_Base
+        std::vector<ECS*> m_CopyOnWriteCopies; // Copies which may still read from our pools
+
+        // Owning groups (entt keeps a group up to date once it exists, but a pool which is shared can't be part of one)
+        u32 m_CreatedGroups = 0; // Bit N set means the Nth group in EngineGroups exists in m_Registry
+        u32 m_GroupedComponents = 0; // Every component of the created groups
+
+        std::array<ChangeTracker, TrackedComponents::Count> m_Changes;
+        u32 m_Version = 1; // 0 means "before anything happened", so EachChangedSince(0) gives every change
+
         friend class Scene;
     };
 
-} // namespace Blackberry
\ No newline at end of file
+} // namespace Blackberry
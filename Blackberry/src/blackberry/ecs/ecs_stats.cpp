@@ -0,0 +1,57 @@
+#include "blackberry/ecs/ecs_stats.hpp"
+
+#include "json.hpp"
+using json = nlohmann::json;
+
+#include <fstream>
+
+namespace Blackberry {
+
+    u64 ECSStats::GetTotalBytes() const {
+        u64 total = EntityBytes + ChangeTrackerBytes;
+
+        for (const ComponentPoolStats& pool : Pools) {
+            if (!pool.Shared) {
+                total += pool.GetTotalBytes();
+            }
+        }
+
+        return total;
+    }
+
+    std::string ECSStats::ToJson() const {
+        json j;
+
+        j["AliveEntities"] = AliveEntities;
+        j["EntitySlots"] = EntitySlots;
+        j["EntityBytes"] = EntityBytes;
+        j["ChangeTrackerBytes"] = ChangeTrackerBytes;
+        j["InternedStrings"] = InternedStrings;
+        j["InternedStringBytes"] = InternedStringBytes;
+        j["TotalBytes"] = GetTotalBytes();
+
+        for (const ComponentPoolStats& pool : Pools) {
+            j["Pools"][pool.Name] = {
+                {"ComponentSize", pool.ComponentSize},
+                {"Count", pool.Count},
+                {"Capacity", pool.Capacity},
+                {"SparseSlots", pool.SparseSlots},
+                {"DenseBytes", pool.DenseBytes},
+                {"SparseBytes", pool.SparseBytes},
+                {"HeapBytes", pool.HeapBytes},
+                {"TotalBytes", pool.GetTotalBytes()},
+                {"DenseOccupancy", pool.DenseOccupancy},
+                {"SparseOccupancy", pool.SparseOccupancy},
+                {"Shared", pool.Shared}
+            };
+        }
+
+        return j.dump(4);
+    }
+
+    void ECSStats::WriteJson(const FS::Path& path) const {
+        std::ofstream stream(path);
+        stream << ToJson();
+    }
+
+} // namespace Blackberry
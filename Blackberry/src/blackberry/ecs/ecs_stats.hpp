@@ -0,0 +1,93 @@
+#pragma once
+
+#include "blackberry/core/types.hpp"
+#include "blackberry/core/path.hpp"
+#include "blackberry/core/util.hpp"
+#include "blackberry/ecs/component_registry.hpp"
+
+#include "entt.hpp"
+
+#include <string>
+#include <vector>
+
+namespace Blackberry {
+
+    // Memory and occupancy of one component pool (see ECS::GetStats)
+    struct ComponentPoolStats {
+        const char* Name = "";
+        u32 ComponentSize = 0; // sizeof(T)
+
+        u32 Count = 0; // components in the pool
+        u32 Capacity = 0; // component slots the pool allocated (entt allocates them in pages)
+        u32 SparseSlots = 0; // entity indices the sparse array covers
+
+        u64 DenseBytes = 0; // the components plus the packed entity array
+        u64 SparseBytes = 0; // NOTE: An upper bound, entt only allocates the sparse pages which are actually used
+        u64 HeapBytes = 0; // what the components own on the heap (e.g. text contents, interned strings live in the string pool)
+
+        // Fraction of the allocated component slots in use (what's left is slack from removed components/page granularity)
+        f32 DenseOccupancy = 0.0f;
+        // Fraction of the sparse slots which point at a component (low means the pool only has a few of many entities)
+        f32 SparseOccupancy = 0.0f;
+
+        bool Shared = false; // shared with the ECS this one was copied from (so none of it is owned by this ECS)
+
+        u64 GetTotalBytes() const { return DenseBytes + SparseBytes + HeapBytes; }
+    };
+
+    struct ECSStats {
+        u32 AliveEntities = 0;
+        u32 EntitySlots = 0; // alive + destroyed entities waiting to be reused
+        u64 EntityBytes = 0;
+
+        u64 ChangeTrackerBytes = 0;
+
+        // NOTE: The string pool (see InternedString) is shared by every ECS, so it isn't part of the total
+        u32 InternedStrings = 0;
+        u64 InternedStringBytes = 0;
+
+        std::vector<ComponentPoolStats> Pools; // in AllComponents order
+
+        // Everything this ECS owns (shared pools are left out)
+        u64 GetTotalBytes() const;
+
+        // e.g. to compare the memory usage of two builds
+        std::string ToJson() const;
+        void WriteJson(const FS::Path& path) const;
+    };
+
+    // What a component owns on the heap, components which don't own anything use the default overload
+    template <typename T>
+    u64 GetHeapSize(const T&) { return 0; }
+
+    inline u64 GetHeapSize(const TextComponent& text) {
+        return Util::GetHeapSize(text.Contents);
+    }
+
+    template <typename T>
+    ComponentPoolStats GetPoolStats(const entt::storage<T>& pool) {
+        ComponentPoolStats stats;
+        stats.Name = ComponentTraits<T>::Name;
+        stats.ComponentSize = sizeof(T);
+
+        stats.Count = static_cast<u32>(pool.size());
+        stats.Capacity = static_cast<u32>(pool.capacity());
+        stats.SparseSlots = static_cast<u32>(pool.extent());
+
+        // NOTE: storage::capacity is the component capacity, the qualified call gets the packed entity array's one
+        stats.DenseBytes = pool.capacity() * sizeof(T) + pool.entt::sparse_set::capacity() * sizeof(entt::entity);
+        stats.SparseBytes = pool.extent() * sizeof(entt::entity);
+
+        if constexpr (!ComponentTraits<T>::TriviallyCopyable) {
+            for (const T& component : pool) {
+                stats.HeapBytes += GetHeapSize(component);
+            }
+        }
+
+        stats.DenseOccupancy = stats.Capacity ? static_cast<f32>(stats.Count) / stats.Capacity : 1.0f;
+        stats.SparseOccupancy = stats.SparseSlots ? static_cast<f32>(stats.Count) / stats.SparseSlots : 1.0f;
+
+        return stats;
+    }
+
+} // namespace Blackberry
@@ -1,84 +1,95 @@
 #include "blackberry/input/input.hpp"
 #include "blackberry/core/log.hpp"
 
-#include <unordered_map>
-
 namespace Blackberry {
 
-    struct _InputState {
-        // bool in STL can be sketchy sometimes so we use u8
-        std::unordered_map<u32, u8> CurrentKeyState;
-        std::unordered_map<u32, u8> PreviousKeyState;
-
-        std::unordered_map<u32, u8> CurrentMouseState;
-        std::unordered_map<u32, u8> PreviousMouseState;
+    static InputState s_WindowInputState;
 
-        BlVec2 CurrentMousePosition;
-        BlVec2 PreviousMousePosition;
-        f32 ScrollLevel = 0.0f;
-    };
+    // NOTE: Every thread has its own current state, so scenes on different threads can each read their own input
+    static thread_local InputState* s_CurrentInputState = nullptr; // nullptr means the window's state
 
-    static _InputState InputState;
+    // NOTE: The queries use find instead of operator[] so they never insert anything (several threads may read the window's state)
+    static bool GetState(const std::unordered_map<u32, u8>& states, u32 key) {
+        auto it = states.find(key);
+        return it != states.end() && it->second == 1;
+    }
 
     bool Input::IsKeyDown(KeyCode key) {
-        return InputState.CurrentKeyState[static_cast<u32>(key)] == 1;
+        return GetState(GetCurrentState().CurrentKeyState, static_cast<u32>(key));
     }
 
     bool Input::IsKeyPressed(KeyCode key) {
-        return InputState.CurrentKeyState[static_cast<u32>(key)] == 1 && InputState.PreviousKeyState[static_cast<u32>(key)] == 0;
+        InputState& input = GetCurrentState();
+        return GetState(input.CurrentKeyState, static_cast<u32>(key)) && !GetState(input.PreviousKeyState, static_cast<u32>(key));
     }
 
     bool Input::IsMouseDown(MouseButton key) {
-        return InputState.CurrentMouseState[static_cast<u32>(key)] == 1;
+        return GetState(GetCurrentState().CurrentMouseState, static_cast<u32>(key));
     }
 
     bool Input::IsMousePressed(MouseButton key) {
-        return InputState.CurrentMouseState[static_cast<u32>(key)] == 1 && InputState.PreviousMouseState[static_cast<u32>(key)] == 0;
+        InputState& input = GetCurrentState();
+        return GetState(input.CurrentMouseState, static_cast<u32>(key)) && !GetState(input.PreviousMouseState, static_cast<u32>(key));
     }
 
     bool Input::IsMouseReleased(MouseButton key) {
-        return InputState.CurrentMouseState[static_cast<u32>(key)] == 0 && InputState.CurrentMouseState[static_cast<u32>(key)] == 1;
+        InputState& input = GetCurrentState();
+        return !GetState(input.CurrentMouseState, static_cast<u32>(key)) && GetState(input.PreviousMouseState, static_cast<u32>(key));
     }
 
     BlVec2 Input::GetMousePosition() {
-        return InputState.CurrentMousePosition;
+        return GetCurrentState().CurrentMousePosition;
     }
 
     BlVec2 Input::GetMouseDelta() {
-        return InputState.CurrentMousePosition - InputState.PreviousMousePosition;
+        InputState& input = GetCurrentState();
+        return input.CurrentMousePosition - input.PreviousMousePosition;
     }
 
     f32 Input::GetScrollLevel() {
-        return InputState.ScrollLevel;
+        return GetCurrentState().ScrollLevel;
     }
 
     void Input::SetKeyState(KeyCode key, bool state) {
-        InputState.CurrentKeyState[static_cast<u32>(key)] = state;
+        GetCurrentState().CurrentKeyState[static_cast<u32>(key)] = state;
     }
 
     void Input::SetMouseState(MouseButton key, bool state) {
-        InputState.CurrentMouseState[static_cast<u32>(key)] = state;
+        GetCurrentState().CurrentMouseState[static_cast<u32>(key)] = state;
     }
 
     void Input::ResetKeyState() {
-        for (auto&[key, state] : InputState.CurrentKeyState) {
-            InputState.PreviousKeyState[key] = state;
+        InputState& input = GetCurrentState();
+
+        for (auto&[key, state] : input.CurrentKeyState) {
+            input.PreviousKeyState[key] = state;
         }
 
-        for (auto&[key, state] : InputState.CurrentMouseState) {
-            InputState.PreviousMouseState[key] = state;
+        for (auto&[key, state] : input.CurrentMouseState) {
+            input.PreviousMouseState[key] = state;
         }
 
-        InputState.PreviousMousePosition = InputState.CurrentMousePosition;
-        InputState.ScrollLevel = 0.0f;
+        input.PreviousMousePosition = input.CurrentMousePosition;
+        input.ScrollLevel = 0.0f;
     }
 
     void Input::SetMousePosition(BlVec2 position) {
-        InputState.CurrentMousePosition = position;
+        GetCurrentState().CurrentMousePosition = position;
     }
 
     void Input::SetScrollLevel(f32 level) {
-        InputState.ScrollLevel = level;
+        GetCurrentState().ScrollLevel = level;
+    }
+
+    InputState* Input::SetCurrentState(InputState* state) {
+        InputState* previous = s_CurrentInputState;
+        s_CurrentInputState = state;
+
+        return previous;
+    }
+
+    InputState& Input::GetCurrentState() {
+        return s_CurrentInputState ? *s_CurrentInputState : s_WindowInputState;
     }
 
 } // namespace Blackberry
\ No newline at end of file
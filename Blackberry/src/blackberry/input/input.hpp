@@ -3,8 +3,25 @@
 #include "blackberry/input/keycodes.hpp"
 #include "blackberry/input/mousebuttons.hpp"
 
+#include <unordered_map>
+
 namespace Blackberry {
 
+    // The keyboard and mouse state the Input functions read, the window writes to the global one
+    // NOTE: Headless scenes have their own, which whatever drives them (e.g. an AI or a server) writes to (see Scene::GetInputState)
+    struct InputState {
+        // bool in STL can be sketchy sometimes so we use u8
+        std::unordered_map<u32, u8> CurrentKeyState;
+        std::unordered_map<u32, u8> PreviousKeyState;
+
+        std::unordered_map<u32, u8> CurrentMouseState;
+        std::unordered_map<u32, u8> PreviousMouseState;
+
+        BlVec2 CurrentMousePosition;
+        BlVec2 PreviousMousePosition;
+        f32 ScrollLevel = 0.0f;
+    };
+
     class Input {
     public:
         static bool IsKeyDown(KeyCode key);
@@ -25,6 +42,10 @@ namespace Blackberry {
         static void SetScrollLevel(f32 level);
         static void ResetKeyState();
 
+        // Makes every function above use state on the calling thread (nullptr goes back to the window's state)
+        // Returns the state which was set before (nullptr if it was the window's), so it can be restored
+        static InputState* SetCurrentState(InputState* state);
+        static InputState& GetCurrentState();
     };
 
 } // namespace Blackberry
\ No newline at end of file
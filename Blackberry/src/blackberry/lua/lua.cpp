@@ -13,9 +13,19 @@ extern "C" {
 
 namespace Blackberry::Lua {
 
-    static std::unordered_map<std::string, u32> s_LoadedModules;
+    struct Context {
+        lua_State* State = nullptr;
+        std::unordered_map<std::string, u32> LoadedModules;
+    };
 
-    static lua_State* s_LState = nullptr;
+    static Context* s_MainContext = nullptr;
+
+    // NOTE: Every thread has its own current context, so scenes on different threads can run their scripts at the same time
+    static thread_local Context* s_Context = nullptr; // nullptr means the main context
+
+    static Context* Current() {
+        return s_Context ? s_Context : s_MainContext;
+    }
 
     static int LuaPanicFunc(lua_State* L) {
         BL_CORE_ERROR("Lua panic!");
@@ -24,101 +34,129 @@ namespace Blackberry::Lua {
     }
 
     void Initialize() {
-        s_LState = luaL_newstate();
-        luaL_openlibs(s_LState);
+        s_MainContext = CreateContext();
+    }
+
+    void Shutdown() {
+        DestroyContext(s_MainContext);
+        s_MainContext = nullptr;
+    }
+
+    Context* CreateContext() {
+        Context* context = new Context;
+
+        context->State = luaL_newstate();
+        luaL_openlibs(context->State);
 
-        lua_atpanic(s_LState, LuaPanicFunc);
+        lua_atpanic(context->State, LuaPanicFunc);
 
-        SetupApi(s_LState);
+        SetupApi(context->State);
+
+        return context;
     }
 
-    void Shutdown() {
-        if (s_LState) {
-            lua_close(s_LState);
-            s_LState = nullptr;
+    void DestroyContext(Context* context) {
+        if (!context) return;
+
+        if (s_Context == context) {
+            s_Context = nullptr;
         }
+
+        lua_close(context->State);
+        delete context;
+    }
+
+    Context* SetCurrentContext(Context* context) {
+        Context* previous = s_Context;
+        s_Context = context;
+
+        return previous;
+    }
+
+    Context* GetCurrentContext() {
+        return Current();
     }
 
     void RunFile(const FS::Path& path, const std::string& moduleName) {
         std::string strPath = path.String();
 
-        if (luaL_dofile(s_LState, strPath.c_str()) != LUA_OK) {
-            const char* errorMsg = lua_tostring(s_LState, -1);
+        if (luaL_dofile(Current()->State, strPath.c_str()) != LUA_OK) {
+            const char* errorMsg = lua_tostring(Current()->State, -1);
 
             BL_ERROR("Lua Error in file '{}': {}", strPath, errorMsg);
 
-            lua_pop(s_LState, 1); // Remove error message from stack
+            lua_pop(Current()->State, 1); // Remove error message from stack
         }
 
-        s_LoadedModules[moduleName] = luaL_ref(s_LState, LUA_REGISTRYINDEX);
+        Current()->LoadedModules[moduleName] = luaL_ref(Current()->State, LUA_REGISTRYINDEX);
     }
 
     void SetExecutionContext(const std::string& moduleName) {
-        lua_rawgeti(s_LState, LUA_REGISTRYINDEX, s_LoadedModules[moduleName]);
+        lua_rawgeti(Current()->State, LUA_REGISTRYINDEX, Current()->LoadedModules[moduleName]);
     }
 
     void NewTable() {
-        lua_newtable(s_LState);
+        lua_newtable(Current()->State);
     }
 
     void SetTable(i32 index) {
-        lua_settable(s_LState, index);
+        lua_settable(Current()->State, index);
     }
 
     void GetGlobal(const std::string& name) {
-        lua_getglobal(s_LState, name.c_str());
+        lua_getglobal(Current()->State, name.c_str());
     }
 
     void GetMember(const std::string& table, const std::string& member) {
-        lua_getglobal(s_LState, table.c_str());
-        lua_getfield(s_LState, -1, member.c_str());
+        lua_getglobal(Current()->State, table.c_str());
+        lua_getfield(Current()->State, -1, member.c_str());
     }
 
     void GetMember(const std::string& member) {
-        lua_getfield(s_LState, -1, member.c_str());
+        lua_getfield(Current()->State, -1, member.c_str());
     }
 
     i32 GetTop() {
-        return lua_gettop(s_LState);
+        return lua_gettop(Current()->State);
     }
 
     void SetField(i32 index, const std::string& name) {
-        lua_setfield(s_LState, index, name.c_str());
+        lua_setfield(Current()->State, index, name.c_str());
     }
 
     void PushBoolean(bool value) {
-        lua_pushboolean(s_LState, value);
+        lua_pushboolean(Current()->State, value);
     }
 
     void PushString(const std::string& value) {
-        lua_pushstring(s_LState, value.c_str());
+        lua_pushstring(Current()->State, value.c_str());
     }
 
     void PushNumber(f64 value) {
-        lua_pushnumber(s_LState, value);
+        lua_pushnumber(Current()->State, value);
     }
 
     void PushInteger(i64 value) {
-        lua_pushinteger(s_LState, value);
+        lua_pushinteger(Current()->State, value);
     }
 
     void PushLightUserData(void* data) {
-        lua_pushlightuserdata(s_LState, data);
+        lua_pushlightuserdata(Current()->State, data);
     }
 
     void PushValue(i32 value) {
-        lua_pushvalue(s_LState, value);
+        lua_pushvalue(Current()->State, value);
     }
 
     void PushVec2(BlVec2 vec) {
-        lua_newtable(s_LState);
-        lua_pushstring(s_LState, "x");
-        lua_pushnumber(s_LState, vec.x);
-        lua_settable(s_LState, -3);
+        lua_newtable(Current()->State);
+        lua_pushstring(Current()->State, "x");
+        lua_pushnumber(Current()->State, vec.x);
+        lua_settable(Current()->State, -3);
 
-        lua_pushstring(s_LState, "y");
-        lua_pushnumber(s_LState, vec.y);
-        lua_settable(s_LState, -3);
+        lua_pushstring(Current()->State, "y");
+        lua_pushnumber(Current()->State, vec.y);
+        lua_settable(Current()->State, -3);
     }
 
     void PushVec3(BlVec3 vec) {
@@ -132,38 +170,38 @@ namespace Blackberry::Lua {
     }
 
     void Insert(i32 index) {
-        lua_insert(s_LState, index);
+        lua_insert(Current()->State, index);
     }
 
     i64 ToInteger(i32 index) {
-        return lua_tointeger(s_LState, index);
+        return lua_tointeger(Current()->State, index);
     }
 
     f64 ToNumber(i32 index) {
-        return lua_tonumber(s_LState, index);
+        return lua_tonumber(Current()->State, index);
     }
 
     std::string ToString(i32 index) {
-        return lua_tostring(s_LState, index);
+        return lua_tostring(Current()->State, index);
     }
 
     std::string ToTypename(i32 index) {
-        return luaL_typename(s_LState, index);
+        return luaL_typename(Current()->State, index);
     }
 
     void Pop(i32 count) {
-        lua_pop(s_LState, count);
+        lua_pop(Current()->State, count);
     }
 
     void Remove(i32 index) {
-        lua_remove(s_LState, index);
+        lua_remove(Current()->State, index);
     }
 
     void CallFunction(u32 argCount, u32 returnCount) {
-        if (lua_pcall(s_LState, argCount, returnCount, 0) != LUA_OK) {
-            const char* errorMsg = lua_tostring(s_LState, -1);
+        if (lua_pcall(Current()->State, argCount, returnCount, 0) != LUA_OK) {
+            const char* errorMsg = lua_tostring(Current()->State, -1);
             BL_ERROR("Lua Error during function call: {}", errorMsg);
-            lua_pop(s_LState, 1); // Remove error message from stack
+            lua_pop(Current()->State, 1); // Remove error message from stack
         }
     }
 
@@ -172,7 +210,7 @@ namespace Blackberry::Lua {
 
         const void* previousPointer = nullptr;
         for (i32 i = 1; i <= top; i++) {
-            const void* pointer = lua_topointer(s_LState, i);
+            const void* pointer = lua_topointer(Current()->State, i);
 
             if (pointer == previousPointer) {
                 BL_CORE_WARN("Slot: {}, Type: {}, Address: {}", i, ToTypename(i), pointer);
@@ -185,11 +223,11 @@ namespace Blackberry::Lua {
     }
 
     u32 GetScriptRef(const std::string& moduleName) {
-        return s_LoadedModules.at(moduleName);
+        return Current()->LoadedModules.at(moduleName);
     }
 
     void* GetLuaState() {
-        return s_LState;
+        return Current()->State;
     }
 
 } // namespace Blackberry::Lua
\ No newline at end of file
@@ -5,9 +5,22 @@
 
 namespace Blackberry::Lua {
 
+    // Everything a script runs in (the Lua state and the modules loaded into it)
+    struct Context;
+
+    // Creates the main context (the one used on threads which didn't set their own)
     void Initialize();
     void Shutdown();
 
+    // NOTE: Contexts are completely independent, e.g. every running scene has its own (see Scene::OnRuntimeStart)
+    Context* CreateContext();
+    void DestroyContext(Context* context);
+
+    // Makes every function below use context on the calling thread (nullptr goes back to the main context)
+    // Returns the context which was set before (nullptr if it was the main one), so it can be restored
+    Context* SetCurrentContext(Context* context);
+    Context* GetCurrentContext();
+
     void RunFile(const FS::Path& path, const std::string& moduleName);
 
     void SetExecutionContext(const std::string& moduleName);
@@ -4,6 +4,8 @@
 #include "blackberry/lua/lua.hpp"
 #include "blackberry/input/input.hpp"
 
+#include <cstring>
+
 namespace Blackberry::Lua {
 
 #pragma region LogModule
@@ -103,7 +105,7 @@ namespace Blackberry::Lua {
         Entity e(scene->GetEntityFromUUID(handle), scene);
         BL_ASSERT(e.HasComponent<TransformComponent>(), "Entity does not contain transform!");
 
-        Lua::PushVec3(e.GetComponent<TransformComponent>().Position);
+        Lua::PushVec3(e.GetComponent<const TransformComponent>().Position);
 
         return 1;
     }
@@ -115,7 +117,7 @@ namespace Blackberry::Lua {
         Entity e(scene->GetEntityFromUUID(handle), scene);
         BL_ASSERT(e.HasComponent<TransformComponent>(), "Entity does not contain transform!");
 
-        Lua::PushVec3(glm::degrees(glm::eulerAngles(e.GetComponent<TransformComponent>().Rotation)));
+        Lua::PushVec3(glm::degrees(glm::eulerAngles(e.GetComponent<const TransformComponent>().Rotation)));
 
         return 1;
     }
@@ -127,7 +129,7 @@ namespace Blackberry::Lua {
         Entity e(scene->GetEntityFromUUID(handle), scene);
         BL_ASSERT(e.HasComponent<TransformComponent>(), "Entity does not contain transform!");
 
-        Lua::PushVec3(e.GetComponent<TransformComponent>().Scale);
+        Lua::PushVec3(e.GetComponent<const TransformComponent>().Scale);
 
         return 1;
     }
@@ -155,6 +157,8 @@ namespace Blackberry::Lua {
             lua_pop(L, 1);
         }
 
+        e.MarkChanged<TransformComponent>();
+
         return 0;
     }
 
@@ -185,6 +189,8 @@ namespace Blackberry::Lua {
 
         transform.Rotation = BlQuat(glm::radians(eulerRot));
 
+        e.MarkChanged<TransformComponent>();
+
         return 0;
     }
 
@@ -211,6 +217,8 @@ namespace Blackberry::Lua {
             lua_pop(L, 1);
         }
 
+        e.MarkChanged<TransformComponent>();
+
         return 0;
     }
 
@@ -225,7 +233,7 @@ namespace Blackberry::Lua {
         Entity e(scene->GetEntityFromUUID(handle), scene);
         BL_ASSERT(e.HasComponent<RigidBodyComponent>(), "Entity does not contain rigid body!");
 
-        Lua::PushString(RigidBodyTypeToString(e.GetComponent<RigidBodyComponent>().Type));
+        Lua::PushString(RigidBodyTypeToString(e.GetComponent<const RigidBodyComponent>().Type));
 
         return 1;
     }
@@ -237,7 +245,7 @@ namespace Blackberry::Lua {
         Entity e(scene->GetEntityFromUUID(handle), scene);
         BL_ASSERT(e.HasComponent<RigidBodyComponent>(), "Entity does not contain rigid body!");
 
-        Lua::PushNumber(e.GetComponent<RigidBodyComponent>().Resitution);
+        Lua::PushNumber(e.GetComponent<const RigidBodyComponent>().Resitution);
 
         return 1;
     }
@@ -249,7 +257,7 @@ namespace Blackberry::Lua {
         Entity e(scene->GetEntityFromUUID(handle), scene);
         BL_ASSERT(e.HasComponent<RigidBodyComponent>(), "Entity does not contain rigid body!");
 
-        Lua::PushNumber(e.GetComponent<RigidBodyComponent>().Friction);
+        Lua::PushNumber(e.GetComponent<const RigidBodyComponent>().Friction);
 
         return 1;
     }
@@ -277,7 +285,7 @@ namespace Blackberry::Lua {
         Entity e(scene->GetEntityFromUUID(handle), scene);
         BL_ASSERT(e.HasComponent<RigidBodyComponent>(), "Entity does not contain rigid body!");
 
-        scene->GetPhysicsEngine()->AddImpluse(e.GetComponent<RigidBodyComponent>().PhysicsBody, impulse);
+        scene->GetPhysicsEngine()->AddImpluse(e.GetComponent<const RigidBodyComponent>().PhysicsBody, impulse);
 
         return 0;
     }
@@ -305,7 +313,7 @@ namespace Blackberry::Lua {
         Entity e(scene->GetEntityFromUUID(handle), scene);
         BL_ASSERT(e.HasComponent<RigidBodyComponent>(), "Entity does not contain rigid body!");
 
-        scene->GetPhysicsEngine()->SetLinearVelocity(e.GetComponent<RigidBodyComponent>().PhysicsBody, velocity);
+        scene->GetPhysicsEngine()->SetLinearVelocity(e.GetComponent<const RigidBodyComponent>().PhysicsBody, velocity);
 
         return 0;
     }
@@ -314,13 +322,134 @@ namespace Blackberry::Lua {
 
 #pragma region EntityModule
 
+    // Calls func.template operator()<T>() for the script visible component named name, returns false if there is no such component
+    template <typename Func>
+    static bool VisitScriptComponent(const char* name, Func&& func) {
+        bool found = false;
+
+        AllComponents::ForEach([&]<typename T>() {
+            if constexpr (ComponentTraits<T>::ScriptVisible) {
+                if (!found && std::strcmp(ComponentTraits<T>::Name, name) == 0) {
+                    func.template operator()<T>();
+                    found = true;
+                }
+            }
+        });
+
+        return found;
+    }
+
+    static int WEntityHasComponent(lua_State* L) {
+        u64 handle = lua_tointeger(L, 1);
+        Scene* scene = reinterpret_cast<Scene*>(lua_touserdata(L, 2));
+        const char* componentName = luaL_checkstring(L, 3);
+
+        Entity e(scene->GetEntityFromUUID(handle), scene);
+        bool has = false;
+
+        bool exists = VisitScriptComponent(componentName, [&]<typename T>() {
+            has = e.HasComponent<T>();
+        });
+
+        if (!exists) {
+            BL_CORE_WARN("[Lua] Unknown component {}!", componentName);
+        }
+
+        Lua::PushBoolean(has);
+
+        return 1;
+    }
+
+    // NOTE: Scripts run while the scene is iterating over its entities, so structural changes go through the scene's
+    // command buffer and get applied once the scripts are done (see Scene::OnUpdateRuntime)
     static int WEntityAddComponent(lua_State* L) {
-        Entity* entity = static_cast<Entity*>(lua_touserdata(L, 1));
-        const char* componentName = lua_tostring(L, 2);
+        u64 handle = lua_tointeger(L, 1);
+        Scene* scene = reinterpret_cast<Scene*>(lua_touserdata(L, 2));
+        const char* componentName = luaL_checkstring(L, 3);
+
+        bool exists = VisitScriptComponent(componentName, [&]<typename T>() {
+            scene->GetCommandBuffer().AddComponent<T>(handle);
+        });
+
+        if (!exists) {
+            BL_CORE_WARN("[Lua] Unknown component {}!", componentName);
+        }
 
         return 0;
     }
 
+    static int WEntityCreate(lua_State* L) {
+        Scene* scene = reinterpret_cast<Scene*>(lua_touserdata(L, 1));
+        const char* name = luaL_checkstring(L, 2);
+        u64 parent = static_cast<u64>(luaL_optinteger(L, 3, 0));
+
+        Lua::PushInteger(scene->GetCommandBuffer().CreateEntity(name, parent));
+
+        return 1;
+    }
+
+    static int WEntityDestroy(lua_State* L) {
+        u64 handle = lua_tointeger(L, 1);
+        Scene* scene = reinterpret_cast<Scene*>(lua_touserdata(L, 2));
+
+        scene->GetCommandBuffer().DestroyEntity(handle);
+
+        return 0;
+    }
+
+    // Returns the handles (UUIDs) of every entity whose bounds overlap the sphere (see Scene::QuerySphere)
+    static int WEntityQuerySphere(lua_State* L) {
+        Scene* scene = reinterpret_cast<Scene*>(lua_touserdata(L, 1));
+        luaL_checktype(L, 2, LUA_TTABLE);
+        f32 radius = static_cast<f32>(luaL_checknumber(L, 3));
+
+        BlVec3 center;
+
+        lua_getfield(L, 2, "x");
+        center.x = static_cast<f32>(lua_tonumber(L, -1));
+        lua_getfield(L, 2, "y");
+        center.y = static_cast<f32>(lua_tonumber(L, -1));
+        lua_getfield(L, 2, "z");
+        center.z = static_cast<f32>(lua_tonumber(L, -1));
+        lua_pop(L, 3);
+
+        std::vector<EntityID> entities;
+        scene->QuerySphere(center, radius, entities);
+
+        lua_createtable(L, static_cast<int>(entities.size()), 0);
+
+        auto& tags = scene->GetECS()->GetPool<const TagComponent>();
+        for (u32 i = 0; i < entities.size(); i++) {
+            lua_pushinteger(L, static_cast<lua_Integer>(tags.get(entities[i]).UUID));
+            lua_rawseti(L, -2, i + 1);
+        }
+
+        return 1;
+    }
+
+    // Returns the hash of a name (see HashedString), scripts hash every name once and then only look entities up by the hash
+    static int WEntityHashName(lua_State* L) {
+        size_t length = 0;
+        const char* name = luaL_checklstring(L, 1, &length);
+
+        Lua::PushInteger(static_cast<lua_Integer>(HashedString::Hash(std::string_view(name, length))));
+
+        return 1;
+    }
+
+    // Returns the handle (UUID) of the entity with the hashed name, 0 if there is none
+    static int WEntityFindByName(lua_State* L) {
+        Scene* scene = reinterpret_cast<Scene*>(lua_touserdata(L, 1));
+        u64 hash = static_cast<u64>(luaL_checkinteger(L, 2));
+
+        EntityID entity = scene->FindEntity(HashedString::FromHash(hash));
+        u64 uuid = entity == entt::null ? 0 : scene->GetECS()->GetComponent<const TagComponent>(entity).UUID;
+
+        Lua::PushInteger(static_cast<lua_Integer>(uuid));
+
+        return 1;
+    }
+
     static luaL_Reg EntityModule[] = {
         { "GetTransformPosition", WEntityGetTransformPosition},
         { "GetTransformRotation", WEntityGetTransformRotation},
@@ -337,7 +466,16 @@ namespace Blackberry::Lua {
         { "RigidBodyAddImpulse", WEntityRigidBodyAddImpulse },
         { "RigidBodySetLinearVelocity", WEntityRigidBodySetLinearVelocity },
 
+        { "HasComponent", WEntityHasComponent },
         { "AddComponent", WEntityAddComponent },
+
+        { "Create", WEntityCreate },
+        { "Destroy", WEntityDestroy },
+
+        { "QuerySphere", WEntityQuerySphere },
+
+        { "HashName", WEntityHashName },
+        { "FindByName", WEntityFindByName },
         { nullptr, nullptr }
     };
 
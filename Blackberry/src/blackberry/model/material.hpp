@@ -36,6 +36,12 @@ namespace Blackberry {
 
         u32 ID = 0;
         bool IsDefault = false;
+
+        // Goes up every time the material gets edited, the renderer only uploads the material again when it changed
+        // NOTE: Call MarkChanged after editing any of the fields above (e.g. from an inspector)
+        u32 Version = 0;
+
+        void MarkChanged() { Version++; }
     };
 
 } // namespace Blackberry
\ No newline at end of file
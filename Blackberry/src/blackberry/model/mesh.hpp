@@ -3,6 +3,8 @@
 #include "blackberry/core/types.hpp"
 #include "blackberry/renderer/texture.hpp"
 #include "blackberry/model/material.hpp"
+#include "blackberry/scene/bounds.hpp"
+#include "blackberry/renderer/mesh_arena.hpp"
 
 namespace Blackberry {
 
@@ -17,8 +19,13 @@ namespace Blackberry {
         std::vector<BlVec2> TexCoords;
         std::vector<u32> Indices;
 
+        AABB Bounds; // box around Positions (before Transform gets applied)
+
         // NOTE: This index should NEVER be invalid, if there are no materials in a model a default one will be always be created!
         u32 MaterialIndex = 0;
+
+        // Where the mesh lives on the GPU, set once the model gets loaded (invalid if there's no GL context)
+        MeshAllocation Allocation;
     };
 
 } // namespace Blackberry
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "blackberry/core/log.hpp"
 #include "blackberry/renderer/texture.hpp"
 #include "blackberry/renderer/image.hpp"
+#include "blackberry/renderer/mesh_arena.hpp"
 
 #define CGLTF_IMPLEMENTATION
 #include "cgltf.h"
@@ -195,8 +196,12 @@ namespace Blackberry {
                 mesh.Normals.reserve(count);
                 mesh.TexCoords.reserve(count);
                 
+                mesh.Bounds = AABB::Empty();
+
                 for (u32 v = 0; v < count; v++) {
                     mesh.Positions.push_back(GLTF_Read<BlVec3>(position, v));
+                    mesh.Bounds.Min = glm::min(mesh.Bounds.Min, mesh.Positions.back());
+                    mesh.Bounds.Max = glm::max(mesh.Bounds.Max, mesh.Positions.back());
                     if (normal) {
                         mesh.Normals.push_back(GLTF_Read<BlVec3>(normal, v));
                     }
@@ -205,6 +210,10 @@ namespace Blackberry {
                     }
                 }
 
+                if (count == 0) {
+                    mesh.Bounds = AABB{};
+                }
+
                 // Indices
                 if (prim.indices) {
                     mesh.Indices.reserve(prim.indices->count);
@@ -241,6 +250,11 @@ namespace Blackberry {
             }
         }
 
+        // Uploaded once here so rendering the model never has to touch the vertices again
+        for (Mesh& mesh : model.Meshes) {
+            mesh.Allocation = MeshArena::Upload(mesh);
+        }
+
         return model;
     }
 
@@ -9,6 +9,7 @@
 #include <Jolt/Core/Factory.h>
 #include <Jolt/Core/TempAllocator.h>
 #include <Jolt/Core/JobSystemThreadPool.h>
+#include <Jolt/Core/JobSystemSingleThreaded.h>
 #include <Jolt/Physics/PhysicsSettings.h>
 #include <Jolt/Physics/PhysicsSystem.h>
 #include <Jolt/Physics/Collision/Shape/BoxShape.h>
@@ -97,7 +98,7 @@ namespace Blackberry {
         }
     };
 
-    static JPH::TempAllocatorImpl* s_TempAllocator;
+    // NOTE: Shared by every physics world which isn't single threaded (Jolt lets several worlds update on one job system at once)
     static JPH::JobSystemThreadPool* s_JobSystem;
     static BPLayerInterfaceImpl s_BroadPhaseLayerInterface;
     static ObjectVsBroadPhaseLayerFilterImpl s_ObjectVsBroadPhaseLayerFilter;
@@ -109,12 +110,13 @@ namespace Blackberry {
     static constexpr JPH::uint MAX_BODY_PAIRS = 65536;
     static constexpr JPH::uint MAX_CONTACT_CONSTRAINTS = 10240;
 
+    static constexpr JPH::uint TEMP_ALLOCATOR_SIZE = 10 * 1024 * 1024;
+
     static constexpr f32 DELTA_TIME = 1.0f / 60.0f;
 
     void PhysicsEngine::Initialize() {
         JPH::RegisterDefaultAllocator();
 
-        s_TempAllocator = new JPH::TempAllocatorImpl(10 * 1024 * 1024);
         s_JobSystem = new JPH::JobSystemThreadPool(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers, std::thread::hardware_concurrency() - 1);
 
         JPH::Factory::sInstance = new JPH::Factory(); // toilet paper factory
@@ -128,11 +130,20 @@ namespace Blackberry {
         delete JPH::Factory::sInstance;
         JPH::Factory::sInstance = nullptr;
 
-        delete s_TempAllocator;
         delete s_JobSystem;
+        s_JobSystem = nullptr;
     }
 
-    PhysicsEngine::PhysicsEngine() {
+    PhysicsEngine::PhysicsEngine(bool singleThreaded) {
+        m_TempAllocator = new JPH::TempAllocatorImpl(TEMP_ALLOCATOR_SIZE);
+
+        if (singleThreaded) {
+            m_JobSystem = new JPH::JobSystemSingleThreaded(JPH::cMaxPhysicsJobs);
+            m_OwnsJobSystem = true;
+        } else {
+            m_JobSystem = s_JobSystem;
+        }
+
         m_System = new JPH::PhysicsSystem;
         m_System->Init(MAX_BODIES, MAX_BODY_MUTEXES, MAX_BODY_PAIRS, MAX_CONTACT_CONSTRAINTS, s_BroadPhaseLayerInterface, s_ObjectVsBroadPhaseLayerFilter, s_ObjectVsObjectLayerFilter);
 
@@ -142,9 +153,18 @@ namespace Blackberry {
     PhysicsEngine::~PhysicsEngine() {
         delete m_System;
         m_System = nullptr;
+
+        if (m_OwnsJobSystem) {
+            delete m_JobSystem;
+        }
+
+        delete m_TempAllocator;
+
+        m_JobSystem = nullptr;
+        m_TempAllocator = nullptr;
     }
 
-    u32 PhysicsEngine::AddActor(u32 entity, TransformComponent& transform, RigidBodyComponent& rigidBody, BoxColliderComponent& boxCollider) {
+    u32 PhysicsEngine::AddActor(u32 entity, const TransformComponent& transform, RigidBodyComponent& rigidBody, const BoxColliderComponent& boxCollider) {
         JPH::BodyInterface& bodyInterface = m_System->GetBodyInterface();
 
         JPH::BoxShapeSettings shapeSettings(JPH::Vec3(transform.Scale.x * boxCollider.Scale.x, transform.Scale.y * boxCollider.Scale.y, transform.Scale.z * boxCollider.Scale.z));
@@ -187,7 +207,7 @@ namespace Blackberry {
         return static_cast<u32>(id.GetIndex());
     }
 
-    u32 PhysicsEngine::AddActor(u32 entity, TransformComponent& transform, RigidBodyComponent& rigidBody, SphereColliderComponent& sphereCollider) {
+    u32 PhysicsEngine::AddActor(u32 entity, const TransformComponent& transform, RigidBodyComponent& rigidBody, const SphereColliderComponent& sphereCollider) {
         JPH::BodyInterface& bodyInterface = m_System->GetBodyInterface();
 
         f32 axis = std::max(transform.Scale.x, std::max(transform.Scale.y, transform.Scale.z));
@@ -258,7 +278,7 @@ namespace Blackberry {
     }
 
     void PhysicsEngine::Step(f32 ts) {
-        m_System->Update(ts, 1, s_TempAllocator, s_JobSystem);
+        m_System->Update(ts, 1, m_TempAllocator, m_JobSystem);
 
         // Send updated transforms back
         for (auto actor : m_Actors) {
@@ -272,11 +292,12 @@ namespace Blackberry {
 
                 Scene* scene = reinterpret_cast<Scene*>(m_Scene);
 
-                Entity e(entityID, scene);
-                auto& transform = e.GetComponent<TransformComponent>();
-
-                transform.Position = BlVec3(pos.GetX(), pos.GetY(), pos.GetZ()) - reinterpret_cast<Scene*>(m_Scene)->GetEntityParentTransform(entityID).Position;
+                // The body lives in world space, so we go through the scene to convert it back into the entity's local space
+                TransformComponent transform = scene->GetEntityTransform(entityID);
+                transform.Position = BlVec3(pos.GetX(), pos.GetY(), pos.GetZ());
                 transform.Rotation = glm::normalize(BlQuat(rot.GetW(), rot.GetX(), rot.GetY(), rot.GetZ()));
+
+                scene->SetEntityWorldTransform(entityID, transform);
             }
         }
     }
@@ -285,4 +306,17 @@ namespace Blackberry {
         m_Scene = scene;
     }
 
+    void PhysicsEngine::Reset() {
+        JPH::BodyInterface& bodyInterface = m_System->GetBodyInterface();
+
+        for (auto actor : m_Actors) {
+            JPH::BodyID id = reinterpret_cast<JPH::Body*>(actor)->GetID();
+
+            bodyInterface.RemoveBody(id);
+            bodyInterface.DestroyBody(id);
+        }
+
+        m_Actors.clear();
+    }
+
 } // namespace Blackberry
\ No newline at end of file
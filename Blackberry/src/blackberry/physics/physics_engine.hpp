@@ -6,6 +6,8 @@
 namespace JPH {
 
     class PhysicsSystem;
+    class TempAllocator;
+    class JobSystem;
 
 } // namespace JPH
 
@@ -16,11 +18,13 @@ namespace Blackberry {
         static void Initialize();
         static void Shutdown();
 
-        PhysicsEngine();
+        // Single threaded physics worlds step on the calling thread instead of the shared job system,
+        // for when many worlds get stepped in parallel (see SceneSpecification::SingleThreaded)
+        PhysicsEngine(bool singleThreaded = false);
         ~PhysicsEngine();
 
-        u32 AddActor(u32 entity, TransformComponent& transform, RigidBodyComponent& rigidBody, BoxColliderComponent& boxCollider);
-        u32 AddActor(u32 entity, TransformComponent& transform, RigidBodyComponent& rigidBody, SphereColliderComponent& sphereCollider);
+        u32 AddActor(u32 entity, const TransformComponent& transform, RigidBodyComponent& rigidBody, const BoxColliderComponent& boxCollider);
+        u32 AddActor(u32 entity, const TransformComponent& transform, RigidBodyComponent& rigidBody, const SphereColliderComponent& sphereCollider);
 
         void UpdateEntity(u32 entity, TransformComponent& transform, RigidBodyComponent& rigidbody);
 
@@ -31,8 +35,14 @@ namespace Blackberry {
         void Step(f32 ts);
         void SetContext(void* scene);
 
+        // Removes and destroys every body (so the physics world can be reused for another run)
+        void Reset();
+
     private:
         JPH::PhysicsSystem* m_System = nullptr;
+        JPH::TempAllocator* m_TempAllocator = nullptr; // every world has its own, Jolt's temp allocator isn't thread safe
+        JPH::JobSystem* m_JobSystem = nullptr; // the shared one unless the world is single threaded
+        bool m_OwnsJobSystem = false;
 
         std::vector<void*> m_Actors;
         void* m_Scene = nullptr;
@@ -10,35 +10,48 @@ namespace Blackberry {
     using json = nlohmann::json;
 
     void Project::Load(const FS::Path& path) {
-        if (!FS::Exists(path)) { return; }
+        std::shared_ptr<Project> project = Open(path);
+        if (!project) { return; }
+
+        s_ActiveProject = project;
+    }
+
+    std::shared_ptr<Project> Project::Open(const FS::Path& path) {
+        if (!FS::Exists(path)) { return nullptr; }
 
         std::string contents = Util::ReadEntireFile(path);
         json j = json::parse(contents);
 
-        s_ActiveProject = std::make_shared<Project>();
+        std::shared_ptr<Project> project = std::make_shared<Project>();
 
-        s_ActiveProject->m_ProjectDirectory = path.ParentPath();
+        project->m_ProjectDirectory = path.ParentPath();
         std::string assetDir = j.at("AssetsDirectory");
-        s_ActiveProject->m_Specification.AssetPath = s_ActiveProject->m_ProjectDirectory / assetDir;
+        project->m_Specification.AssetPath = project->m_ProjectDirectory / assetDir;
 
         std::string assetRegistry = j.at("AssetRegistry");
-        s_ActiveProject->m_Specification.AssetRegistry = s_ActiveProject->m_Specification.AssetPath / assetRegistry;
-        LoadAssetRegistry(s_ActiveProject->m_Specification.AssetPath / assetRegistry);
-    
+        project->m_Specification.AssetRegistry = project->m_Specification.AssetPath / assetRegistry;
+
         std::string startScene = j.at("StartScene");
-        s_ActiveProject->m_Specification.StartScene = startScene;
+        project->m_Specification.StartScene = startScene;
+
+        project->m_ProjectPath = path;
+
+        // NOTE: Loading the assets looks up their paths through the current project, so the new one has to be current while they load
+        Project* previous = SetCurrent(project.get());
+
+        LoadAssetRegistry(project->m_Specification.AssetRegistry);
 
-        s_ActiveProject->m_ProjectPath = path;
+        SetCurrent(previous);
+
+        return project;
     }
 
     void Project::Save() {
-        BL_ASSERT(s_ActiveProject, "No active project!");
-        
         // for (auto& scene : s_ActiveProject->m_Specification.Scenes) {
         //     SaveScene(scene.Scene, scene.Path);
         // }
 
-        SaveAssetRegistry(s_ActiveProject->m_Specification.AssetRegistry);
+        SaveAssetRegistry(GetCurrent().m_Specification.AssetRegistry);
     }
 
     void Project::SaveScene(Ref<Scene> scene, const FS::Path& path) {
@@ -47,51 +60,66 @@ namespace Blackberry {
     }
 
     AssetManager& Project::LoadAssetRegistry(const FS::Path& path) {
-        BL_ASSERT(s_ActiveProject, "No active project!");
-        AssetSerializer serializer(&s_ActiveProject->m_AssetManager);
+        AssetManager& assets = GetCurrent().m_AssetManager;
+
+        AssetSerializer serializer(&assets);
         serializer.Deserialize(path);
 
-        return s_ActiveProject->m_AssetManager;
+        return assets;
     }
 
     void Project::SaveAssetRegistry(const FS::Path& path) {
-        BL_ASSERT(s_ActiveProject, "No active project!");
-        AssetSerializer serializer(&s_ActiveProject->m_AssetManager);
+        AssetSerializer serializer(&GetCurrent().m_AssetManager);
         serializer.Serialize(path);
     }
 
     FS::Path Project::GetProjectPath() {
-        BL_ASSERT(s_ActiveProject, "No active project!");
-        return s_ActiveProject->m_ProjectPath;
+        return GetCurrent().m_ProjectPath;
     }
 
     FS::Path Project::GetAssetDirecory() {
-        BL_ASSERT(s_ActiveProject, "No active project!");
-        return s_ActiveProject->m_Specification.AssetPath;
+        return GetCurrent().m_Specification.AssetPath;
     }
 
     FS::Path Project::GetAssetPath(const FS::Path& path) {
-        BL_ASSERT(s_ActiveProject, "No active project!");
         return GetAssetDirecory() / path;
     }
 
     Ref<Scene> Project::GetStartScene() {
-        BL_ASSERT(s_ActiveProject, "No active project!");
+        Project& project = GetCurrent();
 
-        BL_ASSERT(s_ActiveProject->m_AssetManager.ContainsAsset(s_ActiveProject->m_Specification.StartScene), "Project does not contain start scene!");
+        BL_ASSERT(project.m_AssetManager.ContainsAsset(project.m_Specification.StartScene), "Project does not contain start scene!");
 
-        Ref<Scene> scene = std::get<Ref<Scene>>(s_ActiveProject->m_AssetManager.GetAssetFromPath(s_ActiveProject->m_Specification.StartScene).Data);
+        Ref<Scene> scene = std::get<Ref<Scene>>(project.m_AssetManager.GetAssetFromPath(project.m_Specification.StartScene).Data);
         return scene;
     }
 
     AssetManager& Project::GetAssetManager() {
-        BL_ASSERT(s_ActiveProject, "No active project!");
-        return s_ActiveProject->m_AssetManager;
+        return GetCurrent().m_AssetManager;
     }
 
     ProjectSpecification& Project::GetSpecification() {
+        return GetCurrent().m_Specification;
+    }
+
+    std::shared_ptr<Project> Project::GetActive() {
+        return s_ActiveProject;
+    }
+
+    Project* Project::SetCurrent(Project* project) {
+        Project* previous = s_CurrentProject;
+        s_CurrentProject = project;
+
+        return previous;
+    }
+
+    Project& Project::GetCurrent() {
+        if (s_CurrentProject) {
+            return *s_CurrentProject;
+        }
+
         BL_ASSERT(s_ActiveProject, "No active project!");
-        return s_ActiveProject->m_Specification;
+        return *s_ActiveProject;
     }
 
 } // namespace Blackberry
\ No newline at end of file
@@ -20,7 +20,11 @@ namespace Blackberry {
 
     class Project {
     public:
+        // Loads the project and makes it the active one
         static void Load(const FS::Path& path);
+        // Loads a project without making it the active one (nullptr if there is no project file at path),
+        // e.g. to run scenes of several projects at once (see SceneSpecification::Project)
+        static std::shared_ptr<Project> Open(const FS::Path& path);
         static void New();
 
         static void Save();
@@ -41,6 +45,16 @@ namespace Blackberry {
 
         static ProjectSpecification& GetSpecification();
 
+        static std::shared_ptr<Project> GetActive();
+
+        // Makes every static function use project on the calling thread instead of the active one (nullptr goes back to it)
+        // NOTE: Scenes which have their own project set it while they run (see Scene::OnUpdateRuntime)
+        // Returns the project which was set before (nullptr if it was the active one), so it can be restored
+        static Project* SetCurrent(Project* project);
+
+    private:
+        static Project& GetCurrent();
+
     private:
         FS::Path m_ProjectDirectory;
         FS::Path m_ProjectPath;
@@ -48,6 +62,7 @@ namespace Blackberry {
         ProjectSpecification m_Specification;
 
         static inline std::shared_ptr<Project> s_ActiveProject;
+        static inline thread_local Project* s_CurrentProject = nullptr; // nullptr means the active project
     };
 
 } // namespace Blackberry
\ No newline at end of file
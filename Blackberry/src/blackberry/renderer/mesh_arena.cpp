@@ -0,0 +1,225 @@
+#include "blackberry/renderer/mesh_arena.hpp"
+#include "blackberry/model/mesh.hpp"
+#include "blackberry/core/log.hpp"
+#include "blackberry/core/timer.hpp"
+
+#include "glad/gl.h"
+
+#include <algorithm>
+
+namespace Blackberry {
+
+    constexpr u32 INITIAL_VERTEX_CAPACITY = 1 << 16;
+    constexpr u32 INITIAL_INDEX_CAPACITY = 1 << 18;
+
+    // A run of vertices or indices which got freed (see MeshArena::Free)
+    struct ArenaRange {
+        u32 Offset = 0;
+        u32 Count = 0;
+    };
+
+    struct MeshArenaState {
+        Ref<VertexArray> VAO;
+
+        u32 VertexCount = 0;
+        u32 VertexCapacity = 0;
+
+        u32 IndexCount = 0;
+        u32 IndexCapacity = 0;
+
+        // Sorted by offset, neighbouring ranges get merged
+        std::vector<ArenaRange> FreeVertices;
+        std::vector<ArenaRange> FreeIndices;
+    };
+
+    static MeshArenaState s_MeshArenaState;
+
+    static u32 GetGrownCapacity(u32 capacity, u32 required) {
+        while (capacity < required) {
+            capacity *= 2;
+        }
+
+        return capacity;
+    }
+
+    // Takes count elements from the first free range which is big enough, returns false if there is none
+    static bool AllocateFromFreeList(std::vector<ArenaRange>& ranges, u32 count, u32& outOffset) {
+        for (u32 i = 0; i < ranges.size(); i++) {
+            ArenaRange& range = ranges[i];
+            if (range.Count < count) continue;
+
+            outOffset = range.Offset;
+            range.Offset += count;
+            range.Count -= count;
+
+            if (range.Count == 0) {
+                ranges.erase(ranges.begin() + i);
+            }
+
+            return true;
+        }
+
+        return false;
+    }
+
+    static void AddToFreeList(std::vector<ArenaRange>& ranges, u32 offset, u32 count) {
+        auto it = std::lower_bound(ranges.begin(), ranges.end(), offset, [](const ArenaRange& range, u32 value) { return range.Offset < value; });
+        it = ranges.insert(it, { offset, count });
+
+        // Merge with the range after it, then with the one before it
+        if (it + 1 != ranges.end() && it->Offset + it->Count == (it + 1)->Offset) {
+            it->Count += (it + 1)->Count;
+            ranges.erase(it + 1);
+        }
+
+        if (it != ranges.begin() && (it - 1)->Offset + (it - 1)->Count == it->Offset) {
+            (it - 1)->Count += it->Count;
+            ranges.erase(it);
+        }
+    }
+
+    // NOTE: Creating a new buffer means the vertex layout has to be set again, it points at the buffer that was bound when it got set
+    static void SetArenaBuffers(Ref<VertexBuffer> vertices, Ref<IndexBuffer> indices) {
+        Ref<VertexArray>& vao = s_MeshArenaState.VAO;
+
+        vao->SetVertexBuffer(vertices);
+        vao->SetIndexBuffer(indices);
+        vao->SetVertexLayout({
+            {0, ShaderDataType::Float3, "Position"},
+            {1, ShaderDataType::Float3, "Normal"},
+            {2, ShaderDataType::Float2, "TexCoord"}
+        });
+    }
+
+    // Makes room for at least vertexCount more vertices and indexCount more indices, what's already uploaded stays at the same offsets
+    static void Reserve(u32 vertexCount, u32 indexCount) {
+        MeshArenaState& state = s_MeshArenaState;
+
+        u32 vertexCapacity = GetGrownCapacity(state.VertexCapacity, state.VertexCount + vertexCount);
+        u32 indexCapacity = GetGrownCapacity(state.IndexCapacity, state.IndexCount + indexCount);
+
+        if (vertexCapacity == state.VertexCapacity && indexCapacity == state.IndexCapacity) return;
+
+        BL_PROFILE_SCOPE("MeshArena::Reserve");
+
+        Ref<VertexBuffer> vertices = state.VAO->GetVertexBuffer();
+        Ref<IndexBuffer> indices = state.VAO->GetIndexBuffer();
+
+        if (vertexCapacity != state.VertexCapacity) {
+            vertices = VertexBuffer::Create(nullptr, sizeof(SceneMeshVertex), vertexCapacity, BufferUsage::Static);
+            glCopyNamedBufferSubData(state.VAO->GetVertexBuffer()->ID, vertices->ID, 0, 0, sizeof(SceneMeshVertex) * state.VertexCount);
+
+            state.VertexCapacity = vertexCapacity;
+        }
+
+        if (indexCapacity != state.IndexCapacity) {
+            indices = IndexBuffer::Create(nullptr, sizeof(u32), indexCapacity, BufferUsage::Static);
+            glCopyNamedBufferSubData(state.VAO->GetIndexBuffer()->ID, indices->ID, 0, 0, sizeof(u32) * state.IndexCount);
+
+            state.IndexCapacity = indexCapacity;
+        }
+
+        SetArenaBuffers(vertices, indices);
+
+        BL_CORE_TRACE("Grew the mesh arena to {} vertices and {} indices", state.VertexCapacity, state.IndexCapacity);
+    }
+
+    void MeshArena::Initialize() {
+        MeshArenaState& state = s_MeshArenaState;
+
+        state.VAO = VertexArray::Create();
+        state.VertexCapacity = INITIAL_VERTEX_CAPACITY;
+        state.IndexCapacity = INITIAL_INDEX_CAPACITY;
+
+        SetArenaBuffers(
+            VertexBuffer::Create(nullptr, sizeof(SceneMeshVertex), state.VertexCapacity, BufferUsage::Static),
+            IndexBuffer::Create(nullptr, sizeof(u32), state.IndexCapacity, BufferUsage::Static)
+        );
+    }
+
+    void MeshArena::Shutdown() {
+        s_MeshArenaState = MeshArenaState{};
+    }
+
+    MeshAllocation MeshArena::Upload(const Mesh& mesh) {
+        BL_PROFILE_SCOPE("MeshArena::Upload");
+
+        MeshArenaState& state = s_MeshArenaState;
+        MeshAllocation allocation;
+
+        // NOTE: Without a GL context (headless scenes, tools) there is no arena, the mesh just never gets drawn
+        if (!state.VAO || mesh.Positions.empty()) return allocation;
+
+        u32 vertexCount = static_cast<u32>(mesh.Positions.size());
+        u32 indexCount = mesh.Indices.empty() ? vertexCount : static_cast<u32>(mesh.Indices.size());
+
+        std::vector<SceneMeshVertex> vertices(vertexCount);
+        for (u32 i = 0; i < vertexCount; i++) {
+            vertices[i].Position = mesh.Positions[i];
+            vertices[i].Normal = i < mesh.Normals.size() ? mesh.Normals[i] : BlVec3(0.0f, 1.0f, 0.0f);
+            vertices[i].TexCoord = i < mesh.TexCoords.size() ? mesh.TexCoords[i] : BlVec2(0.0f);
+        }
+
+        std::vector<u32> generatedIndices;
+        const u32* indices = mesh.Indices.data();
+
+        if (mesh.Indices.empty()) {
+            generatedIndices.resize(indexCount);
+            for (u32 i = 0; i < indexCount; i++) {
+                generatedIndices[i] = i;
+            }
+
+            indices = generatedIndices.data();
+        }
+
+        // Freed room gets used first, the buffers only grow for what doesn't fit into it
+        bool reuseVertices = AllocateFromFreeList(state.FreeVertices, vertexCount, allocation.BaseVertex);
+        bool reuseIndices = AllocateFromFreeList(state.FreeIndices, indexCount, allocation.FirstIndex);
+
+        Reserve(reuseVertices ? 0 : vertexCount, reuseIndices ? 0 : indexCount);
+
+        if (!reuseVertices) {
+            allocation.BaseVertex = state.VertexCount;
+            state.VertexCount += vertexCount;
+        }
+
+        if (!reuseIndices) {
+            allocation.FirstIndex = state.IndexCount;
+            state.IndexCount += indexCount;
+        }
+
+        allocation.VertexCount = vertexCount;
+        allocation.IndexCount = indexCount;
+
+        glNamedBufferSubData(state.VAO->GetVertexBuffer()->ID, sizeof(SceneMeshVertex) * allocation.BaseVertex, sizeof(SceneMeshVertex) * vertexCount, vertices.data());
+        glNamedBufferSubData(state.VAO->GetIndexBuffer()->ID, sizeof(u32) * allocation.FirstIndex, sizeof(u32) * indexCount, indices);
+
+        return allocation;
+    }
+
+    void MeshArena::Free(const MeshAllocation& allocation) {
+        MeshArenaState& state = s_MeshArenaState;
+
+        if (!state.VAO || !allocation.IsValid()) return;
+
+        AddToFreeList(state.FreeVertices, allocation.BaseVertex, allocation.VertexCount);
+        AddToFreeList(state.FreeIndices, allocation.FirstIndex, allocation.IndexCount);
+    }
+
+    Ref<VertexArray>& MeshArena::GetVertexArray() {
+        return s_MeshArenaState.VAO;
+    }
+
+    u32 MeshArena::GetVertexCount() {
+        return s_MeshArenaState.VertexCount;
+    }
+
+    u32 MeshArena::GetIndexCount() {
+        return s_MeshArenaState.IndexCount;
+    }
+
+    u64 MeshArena::GetMemorySize() {
+        return static_cast<u64>(s_MeshArenaState.VertexCapacity) * sizeof(SceneMeshVertex) + static_cast<u64>(s_MeshArenaState.IndexCapacity) * sizeof(u32);
+    }
+
+} // namespace Blackberry
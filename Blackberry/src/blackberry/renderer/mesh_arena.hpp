@@ -0,0 +1,50 @@
+#pragma once
+
+#include "blackberry/core/types.hpp"
+#include "blackberry/renderer/vertex_buffer.hpp"
+
+namespace Blackberry {
+
+    struct Mesh;
+
+    struct SceneMeshVertex {
+        BlVec3 Position;
+        BlVec3 Normal;
+        BlVec2 TexCoord;
+    };
+
+    // Where a mesh's vertices and indices live inside the MeshArena
+    struct MeshAllocation {
+        u32 BaseVertex = 0; // added to every index
+        u32 FirstIndex = 0;
+        u32 IndexCount = 0;
+        u32 VertexCount = 0;
+
+        bool IsValid() const { return IndexCount != 0; }
+    };
+
+    // One vertex and one index buffer which every model's meshes get interleaved into and uploaded to once (when the model
+    // gets loaded, see Model::Create), so drawing a mesh only takes its offsets and the per instance data
+    // NOTE: Allocations never move (growing copies the buffers on the GPU), freed ones get reused by the next uploads that fit
+    // (e.g. when a model gets unloaded and loaded again, see AssetManager::UnloadAsset), the buffers never shrink
+    class MeshArena {
+    public:
+        static void Initialize();
+        static void Shutdown();
+
+        // Meshes without indices get drawn as a plain triangle list (the indices get generated)
+        static MeshAllocation Upload(const Mesh& mesh);
+        // NOTE: Nothing may draw the allocation afterwards
+        static void Free(const MeshAllocation& allocation);
+
+        // Has every uploaded mesh in it, draw one with RendererAPI::DrawIndexedInstanced (or DrawIndexedIndirect) and the mesh's allocation
+        static Ref<VertexArray>& GetVertexArray();
+
+        // NOTE: Includes the freed vertices and indices which haven't been reused yet
+        static u32 GetVertexCount();
+        static u32 GetIndexCount();
+        // What the buffers take up on the GPU (including the room they haven't used yet)
+        static u64 GetMemorySize();
+    };
+
+} // namespace Blackberry
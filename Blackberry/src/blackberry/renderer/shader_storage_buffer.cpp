@@ -25,6 +25,18 @@ namespace Blackberry {
         glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
     }
 
+    void ShaderStorageBuffer::UpdateMemory(u32 offset, u32 size, const void* data) {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, ID);
+
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), data);
+
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+
+    void ShaderStorageBuffer::Bind() const {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, Binding, ID);
+    }
+
     void* ShaderStorageBuffer::MapMemory() const {
         glBindBuffer(GL_SHADER_STORAGE_BUFFER, ID);
 
@@ -8,6 +8,10 @@ namespace Blackberry {
         [[nodiscard]] static ShaderStorageBuffer Create(u32 binding);
 
         void ReserveMemory(u32 size, void* data = nullptr);
+        // Writes data into memory that was already reserved (size bytes starting at offset)
+        void UpdateMemory(u32 offset, u32 size, const void* data);
+        // Binds the buffer to its binding again (e.g. when another buffer used the same binding)
+        void Bind() const;
         
         void* MapMemory() const;
         void UnMapMemory() const;
@@ -0,0 +1,286 @@
+#include "blackberry/scene/bounding_volume_hierarchy.hpp"
+#include "blackberry/core/util.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+namespace Blackberry {
+
+    // How much bigger a leaf's box is than the real bounds (so small movements don't have to touch the tree)
+    static constexpr f32 s_FatMargin = 0.1f;
+
+    static AABB Fatten(const AABB& bounds) {
+        return { bounds.Min - BlVec3(s_FatMargin), bounds.Max + BlVec3(s_FatMargin) };
+    }
+
+    BoundingVolumeHierarchy::BoundingVolumeHierarchy() {
+        m_Nodes.reserve(64);
+    }
+
+    i32 BoundingVolumeHierarchy::CreateProxy(const AABB& bounds, EntityID entity) {
+        i32 proxy = AllocateNode();
+
+        Node& node = m_Nodes[proxy];
+        node.Bounds = Fatten(bounds);
+        node.Entity = entity;
+        node.Height = 0;
+
+        InsertLeaf(proxy);
+        m_ProxyCount++;
+
+        return proxy;
+    }
+
+    void BoundingVolumeHierarchy::DestroyProxy(i32 proxy) {
+        BL_ASSERT(proxy >= 0 && proxy < static_cast<i32>(m_Nodes.size()) && m_Nodes[proxy].IsLeaf(), "Invalid proxy {}!", proxy);
+
+        RemoveLeaf(proxy);
+        FreeNode(proxy);
+        m_ProxyCount--;
+    }
+
+    bool BoundingVolumeHierarchy::MoveProxy(i32 proxy, const AABB& bounds) {
+        BL_ASSERT(proxy >= 0 && proxy < static_cast<i32>(m_Nodes.size()) && m_Nodes[proxy].IsLeaf(), "Invalid proxy {}!", proxy);
+
+        AABB& fat = m_Nodes[proxy].Bounds;
+
+        // Still fits, but shrink the box if the entity got a lot smaller (otherwise it would stay huge forever)
+        if (fat.Contains(bounds) && fat.GetSurfaceArea() <= Fatten(bounds).GetSurfaceArea() * 4.0f) {
+            return false;
+        }
+
+        RemoveLeaf(proxy);
+        m_Nodes[proxy].Bounds = Fatten(bounds);
+        InsertLeaf(proxy);
+
+        return true;
+    }
+
+    void BoundingVolumeHierarchy::Clear() {
+        m_Nodes.clear();
+        m_Root = s_NullNode;
+        m_FreeList = s_NullNode;
+        m_ProxyCount = 0;
+    }
+
+    bool BoundingVolumeHierarchy::Validate() const {
+        u32 leafCount = 0;
+        if (ValidateSubtree(m_Root, s_NullNode, leafCount) < 0) return false;
+
+        return leafCount == m_ProxyCount;
+    }
+
+    i32 BoundingVolumeHierarchy::AllocateNode() {
+        if (m_FreeList == s_NullNode) {
+            m_Nodes.emplace_back();
+            return static_cast<i32>(m_Nodes.size() - 1);
+        }
+
+        i32 node = m_FreeList;
+        m_FreeList = m_Nodes[node].Parent;
+
+        m_Nodes[node] = Node{};
+
+        return node;
+    }
+
+    void BoundingVolumeHierarchy::FreeNode(i32 node) {
+        m_Nodes[node].Parent = m_FreeList;
+        m_Nodes[node].Child1 = s_NullNode;
+        m_Nodes[node].Child2 = s_NullNode;
+        m_Nodes[node].Entity = entt::null;
+        m_Nodes[node].Height = -1;
+
+        m_FreeList = node;
+    }
+
+    void BoundingVolumeHierarchy::InsertLeaf(i32 leaf) {
+        if (m_Root == s_NullNode) {
+            m_Root = leaf;
+            m_Nodes[leaf].Parent = s_NullNode;
+
+            return;
+        }
+
+        const AABB leafBounds = m_Nodes[leaf].Bounds;
+
+        // Walk down to the best sibling using the surface area heuristic (the cost of a subtree is the surface area of its nodes)
+        i32 index = m_Root;
+        while (!m_Nodes[index].IsLeaf()) {
+            const Node& node = m_Nodes[index];
+
+            f32 area = node.Bounds.GetSurfaceArea();
+            f32 combinedArea = AABB::Merge(node.Bounds, leafBounds).GetSurfaceArea();
+
+            f32 cost = 2.0f * combinedArea; // cost of making a new parent for this node and the leaf
+            f32 inheritanceCost = 2.0f * (combinedArea - area); // minimum cost of pushing the leaf further down
+
+            auto childCost = [&](i32 child) {
+                const Node& childNode = m_Nodes[child];
+                f32 merged = AABB::Merge(leafBounds, childNode.Bounds).GetSurfaceArea();
+
+                if (childNode.IsLeaf()) {
+                    return merged + inheritanceCost;
+                }
+
+                return (merged - childNode.Bounds.GetSurfaceArea()) + inheritanceCost;
+            };
+
+            f32 cost1 = childCost(node.Child1);
+            f32 cost2 = childCost(node.Child2);
+
+            if (cost < cost1 && cost < cost2) break;
+
+            index = cost1 < cost2 ? node.Child1 : node.Child2;
+        }
+
+        i32 sibling = index;
+
+        // Make a new parent for the sibling and the leaf
+        i32 oldParent = m_Nodes[sibling].Parent;
+        i32 newParent = AllocateNode(); // NOTE: May reallocate m_Nodes, so no references are held across this
+
+        m_Nodes[newParent].Parent = oldParent;
+        m_Nodes[newParent].Bounds = AABB::Merge(leafBounds, m_Nodes[sibling].Bounds);
+        m_Nodes[newParent].Height = m_Nodes[sibling].Height + 1;
+        m_Nodes[newParent].Child1 = sibling;
+        m_Nodes[newParent].Child2 = leaf;
+
+        m_Nodes[sibling].Parent = newParent;
+        m_Nodes[leaf].Parent = newParent;
+
+        if (oldParent == s_NullNode) {
+            m_Root = newParent;
+        } else if (m_Nodes[oldParent].Child1 == sibling) {
+            m_Nodes[oldParent].Child1 = newParent;
+        } else {
+            m_Nodes[oldParent].Child2 = newParent;
+        }
+
+        Refit(m_Nodes[leaf].Parent);
+    }
+
+    void BoundingVolumeHierarchy::RemoveLeaf(i32 leaf) {
+        if (leaf == m_Root) {
+            m_Root = s_NullNode;
+            return;
+        }
+
+        i32 parent = m_Nodes[leaf].Parent;
+        i32 grandParent = m_Nodes[parent].Parent;
+        i32 sibling = m_Nodes[parent].Child1 == leaf ? m_Nodes[parent].Child2 : m_Nodes[parent].Child1;
+
+        // The sibling takes the parent's place
+        if (grandParent == s_NullNode) {
+            m_Root = sibling;
+            m_Nodes[sibling].Parent = s_NullNode;
+        } else {
+            if (m_Nodes[grandParent].Child1 == parent) {
+                m_Nodes[grandParent].Child1 = sibling;
+            } else {
+                m_Nodes[grandParent].Child2 = sibling;
+            }
+
+            m_Nodes[sibling].Parent = grandParent;
+
+            Refit(grandParent);
+        }
+
+        FreeNode(parent);
+        m_Nodes[leaf].Parent = s_NullNode;
+    }
+
+    void BoundingVolumeHierarchy::Refit(i32 index) {
+        while (index != s_NullNode) {
+            index = Balance(index);
+
+            Node& node = m_Nodes[index];
+            const Node& child1 = m_Nodes[node.Child1];
+            const Node& child2 = m_Nodes[node.Child2];
+
+            node.Height = 1 + std::max(child1.Height, child2.Height);
+            node.Bounds = AABB::Merge(child1.Bounds, child2.Bounds);
+
+            index = node.Parent;
+        }
+    }
+
+    // If a's children differ in height by more than one, the taller child gets rotated up into a's place
+    // (its taller child stays, the shorter one swaps places with a). Returns the node which is now where a used to be
+    i32 BoundingVolumeHierarchy::Balance(i32 a) {
+        if (m_Nodes[a].IsLeaf() || m_Nodes[a].Height < 2) return a;
+
+        i32 b = m_Nodes[a].Child1;
+        i32 c = m_Nodes[a].Child2;
+
+        i32 balance = m_Nodes[c].Height - m_Nodes[b].Height;
+        if (balance >= -1 && balance <= 1) return a;
+
+        // up is the taller child of a, which moves up into a's place (the other child stays with a)
+        i32 up = balance > 1 ? c : b;
+
+        i32 f = m_Nodes[up].Child1;
+        i32 g = m_Nodes[up].Child2;
+
+        // Swap a and up
+        m_Nodes[up].Child1 = a;
+        m_Nodes[up].Parent = m_Nodes[a].Parent;
+        m_Nodes[a].Parent = up;
+
+        if (m_Nodes[up].Parent == s_NullNode) {
+            m_Root = up;
+        } else if (m_Nodes[m_Nodes[up].Parent].Child1 == a) {
+            m_Nodes[m_Nodes[up].Parent].Child1 = up;
+        } else {
+            m_Nodes[m_Nodes[up].Parent].Child2 = up;
+        }
+
+        // The taller grandchild stays with up, the shorter one goes to a
+        i32 keep = m_Nodes[f].Height > m_Nodes[g].Height ? f : g;
+        i32 give = keep == f ? g : f;
+
+        m_Nodes[up].Child2 = keep;
+
+        if (balance > 1) {
+            m_Nodes[a].Child2 = give;
+        } else {
+            m_Nodes[a].Child1 = give;
+        }
+        m_Nodes[give].Parent = a;
+
+        Node& nodeA = m_Nodes[a];
+        nodeA.Bounds = AABB::Merge(m_Nodes[nodeA.Child1].Bounds, m_Nodes[nodeA.Child2].Bounds);
+        nodeA.Height = 1 + std::max(m_Nodes[nodeA.Child1].Height, m_Nodes[nodeA.Child2].Height);
+
+        Node& nodeUp = m_Nodes[up];
+        nodeUp.Bounds = AABB::Merge(m_Nodes[nodeUp.Child1].Bounds, m_Nodes[nodeUp.Child2].Bounds);
+        nodeUp.Height = 1 + std::max(m_Nodes[nodeUp.Child1].Height, m_Nodes[nodeUp.Child2].Height);
+
+        return up;
+    }
+
+    // Returns the height of the subtree (-1 if something is wrong)
+    i32 BoundingVolumeHierarchy::ValidateSubtree(i32 index, i32 parent, u32& leafCount) const {
+        if (index == s_NullNode) return 0;
+
+        const Node& node = m_Nodes[index];
+        if (node.Parent != parent || node.Height < 0) return -1;
+
+        if (node.IsLeaf()) {
+            if (node.Child2 != s_NullNode || node.Height != 0) return -1;
+
+            leafCount++;
+            return 0;
+        }
+
+        i32 height1 = ValidateSubtree(node.Child1, index, leafCount);
+        i32 height2 = ValidateSubtree(node.Child2, index, leafCount);
+        if (height1 < 0 || height2 < 0) return -1;
+
+        if (node.Height != 1 + std::max(height1, height2)) return -1;
+        if (!node.Bounds.Contains(AABB::Merge(m_Nodes[node.Child1].Bounds, m_Nodes[node.Child2].Bounds))) return -1;
+
+        return node.Height;
+    }
+
+} // namespace Blackberry
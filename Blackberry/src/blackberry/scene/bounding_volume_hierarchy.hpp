@@ -0,0 +1,191 @@
+#pragma once
+
+#include "blackberry/core/types.hpp"
+#include "blackberry/ecs/ecs.hpp"
+#include "blackberry/scene/bounds.hpp"
+
+#include <vector>
+
+namespace Blackberry {
+
+    // Dynamic AABB tree over entities (used by Scene for culling, picking and proximity queries)
+    //
+    // Every entity is a leaf ("proxy") whose box is slightly bigger than the entity's real bounds,
+    // so small movements don't touch the tree at all. Once an entity leaves its box it gets reinserted
+    // (which refits all of its old and new ancestors) and the tree gets rebalanced with AVL style rotations on the way up
+    //
+    // NOTE: Nodes live in one array and refer to each other by index, so copying the tree is just copying the array.
+    // Queries don't modify anything, so they can run on multiple threads as long as nobody moves proxies at the same time
+    class BoundingVolumeHierarchy {
+    public:
+        static constexpr i32 s_NullNode = -1;
+
+        struct Node {
+            AABB Bounds; // fat bounds for leaves
+            EntityID Entity = entt::null; // only set for leaves
+
+            i32 Parent = s_NullNode; // next free node while the node is on the free list
+            i32 Child1 = s_NullNode;
+            i32 Child2 = s_NullNode;
+
+            i32 Height = 0; // 0 for leaves, -1 for free nodes
+
+            bool IsLeaf() const { return Child1 == s_NullNode; }
+        };
+
+    public:
+        BoundingVolumeHierarchy();
+
+        // Returns the proxy id (stable until the proxy gets destroyed)
+        i32 CreateProxy(const AABB& bounds, EntityID entity);
+        void DestroyProxy(i32 proxy);
+
+        // Returns true if the proxy had to be reinserted (false if the bounds still fit into its fat box)
+        bool MoveProxy(i32 proxy, const AABB& bounds);
+
+        void Clear();
+
+        EntityID GetEntity(i32 proxy) const { return m_Nodes[proxy].Entity; }
+        const AABB& GetFatBounds(i32 proxy) const { return m_Nodes[proxy].Bounds; }
+
+        u32 GetProxyCount() const { return m_ProxyCount; }
+        i32 GetHeight() const { return m_Root == s_NullNode ? 0 : m_Nodes[m_Root].Height; }
+
+        // Calls func(EntityID) for every proxy overlapping the box, return false from func to stop early
+        template <typename Func>
+        void QueryBox(const AABB& box, Func&& func) const {
+            Traverse([&](const AABB& bounds) { return box.Overlaps(bounds); }, func);
+        }
+
+        template <typename Func>
+        void QuerySphere(const BlVec3& center, f32 radius, Func&& func) const {
+            Traverse([&](const AABB& bounds) { return bounds.OverlapsSphere(center, radius); }, func);
+        }
+
+        // NOTE: Subtrees which are completely inside the frustum get reported without testing any of their children
+        template <typename Func>
+        void QueryFrustum(const Frustum& frustum, Func&& func) const {
+            if (m_Root == s_NullNode) return;
+
+            std::vector<i32> stack;
+            stack.reserve(64);
+            stack.push_back(m_Root);
+
+            while (!stack.empty()) {
+                const Node& node = m_Nodes[stack.back()];
+                stack.pop_back();
+
+                Frustum::Containment containment = frustum.Classify(node.Bounds);
+                if (containment == Frustum::Containment::Outside) continue;
+
+                if (containment == Frustum::Containment::Inside) {
+                    if (!ReportSubtree(node, func)) break;
+                    continue;
+                }
+
+                if (node.IsLeaf()) {
+                    if (!func(node.Entity)) break;
+                } else {
+                    stack.push_back(node.Child1);
+                    stack.push_back(node.Child2);
+                }
+            }
+        }
+
+        // Calls func(EntityID, f32 distance) for every proxy the ray hits within maxDistance (in no particular order),
+        // func returns the new max distance (e.g. the distance it got to only look for closer hits, 0 to stop)
+        // NOTE: Only the (fat) boxes get tested, func has to do any exact tests itself
+        template <typename Func>
+        void Raycast(const Ray& ray, f32 maxDistance, Func&& func) const {
+            if (m_Root == s_NullNode) return;
+
+            std::vector<i32> stack;
+            stack.reserve(64);
+            stack.push_back(m_Root);
+
+            while (!stack.empty()) {
+                const Node& node = m_Nodes[stack.back()];
+                stack.pop_back();
+
+                f32 distance = 0.0f;
+                if (!ray.Intersects(node.Bounds, maxDistance, &distance)) continue;
+
+                if (node.IsLeaf()) {
+                    maxDistance = func(node.Entity, distance);
+                    if (maxDistance <= 0.0f) break;
+                } else {
+                    stack.push_back(node.Child1);
+                    stack.push_back(node.Child2);
+                }
+            }
+        }
+
+        // Checks every invariant of the tree (only meant for debugging)
+        bool Validate() const;
+
+    private:
+        template <typename Test, typename Func>
+        void Traverse(Test&& test, Func&& func) const {
+            if (m_Root == s_NullNode) return;
+
+            std::vector<i32> stack;
+            stack.reserve(64);
+            stack.push_back(m_Root);
+
+            while (!stack.empty()) {
+                const Node& node = m_Nodes[stack.back()];
+                stack.pop_back();
+
+                if (!test(node.Bounds)) continue;
+
+                if (node.IsLeaf()) {
+                    if (!func(node.Entity)) break;
+                } else {
+                    stack.push_back(node.Child1);
+                    stack.push_back(node.Child2);
+                }
+            }
+        }
+
+        // Reports every leaf below node, returns false if func asked to stop
+        template <typename Func>
+        bool ReportSubtree(const Node& root, Func&& func) const {
+            if (root.IsLeaf()) return func(root.Entity);
+
+            std::vector<i32> stack = { root.Child1, root.Child2 };
+
+            while (!stack.empty()) {
+                const Node& node = m_Nodes[stack.back()];
+                stack.pop_back();
+
+                if (node.IsLeaf()) {
+                    if (!func(node.Entity)) return false;
+                } else {
+                    stack.push_back(node.Child1);
+                    stack.push_back(node.Child2);
+                }
+            }
+
+            return true;
+        }
+
+        i32 AllocateNode();
+        void FreeNode(i32 node);
+
+        void InsertLeaf(i32 leaf);
+        void RemoveLeaf(i32 leaf);
+
+        // Recomputes the bounds/heights from node up to the root (rotating unbalanced nodes on the way)
+        void Refit(i32 node);
+        i32 Balance(i32 node);
+
+        i32 ValidateSubtree(i32 node, i32 parent, u32& leafCount) const;
+
+    private:
+        std::vector<Node> m_Nodes;
+        i32 m_Root = s_NullNode;
+        i32 m_FreeList = s_NullNode;
+        u32 m_ProxyCount = 0;
+    };
+
+} // namespace Blackberry
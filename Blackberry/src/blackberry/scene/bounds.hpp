@@ -0,0 +1,172 @@
+#pragma once
+
+#include "blackberry/core/types.hpp"
+
+#include "glm/glm.hpp"
+
+#include <array>
+#include <limits>
+
+namespace Blackberry {
+
+    // Axis aligned bounding box
+    struct AABB {
+        BlVec3 Min = BlVec3(0.0f);
+        BlVec3 Max = BlVec3(0.0f);
+
+        // An "inverted" box which grows to exactly the first thing merged into it
+        static AABB Empty() {
+            constexpr f32 max = std::numeric_limits<f32>::max();
+            return { BlVec3(max), BlVec3(-max) };
+        }
+
+        static AABB FromCenter(const BlVec3& center, const BlVec3& halfExtents) {
+            return { center - halfExtents, center + halfExtents };
+        }
+
+        bool IsValid() const {
+            return Min.x <= Max.x && Min.y <= Max.y && Min.z <= Max.z;
+        }
+
+        BlVec3 GetCenter() const { return (Min + Max) * 0.5f; }
+        BlVec3 GetExtents() const { return (Max - Min) * 0.5f; }
+
+        // Used by the BVH to decide where to insert things (smaller is better)
+        f32 GetSurfaceArea() const {
+            BlVec3 size = Max - Min;
+            return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+        }
+
+        void Merge(const AABB& other) {
+            Min = glm::min(Min, other.Min);
+            Max = glm::max(Max, other.Max);
+        }
+
+        static AABB Merge(const AABB& a, const AABB& b) {
+            return { glm::min(a.Min, b.Min), glm::max(a.Max, b.Max) };
+        }
+
+        bool Contains(const AABB& other) const {
+            return glm::all(glm::lessThanEqual(Min, other.Min)) && glm::all(glm::greaterThanEqual(Max, other.Max));
+        }
+
+        bool Overlaps(const AABB& other) const {
+            return glm::all(glm::lessThanEqual(Min, other.Max)) && glm::all(glm::greaterThanEqual(Max, other.Min));
+        }
+
+        bool OverlapsSphere(const BlVec3& center, f32 radius) const {
+            BlVec3 closest = glm::clamp(center, Min, Max);
+            BlVec3 delta = closest - center;
+            return glm::dot(delta, delta) <= radius * radius;
+        }
+
+        // Returns the box containing this box after it got transformed by matrix (the box of the transformed box, not the tightest fit)
+        AABB Transform(const BlMat4& matrix) const {
+            BlVec3 center = BlVec3(matrix * BlVec4(GetCenter(), 1.0f));
+            BlVec3 extents = GetExtents();
+
+            // Every axis of the new box is the sum of the absolute contributions of the old axes (Arvo's method)
+            glm::mat3 absolute = glm::mat3(glm::abs(BlVec3(matrix[0])), glm::abs(BlVec3(matrix[1])), glm::abs(BlVec3(matrix[2])));
+
+            return FromCenter(center, absolute * extents);
+        }
+    };
+
+    struct Ray {
+        BlVec3 Origin = BlVec3(0.0f);
+        BlVec3 Direction = BlVec3(0.0f, 0.0f, -1.0f); // NOTE: Doesn't have to be normalized, hit distances are in multiples of it
+
+        // Slab test, returns the distance along the ray where it enters the box (0 if it starts inside)
+        // NOTE: Returns false if the box is behind the ray or further away than maxDistance
+        bool Intersects(const AABB& box, f32 maxDistance, f32* distance = nullptr, f32* exitDistance = nullptr) const {
+            BlVec3 inverse = 1.0f / Direction;
+
+            BlVec3 t0 = (box.Min - Origin) * inverse;
+            BlVec3 t1 = (box.Max - Origin) * inverse;
+
+            // NOTE: Not called near/far since windows.h defines those as macros
+            BlVec3 closer = glm::min(t0, t1);
+            BlVec3 further = glm::max(t0, t1);
+
+            f32 enter = glm::max(glm::max(closer.x, closer.y), glm::max(closer.z, 0.0f));
+            f32 exit = glm::min(glm::min(further.x, further.y), glm::min(further.z, maxDistance));
+
+            if (enter > exit) return false;
+
+            if (distance) *distance = enter;
+            if (exitDistance) *exitDistance = exit;
+
+            return true;
+        }
+    };
+
+    // The 6 planes of a camera's view volume (pointing inwards)
+    struct Frustum {
+        std::array<BlVec4, 6> Planes; // xyz is the normal, w the distance (a point p is inside if dot(normal, p) + w >= 0)
+
+        // Extracts the planes from a projection * view matrix (Gribb/Hartmann)
+        static Frustum FromMatrix(const BlMat4& viewProjection) {
+            BlMat4 m = glm::transpose(viewProjection);
+
+            Frustum frustum;
+            frustum.Planes[0] = m[3] + m[0]; // left
+            frustum.Planes[1] = m[3] - m[0]; // right
+            frustum.Planes[2] = m[3] + m[1]; // bottom
+            frustum.Planes[3] = m[3] - m[1]; // top
+            frustum.Planes[4] = m[3] + m[2]; // near
+            frustum.Planes[5] = m[3] - m[2]; // far
+
+            for (BlVec4& plane : frustum.Planes) {
+                plane /= glm::length(BlVec3(plane));
+            }
+
+            return frustum;
+        }
+
+        enum class Containment { Outside, Intersects, Inside };
+
+        Containment Classify(const AABB& box) const {
+            BlVec3 center = box.GetCenter();
+            BlVec3 extents = box.GetExtents();
+
+            Containment result = Containment::Inside;
+
+            for (const BlVec4& plane : Planes) {
+                BlVec3 normal = BlVec3(plane);
+
+                f32 distance = glm::dot(normal, center) + plane.w;
+                f32 radius = glm::dot(glm::abs(normal), extents); // how far the box reaches towards the plane
+
+                if (distance < -radius) return Containment::Outside;
+                if (distance < radius) result = Containment::Intersects;
+            }
+
+            return result;
+        }
+
+        bool Overlaps(const AABB& box) const {
+            return Classify(box) != Containment::Outside;
+        }
+
+        // Tests an infinite cone (e.g. a spot light, those don't have a range), halfAngle is in radians
+        // NOTE: The cone is outside once its apex is behind a plane and every direction in it points further away from the plane
+        bool OverlapsCone(const BlVec3& apex, const BlVec3& direction, f32 halfAngle) const {
+            f32 length = glm::length(direction);
+            if (length == 0.0f || halfAngle >= glm::radians(90.0f)) return true; // points everywhere (or a whole half space)
+
+            BlVec3 axis = direction / length;
+            f32 sinHalfAngle = glm::sin(halfAngle);
+
+            for (const BlVec4& plane : Planes) {
+                BlVec3 normal = BlVec3(plane);
+
+                // The direction in the cone closest to the normal is halfAngle closer to it than the axis,
+                // so nothing in the cone turns towards the plane if the axis is at least 90 degrees + halfAngle away from the normal
+                if (glm::dot(normal, apex) + plane.w < 0.0f && glm::dot(normal, axis) <= -sinHalfAngle) return false;
+            }
+
+            return true;
+        }
+    };
+
+} // namespace Blackberry
@@ -26,6 +26,12 @@ namespace Blackberry {
             return EntityScene->m_ECS->GetComponent<T>(ID);
         }
 
+        // NOTE: Call this after writing to a tracked component through GetComponent (see ECS::MarkChanged)
+        template <typename T>
+        void MarkChanged() {
+            EntityScene->m_ECS->MarkChanged<T>(ID);
+        }
+
         template <typename T>
         void RemoveComponent() {
             EntityScene->m_ECS->RemoveComponent<T>(ID);
@@ -0,0 +1,100 @@
+#include "blackberry/scene/entity_command_buffer.hpp"
+#include "blackberry/scene/scene.hpp"
+#include "blackberry/core/timer.hpp"
+
+namespace Blackberry {
+
+    u64 EntityCommandBuffer::CreateEntity(const std::string& name, u64 parent) {
+        u64 uuid = UUID();
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        m_Commands.push_back([uuid, name, parent](Scene* scene) {
+            scene->CreateEntityWithUUID(uuid);
+            scene->SetEntityName(uuid, name);
+
+            if (parent != 0 && scene->m_EntityMap.Contains(parent)) {
+                scene->SetEntityParent(uuid, parent);
+            }
+
+            scene->FinishEntityEdit(uuid);
+        });
+        m_CreatedEntityCount++;
+
+        return uuid;
+    }
+
+    void EntityCommandBuffer::DestroyEntity(u64 uuid) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        m_DestroyedEntities.push_back(uuid);
+    }
+
+    void EntityCommandBuffer::SetEntityParent(u64 uuid, u64 parent) {
+        Record([uuid, parent](Scene* scene) {
+            if (!scene->m_EntityMap.Contains(uuid)) return;
+            if (parent != 0 && !scene->m_EntityMap.Contains(parent)) return;
+
+            scene->SetEntityParent(uuid, parent);
+            scene->FinishEntityEdit(uuid);
+        });
+    }
+
+    void EntityCommandBuffer::Playback(Scene* scene) {
+        std::vector<Command> commands;
+        std::vector<u64> destroyedEntities;
+        u32 createdEntityCount = 0;
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            std::swap(commands, m_Commands);
+            std::swap(destroyedEntities, m_DestroyedEntities);
+            std::swap(createdEntityCount, m_CreatedEntityCount);
+        }
+
+        if (commands.empty() && destroyedEntities.empty()) return;
+
+        BL_PROFILE_SCOPE("EntityCommandBuffer::Playback");
+
+        if (createdEntityCount > 0) {
+            scene->ReserveEntities(scene->m_EntityMap.Size() + createdEntityCount);
+        }
+
+        for (Command& command : commands) {
+            command(scene);
+        }
+
+        if (!destroyedEntities.empty()) {
+            scene->DestroyEntities(destroyedEntities);
+        }
+    }
+
+    void EntityCommandBuffer::Clear() {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        m_Commands.clear();
+        m_DestroyedEntities.clear();
+        m_CreatedEntityCount = 0;
+    }
+
+    bool EntityCommandBuffer::IsEmpty() {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        return m_Commands.empty() && m_DestroyedEntities.empty();
+    }
+
+    void EntityCommandBuffer::Record(Command&& command) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        m_Commands.push_back(std::move(command));
+    }
+
+    EntityID EntityCommandBuffer::FindEntity(Scene* scene, u64 uuid, ECS** ecs) {
+        *ecs = scene->GetECS();
+
+        const EntityID* entity = scene->m_EntityMap.Find(uuid);
+        return entity ? *entity : entt::null;
+    }
+
+} // namespace Blackberry
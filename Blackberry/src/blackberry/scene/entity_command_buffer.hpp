@@ -0,0 +1,102 @@
+#pragma once
+
+#include "blackberry/core/types.hpp"
+#include "blackberry/ecs/ecs.hpp"
+
+#include <vector>
+#include <string>
+#include <mutex>
+#include <functional>
+
+namespace Blackberry {
+
+    class Scene;
+
+    // Records structural changes (creating/destroying entities, adding/removing components, parenting)
+    // so they can be applied later at a point where nothing is iterating over the scene (see Scene::OnUpdateRuntime)
+    //
+    // Recording is thread safe. Playback first runs every other command in the order they were recorded,
+    // then destroys all the entities at once (so commands never touch an entity which got destroyed in the same batch)
+    //
+    // NOTE: Destroying an entity also destroys all of its children (just like Scene::DestroyEntity)
+    class EntityCommandBuffer {
+    public:
+        EntityCommandBuffer() = default;
+
+        EntityCommandBuffer(const EntityCommandBuffer&) = delete;
+        EntityCommandBuffer& operator=(const EntityCommandBuffer&) = delete;
+
+        // Returns the UUID the entity will get, so later commands can already refer to it
+        // NOTE: The entity doesn't exist until the buffer gets played back!
+        u64 CreateEntity(const std::string& name, u64 parent = 0);
+        void DestroyEntity(u64 uuid);
+
+        void SetEntityParent(u64 uuid, u64 parent);
+
+        // NOTE: Does nothing if the entity already has the component (see EmplaceOrReplaceComponent)
+        template <typename T>
+        void AddComponent(u64 uuid, const T& component = T{}) {
+            Record([uuid, component](Scene* scene) {
+                ECS* ecs = nullptr;
+                EntityID entity = FindEntity(scene, uuid, &ecs);
+                if (entity == entt::null) return; // got destroyed before the buffer was played back
+
+                if (!ecs->HasComponent<T>(entity)) {
+                    ecs->AddComponent<T>(entity, component);
+                }
+            });
+        }
+
+        // Adds the component, or overwrites it if the entity already has one
+        template <typename T>
+        void EmplaceOrReplaceComponent(u64 uuid, const T& component) {
+            Record([uuid, component](Scene* scene) {
+                ECS* ecs = nullptr;
+                EntityID entity = FindEntity(scene, uuid, &ecs);
+                if (entity == entt::null) return;
+
+                if (ecs->HasComponent<T>(entity)) {
+                    ecs->GetComponent<T>(entity) = component;
+                } else {
+                    ecs->AddComponent<T>(entity, component);
+                }
+            });
+        }
+
+        template <typename T>
+        void RemoveComponent(u64 uuid) {
+            Record([uuid](Scene* scene) {
+                ECS* ecs = nullptr;
+                EntityID entity = FindEntity(scene, uuid, &ecs);
+                if (entity == entt::null) return;
+
+                if (ecs->HasComponent<T>(entity)) {
+                    ecs->RemoveComponent<T>(entity);
+                }
+            });
+        }
+
+        // Applies (and clears) everything recorded so far
+        // NOTE: Commands recorded while playing back (e.g. from another thread) end up in the next batch
+        void Playback(Scene* scene);
+
+        void Clear();
+        bool IsEmpty();
+
+    private:
+        using Command = std::function<void(Scene*)>;
+
+        void Record(Command&& command);
+
+        // Returns entt::null if the entity doesn't exist (anymore)
+        static EntityID FindEntity(Scene* scene, u64 uuid, ECS** ecs);
+
+    private:
+        std::mutex m_Mutex;
+
+        std::vector<Command> m_Commands;
+        std::vector<u64> m_DestroyedEntities;
+        u32 m_CreatedEntityCount = 0;
+    };
+
+} // namespace Blackberry
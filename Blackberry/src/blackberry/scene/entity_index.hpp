@@ -0,0 +1,233 @@
+#pragma once
+
+#include "blackberry/core/types.hpp"
+#include "blackberry/core/util.hpp"
+
+#include "blackberry/ecs/ecs.hpp"
+
+#include <vector>
+#include <bit>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define BL_ENTITY_INDEX_SSE2
+    #include <emmintrin.h>
+#endif
+
+namespace Blackberry {
+
+    // Flat open addressing hash map from u64 keys to values (e.g. entity UUIDs to entt entities, see EntityIndex)
+    //
+    // Every slot has a control byte: 0x80 if the slot is empty, otherwise the low 7 bits of the key's hash.
+    // Lookups compare 16 control bytes at once (using SSE2 if available) and only touch the keys whose control byte matched.
+    // Collisions are resolved with linear probing, so deleting just shifts the following entries back (no tombstones!)
+    //
+    // NOTE: Pointers returned by Find() are invalidated by Insert() and Erase()
+    template <typename T>
+    class FlatIndex {
+    public:
+        FlatIndex() = default;
+
+        // Makes sure count entries fit without rehashing
+        void Reserve(u32 count) {
+            u32 needed = count + count / 7 + 1; // stay below the max load factor (7/8)
+
+            if (needed > m_Capacity) {
+                Rehash(std::bit_ceil(std::max(needed, s_GroupSize)));
+            }
+        }
+
+        // Inserts the value or overwrites the existing one with the same key
+        void Insert(u64 key, const T& value) {
+            if (T* existing = Find(key)) {
+                *existing = value;
+                return;
+            }
+
+            if ((m_Size + 1) * 8 > m_Capacity * 7) {
+                Rehash(m_Capacity == 0 ? s_GroupSize : m_Capacity * 2);
+            }
+
+            u64 hash = Hash(key);
+            u32 slot = FindEmptySlot(static_cast<u32>(hash >> 7) & (m_Capacity - 1));
+
+            SetControl(slot, static_cast<u8>(hash & 0x7f));
+            m_Slots[slot] = { key, value };
+            m_Size++;
+        }
+
+        T* Find(u64 key) {
+            return const_cast<T*>(static_cast<const FlatIndex*>(this)->Find(key));
+        }
+
+        const T* Find(u64 key) const {
+            i32 slot = FindSlot(key);
+            return slot < 0 ? nullptr : &m_Slots[slot].Value;
+        }
+
+        const T& At(u64 key) const {
+            const T* value = Find(key);
+            BL_ASSERT(value, "Key {} does not exist!", key);
+
+            return *value;
+        }
+
+        bool Contains(u64 key) const {
+            return FindSlot(key) >= 0;
+        }
+
+        // Returns false if the key wasn't in the index
+        bool Erase(u64 key) {
+            i32 found = FindSlot(key);
+            if (found < 0) return false;
+
+            // Backward shift deletion: move every following entry of the probe chain which is allowed to sit in the hole
+            // back into it, this keeps every entry reachable from its home slot without leaving tombstones behind
+            u32 mask = m_Capacity - 1;
+            u32 hole = static_cast<u32>(found);
+            u32 next = (hole + 1) & mask;
+
+            while (m_Control[next] != s_Empty) {
+                u32 home = static_cast<u32>(Hash(m_Slots[next].Key) >> 7) & mask;
+
+                // The entry can be moved if its home slot is NOT cyclically inside (hole, next]
+                if (((next - home) & mask) >= ((next - hole) & mask)) {
+                    SetControl(hole, m_Control[next]);
+                    m_Slots[hole] = m_Slots[next];
+                    hole = next;
+                }
+
+                next = (next + 1) & mask;
+            }
+
+            SetControl(hole, s_Empty);
+            m_Size--;
+
+            return true;
+        }
+
+        void Clear() {
+            m_Control.assign(m_Control.size(), s_Empty);
+            m_Size = 0;
+        }
+
+        u32 Size() const { return m_Size; }
+        u32 Capacity() const { return m_Capacity; }
+
+        template <typename Func>
+        void Each(Func&& func) const {
+            for (u32 i = 0; i < m_Capacity; i++) {
+                if (m_Control[i] != s_Empty) {
+                    func(m_Slots[i].Key, m_Slots[i].Value);
+                }
+            }
+        }
+
+    private:
+        struct Slot {
+            u64 Key = 0;
+            T Value{};
+        };
+
+        static constexpr u8 s_Empty = 0x80;
+        static constexpr u32 s_GroupSize = 16;
+
+        // Keys are usually random already (UUIDs, name hashes) but we don't want to rely on that (e.g. hand written UUIDs in scene files)
+        static u64 Hash(u64 key) {
+            key ^= key >> 33;
+            key *= 0xff51afd7ed558ccdull;
+            key ^= key >> 33;
+            return key;
+        }
+
+        // Returns a bitmask of which of the 16 control bytes starting at pos are equal to value
+        u32 MatchGroup(u32 pos, u8 value) const {
+#if defined(BL_ENTITY_INDEX_SSE2)
+            __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_Control.data() + pos));
+            return static_cast<u32>(_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(value)))));
+#else
+            u32 mask = 0;
+            for (u32 i = 0; i < s_GroupSize; i++) {
+                mask |= static_cast<u32>(m_Control[pos + i] == value) << i;
+            }
+            return mask;
+#endif
+        }
+
+        i32 FindSlot(u64 key) const {
+            if (m_Size == 0) return -1;
+
+            u64 hash = Hash(key);
+            u8 h2 = static_cast<u8>(hash & 0x7f);
+            u32 mask = m_Capacity - 1;
+            u32 pos = static_cast<u32>(hash >> 7) & mask;
+
+            // NOTE: The load factor guarantees there is always an empty slot, so this terminates
+            while (true) {
+                u32 matches = MatchGroup(pos, h2);
+                while (matches) {
+                    u32 slot = (pos + std::countr_zero(matches)) & mask;
+                    if (m_Slots[slot].Key == key) return static_cast<i32>(slot);
+
+                    matches &= matches - 1;
+                }
+
+                // Linear probing never skips over empty slots, so the key can't be any further
+                if (MatchGroup(pos, s_Empty)) return -1;
+
+                pos = (pos + s_GroupSize) & mask;
+            }
+        }
+
+        u32 FindEmptySlot(u32 pos) const {
+            u32 mask = m_Capacity - 1;
+
+            while (true) {
+                if (u32 empty = MatchGroup(pos, s_Empty)) {
+                    return (pos + std::countr_zero(empty)) & mask;
+                }
+
+                pos = (pos + s_GroupSize) & mask;
+            }
+        }
+
+        // The first 16 control bytes are mirrored after the end so a group load never has to wrap around
+        void SetControl(u32 slot, u8 value) {
+            m_Control[slot] = value;
+
+            if (slot < s_GroupSize) {
+                m_Control[m_Capacity + slot] = value;
+            }
+        }
+
+        void Rehash(u32 capacity) {
+            std::vector<u8> oldControl = std::move(m_Control);
+            std::vector<Slot> oldSlots = std::move(m_Slots);
+            u32 oldCapacity = m_Capacity;
+
+            m_Capacity = capacity;
+            m_Control.assign(m_Capacity + s_GroupSize, s_Empty);
+            m_Slots.assign(m_Capacity, Slot{});
+
+            u32 mask = m_Capacity - 1;
+            for (u32 i = 0; i < oldCapacity; i++) {
+                if (oldControl[i] == s_Empty) continue;
+
+                u32 slot = FindEmptySlot(static_cast<u32>(Hash(oldSlots[i].Key) >> 7) & mask);
+                SetControl(slot, oldControl[i]);
+                m_Slots[slot] = oldSlots[i];
+            }
+        }
+
+    private:
+        std::vector<u8> m_Control; // m_Capacity + 16 bytes (see SetControl)
+        std::vector<Slot> m_Slots;
+
+        u32 m_Capacity = 0; // always a power of two (and at least 16)
+        u32 m_Size = 0;
+    };
+
+    // Entity UUID -> entt entity (replaces std::unordered_map<u64, EntityID>)
+    using EntityIndex = FlatIndex<EntityID>;
+
+} // namespace Blackberry
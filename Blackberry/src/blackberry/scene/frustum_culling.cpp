@@ -0,0 +1,222 @@
+#include "blackberry/scene/frustum_culling.hpp"
+#include "blackberry/core/util.hpp"
+
+#if defined(__AVX__)
+    #include <immintrin.h>
+    #define BL_CULL_AVX
+    #define BL_CULL_SSE // every AVX cpu has SSE as well
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define BL_CULL_SSE
+#endif
+
+namespace Blackberry {
+
+    void CullingBoxes::Add(const AABB& box) {
+        BlVec3 center = box.GetCenter();
+        BlVec3 extents = box.GetExtents();
+
+        CenterX.push_back(center.x);
+        CenterY.push_back(center.y);
+        CenterZ.push_back(center.z);
+
+        ExtentX.push_back(extents.x);
+        ExtentY.push_back(extents.y);
+        ExtentZ.push_back(extents.z);
+    }
+
+    void CullingBoxes::Clear() {
+        CenterX.clear();
+        CenterY.clear();
+        CenterZ.clear();
+
+        ExtentX.clear();
+        ExtentY.clear();
+        ExtentZ.clear();
+    }
+
+    void CullingBoxes::Reserve(u32 count) {
+        CenterX.reserve(count);
+        CenterY.reserve(count);
+        CenterZ.reserve(count);
+
+        ExtentX.reserve(count);
+        ExtentY.reserve(count);
+        ExtentZ.reserve(count);
+    }
+
+    // Same test (and the same order of operations) as Frustum::Classify, so every kernel gives the exact same answer
+    static bool IsBoxVisible(const CullingBoxes& boxes, const Frustum& frustum, u32 i) {
+        for (const BlVec4& plane : frustum.Planes) {
+            f32 distance = plane.x * boxes.CenterX[i] + plane.y * boxes.CenterY[i] + plane.z * boxes.CenterZ[i] + plane.w;
+            f32 radius = glm::abs(plane.x) * boxes.ExtentX[i] + glm::abs(plane.y) * boxes.ExtentY[i] + glm::abs(plane.z) * boxes.ExtentZ[i];
+
+            if (distance < -radius) return false;
+        }
+
+        return true;
+    }
+
+#if defined(BL_CULL_AVX)
+    // Tests 8 boxes at a time from i on, stops once less than 8 are left (i is where it stopped)
+    static u32 CullAVX(const CullingBoxes& boxes, const Frustum& frustum, u8* outVisible, u32& i) {
+        u32 count = boxes.Size();
+        u32 visible = 0;
+
+        // NOTE: The planes get broadcast once, every iteration tests 8 boxes against all 6 planes
+        __m256 planeX[6], planeY[6], planeZ[6], planeW[6];
+        __m256 absX[6], absY[6], absZ[6];
+
+        for (u32 p = 0; p < 6; p++) {
+            const BlVec4& plane = frustum.Planes[p];
+
+            planeX[p] = _mm256_set1_ps(plane.x);
+            planeY[p] = _mm256_set1_ps(plane.y);
+            planeZ[p] = _mm256_set1_ps(plane.z);
+            planeW[p] = _mm256_set1_ps(plane.w);
+
+            absX[p] = _mm256_set1_ps(glm::abs(plane.x));
+            absY[p] = _mm256_set1_ps(glm::abs(plane.y));
+            absZ[p] = _mm256_set1_ps(glm::abs(plane.z));
+        }
+
+        __m256 zero = _mm256_setzero_ps();
+
+        for (; i + 8 <= count; i += 8) {
+            __m256 cx = _mm256_loadu_ps(&boxes.CenterX[i]);
+            __m256 cy = _mm256_loadu_ps(&boxes.CenterY[i]);
+            __m256 cz = _mm256_loadu_ps(&boxes.CenterZ[i]);
+            __m256 ex = _mm256_loadu_ps(&boxes.ExtentX[i]);
+            __m256 ey = _mm256_loadu_ps(&boxes.ExtentY[i]);
+            __m256 ez = _mm256_loadu_ps(&boxes.ExtentZ[i]);
+
+            __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+            for (u32 p = 0; p < 6; p++) {
+                __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(planeX[p], cx), _mm256_mul_ps(planeY[p], cy)), _mm256_mul_ps(planeZ[p], cz)), planeW[p]);
+                __m256 radius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(absX[p], ex), _mm256_mul_ps(absY[p], ey)), _mm256_mul_ps(absZ[p], ez));
+
+                // NOTE: "not less than" instead of "greater or equal", so NaNs count as visible like in the scalar test
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, _mm256_sub_ps(zero, radius), _CMP_NLT_UQ));
+            }
+
+            u32 mask = static_cast<u32>(_mm256_movemask_ps(inside));
+            for (u32 lane = 0; lane < 8; lane++) {
+                outVisible[i + lane] = (mask >> lane) & 1;
+                visible += (mask >> lane) & 1;
+            }
+        }
+
+        return visible;
+    }
+#endif
+
+#if defined(BL_CULL_SSE)
+    // Tests 4 boxes at a time from i on, stops once less than 4 are left (i is where it stopped)
+    static u32 CullSSE(const CullingBoxes& boxes, const Frustum& frustum, u8* outVisible, u32& i) {
+        u32 count = boxes.Size();
+        u32 visible = 0;
+
+        // NOTE: The planes get broadcast once, every iteration tests 4 boxes against all 6 planes
+        __m128 planeX[6], planeY[6], planeZ[6], planeW[6];
+        __m128 absX[6], absY[6], absZ[6];
+
+        for (u32 p = 0; p < 6; p++) {
+            const BlVec4& plane = frustum.Planes[p];
+
+            planeX[p] = _mm_set1_ps(plane.x);
+            planeY[p] = _mm_set1_ps(plane.y);
+            planeZ[p] = _mm_set1_ps(plane.z);
+            planeW[p] = _mm_set1_ps(plane.w);
+
+            absX[p] = _mm_set1_ps(glm::abs(plane.x));
+            absY[p] = _mm_set1_ps(glm::abs(plane.y));
+            absZ[p] = _mm_set1_ps(glm::abs(plane.z));
+        }
+
+        __m128 zero = _mm_setzero_ps();
+
+        for (; i + 4 <= count; i += 4) {
+            __m128 cx = _mm_loadu_ps(&boxes.CenterX[i]);
+            __m128 cy = _mm_loadu_ps(&boxes.CenterY[i]);
+            __m128 cz = _mm_loadu_ps(&boxes.CenterZ[i]);
+            __m128 ex = _mm_loadu_ps(&boxes.ExtentX[i]);
+            __m128 ey = _mm_loadu_ps(&boxes.ExtentY[i]);
+            __m128 ez = _mm_loadu_ps(&boxes.ExtentZ[i]);
+
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+            for (u32 p = 0; p < 6; p++) {
+                __m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX[p], cx), _mm_mul_ps(planeY[p], cy)), _mm_mul_ps(planeZ[p], cz)), planeW[p]);
+                __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(absX[p], ex), _mm_mul_ps(absY[p], ey)), _mm_mul_ps(absZ[p], ez));
+
+                inside = _mm_and_ps(inside, _mm_cmpnlt_ps(distance, _mm_sub_ps(zero, radius)));
+            }
+
+            u32 mask = static_cast<u32>(_mm_movemask_ps(inside));
+            for (u32 lane = 0; lane < 4; lane++) {
+                outVisible[i + lane] = (mask >> lane) & 1;
+                visible += (mask >> lane) & 1;
+            }
+        }
+
+        return visible;
+    }
+#endif
+
+    u32 CullingBoxes::Cull(const Frustum& frustum, std::vector<u8>& outVisible) const {
+        return Cull(frustum, outVisible, GetBestKernel());
+    }
+
+    u32 CullingBoxes::Cull(const Frustum& frustum, std::vector<u8>& outVisible, CullingKernel kernel) const {
+        BL_ASSERT(IsSupported(kernel), "The culling kernel isn't supported by this build!");
+
+        u32 count = Size();
+        u32 visible = 0;
+        u32 i = 0;
+
+        outVisible.resize(count);
+
+        switch (kernel) {
+#if defined(BL_CULL_AVX)
+            case CullingKernel::AVX: visible += CullAVX(*this, frustum, outVisible.data(), i); break;
+#endif
+#if defined(BL_CULL_SSE)
+            case CullingKernel::SSE: visible += CullSSE(*this, frustum, outVisible.data(), i); break;
+#endif
+            default: break;
+        }
+
+        // Whatever didn't fill a whole vector (or everything with the scalar kernel)
+        for (; i < count; i++) {
+            outVisible[i] = IsBoxVisible(*this, frustum, i);
+            visible += outVisible[i];
+        }
+
+        return visible;
+    }
+
+    bool CullingBoxes::IsSupported(CullingKernel kernel) {
+        switch (kernel) {
+            case CullingKernel::Scalar: return true;
+#if defined(BL_CULL_SSE)
+            case CullingKernel::SSE: return true;
+#endif
+#if defined(BL_CULL_AVX)
+            case CullingKernel::AVX: return true;
+#endif
+            default: return false;
+        }
+    }
+
+    CullingKernel CullingBoxes::GetBestKernel() {
+#if defined(BL_CULL_AVX)
+        return CullingKernel::AVX;
+#elif defined(BL_CULL_SSE)
+        return CullingKernel::SSE;
+#else
+        return CullingKernel::Scalar;
+#endif
+    }
+
+} // namespace Blackberry
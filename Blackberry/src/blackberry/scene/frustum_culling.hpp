@@ -0,0 +1,36 @@
+#pragma once
+
+#include "blackberry/core/types.hpp"
+#include "blackberry/scene/bounds.hpp"
+
+#include <vector>
+
+namespace Blackberry {
+
+    // The SIMD width CullingBoxes::Cull tests the boxes with
+    enum class CullingKernel { Scalar, SSE, AVX };
+
+    // Boxes stored as structure of arrays (center and extents), so the frustum test can go through several at once
+    struct CullingBoxes {
+        std::vector<f32> CenterX, CenterY, CenterZ;
+        std::vector<f32> ExtentX, ExtentY, ExtentZ;
+
+        void Add(const AABB& box);
+        void Clear();
+        void Reserve(u32 count);
+
+        u32 Size() const { return static_cast<u32>(CenterX.size()); }
+
+        // Tests every box against the frustum, outVisible[i] is 1 if box i is at least partly inside (0 otherwise)
+        // NOTE: 8 boxes at a time when built with AVX, 4 with SSE and one at a time everywhere else,
+        // every kernel gives exactly the same result as Frustum::Overlaps (boxes touching a plane count as visible)
+        // Returns how many boxes are visible
+        u32 Cull(const Frustum& frustum, std::vector<u8>& outVisible) const;
+        // Same as above with a specific kernel (e.g. to compare them), the kernel must be supported by the build
+        u32 Cull(const Frustum& frustum, std::vector<u8>& outVisible, CullingKernel kernel) const;
+
+        static bool IsSupported(CullingKernel kernel);
+        static CullingKernel GetBestKernel(); // the widest one the build supports
+    };
+
+} // namespace Blackberry
@@ -0,0 +1,118 @@
+#include "blackberry/scene/prefab.hpp"
+#include "blackberry/scene/scene.hpp"
+#include "blackberry/scene/scene_serializer.hpp"
+
+#include <unordered_map>
+
+namespace Blackberry {
+
+    Prefab::Prefab(ECS* entities)
+        : m_ECS(entities) {
+        auto& tags = m_ECS->GetPool<const TagComponent>();
+        auto& relationships = m_ECS->GetPool<const RelationshipComponent>();
+
+        std::unordered_map<u64, EntityID> uuids;
+        uuids.reserve(tags.size());
+
+        for (auto [entity, tag] : tags.each()) {
+            uuids[tag.UUID] = entity;
+        }
+
+        // The root is the entity whose parent isn't part of the prefab (Save writes the root with its parent in the scene)
+        EntityID root = entt::null;
+        u32 rootCount = 0;
+
+        const entt::sparse_set& tagEntities = tags;
+        for (auto it = tagEntities.rbegin(); it != tagEntities.rend(); it++) {
+            if (!relationships.contains(*it)) continue;
+
+            u64 parent = relationships.get(*it).Parent;
+            if (parent == 0 || !uuids.contains(parent)) {
+                if (root == entt::null) root = *it;
+                rootCount++;
+            }
+        }
+
+        if (root == entt::null) return;
+
+        if (rootCount > 1) {
+            BL_CORE_WARN("Prefab has {} root entities, only the first one gets used!", rootCount);
+        }
+
+        m_Nodes.reserve(uuids.size());
+
+        auto append = [&](auto& self, EntityID entity, i32 parent) -> i32 {
+            i32 index = static_cast<i32>(m_Nodes.size());
+            m_Nodes.push_back({ entity, parent });
+
+            i32 previous = -1;
+            u64 child = relationships.get(entity).FirstChild;
+
+            while (child != 0) {
+                auto it = uuids.find(child);
+                if (it == uuids.end()) break;
+
+                i32 childIndex = self(self, it->second, index);
+
+                if (previous < 0) {
+                    m_Nodes[index].FirstChild = childIndex;
+                } else {
+                    m_Nodes[previous].NextSibling = childIndex;
+                    m_Nodes[childIndex].PrevSibling = previous;
+                }
+
+                previous = childIndex;
+                child = relationships.get(it->second).NextSibling;
+            }
+
+            return index;
+        };
+
+        append(append, root, -1);
+    }
+
+    Prefab::~Prefab() {
+        delete m_ECS;
+    }
+
+    Ref<Prefab> Prefab::Create(const FS::Path& path) {
+        ECS* entities = SceneSerializer::DeserializeToECS(path);
+
+        if (!entities) {
+            BL_CORE_WARN("Prefab {} has no entities!", path.String());
+            return nullptr;
+        }
+
+        return Ref<Prefab>(new Prefab(entities));
+    }
+
+    void Prefab::Save(Ref<Scene> scene, u64 root, const FS::Path& path) {
+        const SceneHierarchy& hierarchy = scene->GetHierarchy();
+
+        u32 index = hierarchy.IndexOf(scene->GetEntityFromUUID(root));
+        u32 end = index + hierarchy[index].SubtreeSize;
+
+        std::vector<EntityID> entities;
+        entities.reserve(end - index);
+
+        for (u32 i = index; i < end; i++) {
+            entities.push_back(hierarchy[i].Entity);
+        }
+
+        SceneSerializer serializer(scene);
+        serializer.Serialize(path, entities);
+    }
+
+    ECS* Prefab::GetECS() const {
+        return m_ECS;
+    }
+
+    const std::vector<Prefab::Node>& Prefab::GetNodes() const {
+        return m_Nodes;
+    }
+
+    const MeshComponent* Prefab::GetMeshDefaults(u32 node) const {
+        return m_ECS->TryGetComponent<const MeshComponent>(m_Nodes[node].Entity);
+    }
+
+} // namespace Blackberry
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "blackberry/core/types.hpp"
+#include "blackberry/core/path.hpp"
+#include "blackberry/core/memory.hpp"
+#include "blackberry/ecs/ecs.hpp"
+
+#include <vector>
+
+namespace Blackberry {
+
+    class Scene;
+
+    // An entity (and its children) which can be spawned into scenes any number of times (see Scene::InstantiatePrefab)
+    //
+    // The prefab keeps the default components in its own ECS. Instances point back at it with a PrefabInstanceComponent
+    // and only own what they can override, e.g. an instance's MeshComponent only holds the materials which differ from the prefab's
+    // (so spawning thousands of trees doesn't copy the material map thousands of times)
+    //
+    // NOTE: Prefab files are regular scene files (written with Save) and prefabs never change after they got loaded,
+    // so every instance (and every thread) can read the defaults without any locking
+    class Prefab {
+    public:
+        // One entity of the prefab, the nodes are in depth first order (so the root is always node 0)
+        struct Node {
+            EntityID Entity = entt::null; // in the prefab's ECS
+
+            // Node indices (-1 if there is none), instances copy these with their own UUIDs
+            i32 Parent = -1;
+            i32 FirstChild = -1;
+            i32 NextSibling = -1;
+            i32 PrevSibling = -1;
+        };
+
+    public:
+        // NOTE: Takes ownership of entities
+        Prefab(ECS* entities);
+        ~Prefab();
+
+        Prefab(const Prefab&) = delete;
+        Prefab& operator=(const Prefab&) = delete;
+
+        // Returns nullptr if the file has no entities
+        static Ref<Prefab> Create(const FS::Path& path);
+        // Writes the entity and all of its children as a prefab file
+        static void Save(Ref<Scene> scene, u64 root, const FS::Path& path);
+
+        // NOTE: Read only, use const components (e.g. GetECS()->GetComponent<const TagComponent>(node.Entity))
+        ECS* GetECS() const;
+        const std::vector<Node>& GetNodes() const;
+
+        // The node's default mesh (nullptr if the node has no mesh), instances use its materials unless they override them
+        const MeshComponent* GetMeshDefaults(u32 node) const;
+
+    private:
+        ECS* m_ECS = nullptr;
+        std::vector<Node> m_Nodes;
+    };
+
+} // namespace Blackberry
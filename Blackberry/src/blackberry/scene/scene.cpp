@@ -2,12 +2,18 @@
 #include "blackberry/ecs/ecs.hpp"
 #include "blackberry/core/log.hpp"
 #include "blackberry/core/util.hpp"
+#include "blackberry/core/timer.hpp"
+#include "blackberry/core/thread_pool.hpp"
 #include "blackberry/lua/lua.hpp"
+#include "blackberry/input/input.hpp"
 #include "blackberry/scene/entity.hpp"
 #include "blackberry/project/project.hpp"
 #include "blackberry/scene/scene_renderer.hpp"
 #include "blackberry/scene/scene_serializer.hpp"
 
+#include <unordered_set>
+#include <algorithm>
+
 extern "C" {
     #include "lua.h"
     #include "lauxlib.h"
@@ -16,9 +22,66 @@ extern "C" {
 
 namespace Blackberry {
 
+    // The components which give an entity a size (entities with any of these are in the spatial index)
+    using BoundedComponents = ComponentList<MeshComponent, PointLightComponent, SpotLightComponent, BoxColliderComponent, SphereColliderComponent>;
+
+    // NOTE: Restores whatever was current before when done, so scopes nest (e.g. a scene stepping another one from a script)
+    class Scene::ExecutionScope {
+    public:
+        ExecutionScope(Scene* scene) {
+            m_PreviousContext = Lua::SetCurrentContext(scene->m_LuaContext);
+            m_PreviousInput = Input::SetCurrentState(scene->m_Input);
+            m_PreviousProject = Project::SetCurrent(scene->m_Specification.Project.get());
+        }
+
+        ~ExecutionScope() {
+            Lua::SetCurrentContext(m_PreviousContext);
+            Input::SetCurrentState(m_PreviousInput);
+            Project::SetCurrent(m_PreviousProject);
+        }
+
+        ExecutionScope(const ExecutionScope&) = delete;
+        ExecutionScope& operator=(const ExecutionScope&) = delete;
+
+    private:
+        Lua::Context* m_PreviousContext = nullptr;
+        InputState* m_PreviousInput = nullptr;
+        Project* m_PreviousProject = nullptr;
+    };
+
+    // Used by single threaded scenes, a pool without workers runs every job on the thread submitting it (see ThreadPool)
+    static ThreadPool& GetInlineThreadPool() {
+        static ThreadPool pool(0);
+        return pool;
+    }
+
     Scene::Scene()
-        : m_ECS(new ECS), m_PhysicsWorld(new PhysicsEngine), m_Renderer(new SceneRenderer(this)) {
-        BL_CORE_TRACE("New scene created ({})", reinterpret_cast<void*>(this));
+        : Scene(SceneSpecification{}) {}
+
+    Scene::Scene(const SceneSpecification& spec)
+        : m_ECS(new ECS), m_PhysicsWorld(new PhysicsEngine(spec.SingleThreaded)), m_Specification(spec), m_OwnsResources(true) {
+        if (!spec.Headless) {
+            m_Renderer = new SceneRenderer(this);
+        } else {
+            m_Input = new InputState; // there is no window to get the input from
+        }
+
+        ConnectSpatialIndex();
+        RegisterEngineSystems();
+
+        BL_CORE_TRACE("New scene created ({}, headless: {})", reinterpret_cast<void*>(this), spec.Headless);
+    }
+
+    Scene::Scene(const SceneSpecification& spec, SceneRenderer* renderer, PhysicsEngine* physicsWorld)
+        : m_ECS(new ECS), m_PhysicsWorld(physicsWorld), m_Renderer(renderer), m_Specification(spec) {
+        if (spec.Headless) {
+            m_Input = new InputState;
+        }
+
+        ConnectSpatialIndex();
+        RegisterEngineSystems();
+
+        BL_CORE_TRACE("New scene created ({}, sharing resources)", reinterpret_cast<void*>(this));
     }
 
     Scene::~Scene() {
@@ -27,45 +90,135 @@ namespace Blackberry {
     }
 
     Ref<Scene> Scene::Create(const FS::Path& path) {
-        Ref<Scene> scene = CreateRef<Scene>();
+        return Create(path, SceneSpecification{});
+    }
+
+    Ref<Scene> Scene::Create(const FS::Path& path, const SceneSpecification& spec) {
+        Ref<Scene> scene(new Scene(spec));
         SceneSerializer serializer(scene);
         serializer.Deserialize(path);
 
+        // The persistent part of a partitioned scene, the cells next to it get streamed in while it runs
+        if (path.FileName() == FS::Path(WorldPartition::s_PersistentFileName) && FS::Exists(path.ParentPath() / WorldPartition::s_IndexFileName)) {
+            WorldPartitionSpecification partition;
+            partition.Directory = path.ParentPath();
+
+            scene->SetWorldPartition(partition);
+        }
+
         return scene;
     }
 
     void Scene::CopyTo(Ref<Scene> dest, Ref<Scene> source) {
-        dest->m_ECS = ECS::Copy(source->m_ECS);
+        BL_PROFILE_SCOPE("Scene::CopyTo");
+
+        // NOTE: The copy shares every component pool with the source until one of them writes to it (see ECS::CreateCopyOnWrite),
+        // so starting to play a scene only costs copying the entities and whatever the first frames actually write to
+        delete dest->m_ECS;
+        dest->m_ECS = ECS::CreateCopyOnWrite(source->m_ECS);
+        dest->ConnectSpatialIndex();
 
-        dest->m_RootEntities = source->m_RootEntities;
+        dest->m_Hierarchy = source->m_Hierarchy;
+        dest->m_HierarchyDirty = source->m_HierarchyDirty;
         dest->m_EntityMap = source->m_EntityMap;
+        dest->m_NamedEntities = source->m_NamedEntities;
+        dest->m_Systems = source->m_Systems; // systems get the scene they run on passed in, so they can be shared
+        dest->m_PartitionSpecification = source->m_PartitionSpecification;
+
+        // NOTE: The copy has the exact same entity ids, so the spatial index can be copied as is
+        dest->m_SpatialIndex = source->m_SpatialIndex;
+        dest->m_SpatialProxies = source->m_SpatialProxies;
+        dest->m_PendingBounds = source->m_PendingBounds;
+        dest->m_SpatialIndexVersion = source->m_SpatialIndexVersion; // the change trackers get copied along with the ECS
+        dest->m_TransformVersion = source->m_TransformVersion;
+
+        dest->m_PhysicsTickTime = 0.0f;
+        dest->m_Time = 0.0;
+        dest->m_FrameCount = 0;
+        dest->m_Paused = false;
     }
 
     Ref<Scene> Scene::Copy(Ref<Scene> source) {
-        Ref<Scene> scene = CreateRef<Scene>();
+        // NOTE: The copy shares the renderer and physics world with the source (building a new renderer means recreating every
+        // framebuffer and shader), this is fine since only one of them gets rendered/simulated at a time (e.g. editing vs playing)
+        Ref<Scene> scene(new Scene(source->m_Specification, source->m_Renderer, source->m_PhysicsWorld));
 
         CopyTo(scene, source);
 
         return scene;
     }
 
-    void Scene::Delete() {}
+    void Scene::Delete() {
+        // NOTE: Deleting the ECS also detaches it from the scene it was copied from (and gives scenes copied from this one their own pools)
+        delete m_ECS;
+        m_ECS = nullptr;
+
+        if (m_OwnsResources) {
+            delete m_Renderer;
+            delete m_PhysicsWorld;
+        }
+
+        m_Renderer = nullptr;
+        m_PhysicsWorld = nullptr;
+
+        delete m_WorldPartition;
+        m_WorldPartition = nullptr;
+
+        Lua::DestroyContext(m_LuaContext);
+        delete m_Input;
+
+        m_LuaContext = nullptr;
+        m_Input = nullptr;
+
+        m_EntityMap.Clear();
+        m_Hierarchy.Clear();
+        m_NamedEntities.Clear();
+
+        m_SpatialIndex.Clear();
+        m_SpatialProxies.clear();
+        m_PendingBounds.clear();
+        m_SpatialIndexVersion = 0;
+        m_TransformVersion = 0;
+    }
 
     void Scene::OnRuntimeStart() {
+        // Every run gets a fresh Lua state, so nothing the scripts did in the last run (or in another scene) is left over
+        Lua::DestroyContext(m_LuaContext);
+        m_LuaContext = Lua::CreateContext();
+
+        ExecutionScope scope(this);
+
+        m_PhysicsWorld->Reset(); // the physics world may be shared with other scenes (see Scene::Copy)
         m_PhysicsWorld->SetContext(this);
 
-        auto boxBodyView = m_ECS->GetEntitiesWithComponents<TransformComponent, RigidBodyComponent, BoxColliderComponent>();
-        auto sphereBodyView = m_ECS->GetEntitiesWithComponents<TransformComponent, RigidBodyComponent, SphereColliderComponent>();
+        m_PhysicsTickTime = 0.0f;
+        m_Time = 0.0;
+        m_FrameCount = 0;
 
-        boxBodyView.each([&](entt::entity entity, TransformComponent& transform, RigidBodyComponent& rigidbody, BoxColliderComponent& boxCollider) {
-            m_PhysicsWorld->AddActor(static_cast<u32>(entity), transform, rigidbody, boxCollider);    
-        });
+        if (m_PartitionSpecification) {
+            delete m_WorldPartition;
+            m_WorldPartition = new WorldPartition(this, *m_PartitionSpecification);
+        }
+
+        UpdateWorldTransforms();
+
+        // NOTE: A rigid body can only be in one group, so the colliders get looked up (an entity only has one of them anyway)
+        auto rigidBodyGroup = m_ECS->GetGroup<RigidBodyComponent>(entt::get<const TransformComponent>);
+        auto& boxColliders = m_ECS->GetPool<const BoxColliderComponent>();
+        auto& sphereColliders = m_ECS->GetPool<const SphereColliderComponent>();
+
+        rigidBodyGroup.each([&](entt::entity entity, RigidBodyComponent& rigidbody, const TransformComponent& transform) {
+            if (boxColliders.contains(entity)) {
+                m_PhysicsWorld->AddActor(static_cast<u32>(entity), transform, rigidbody, boxColliders.get(entity));
+            }
 
-        sphereBodyView.each([&](entt::entity entity, TransformComponent& transform, RigidBodyComponent& rigidbody, SphereColliderComponent& sphereCollider) {
-            m_PhysicsWorld->AddActor(static_cast<u32>(entity), transform, rigidbody, sphereCollider);    
+            if (sphereColliders.contains(entity)) {
+                m_PhysicsWorld->AddActor(static_cast<u32>(entity), transform, rigidbody, sphereColliders.get(entity));
+            }
         });
 
-        auto view = m_ECS->GetEntitiesWithComponents<ScriptComponent>();
+        auto view = m_ECS->GetEntitiesWithComponents<const ScriptComponent>();
+        if (view.empty()) return; // nothing to load (and the scene may not even have a project, e.g. a headless simulation)
 
         // Set the search path for modules
         Lua::GetMember("package", "path");
@@ -77,14 +230,14 @@ namespace Blackberry {
         Lua::SetField(-2, "path");
         Lua::Pop(1);
 
-        view.each([&](auto entity, ScriptComponent& script) {
+        view.each([&](auto entity, const ScriptComponent& script) {
             // Execute script
-            Lua::RunFile(Project::GetAssetPath(script.ModulePath), script.ModulePath.String());
+            Lua::RunFile(Project::GetAssetPath(script.ModulePath.String()), script.ModulePath.String());
             Lua::SetExecutionContext(script.ModulePath.String());
 
             // Create entity
             Lua::GetMember("Entity", "new");
-            Lua::PushInteger(m_ECS->GetComponent<TagComponent>(entity).UUID);
+            Lua::PushInteger(m_ECS->GetComponent<const TagComponent>(entity).UUID);
             Lua::PushLightUserData(this);
             Lua::CallFunction(2, 1);
 
@@ -105,25 +258,42 @@ namespace Blackberry {
     }
 
     void Scene::OnRuntimeStop() {
-        auto view = m_ECS->GetEntitiesWithComponents<ScriptComponent>();
+        {
+            ExecutionScope scope(this);
 
-        view.each([&](auto entity, ScriptComponent& script) {
-            Lua::SetExecutionContext(script.ModulePath.String());
+            auto view = m_ECS->GetEntitiesWithComponents<const ScriptComponent>();
 
-            Lua::GetMember("OnDetach");
-            Lua::CallFunction(0, 0);
+            view.each([&](auto entity, const ScriptComponent& script) {
+                Lua::SetExecutionContext(script.ModulePath.String());
 
-            Lua::Pop(1);
-        });
+                Lua::GetMember("OnDetach");
+                Lua::CallFunction(0, 0);
+
+                Lua::Pop(1);
+            });
+        }
+
+        // NOTE: The streamed in cells stay in the scene, but the models the partition unloaded get loaded again
+        if (m_WorldPartition) {
+            ExecutionScope scope(this);
+
+            delete m_WorldPartition;
+            m_WorldPartition = nullptr;
+        }
+
+        Lua::DestroyContext(m_LuaContext);
+        m_LuaContext = nullptr;
+
+        m_PhysicsWorld->Reset();
     }
 
     SceneCamera Scene::GetSceneCamera() {
         SceneCamera cam;
-        auto cameraView = m_ECS->GetEntitiesWithComponents<TransformComponent, CameraComponent>();
+        auto cameraView = m_ECS->GetEntitiesWithComponents<const TransformComponent, const CameraComponent>();
 
         u32 activeCameras = 0;
 
-        cameraView.each([&](entt::entity entity, TransformComponent& transform, CameraComponent& camera) {
+        cameraView.each([&](entt::entity entity, const TransformComponent& transform, const CameraComponent& camera) {
             if (camera.Active) {
                 cam.Transform = transform;
                 cam.Camera = camera;
@@ -142,38 +312,94 @@ namespace Blackberry {
     void Scene::OnUpdateEditor() {}
 
     void Scene::OnUpdateRuntime() {
+        OnUpdateRuntime(BL_APP.GetDeltaTime());
+    }
+
+    void Scene::OnUpdateRuntime(f32 deltaTime) {
         if (m_Paused) return;
 
-        // Run the physics at a constant 60 fps
-        m_PhysicsTickTime += BL_APP.GetDeltaTime();
-        while (m_PhysicsTickTime >= 0.01667f) {
-            m_PhysicsWorld->Step(m_PhysicsTickTime);
-            m_PhysicsTickTime -= 0.01667f;
-        }
+        UpdateRuntime(deltaTime);
+    }
 
-        auto scriptView = m_ECS->GetEntitiesWithComponents<ScriptComponent>();
+    void Scene::Step(u32 frames) {
+        BL_PROFILE_SCOPE("Scene::Step");
 
-        scriptView.each([&](auto entity, ScriptComponent& script) {
-            Lua::SetExecutionContext(script.ModulePath.String());
-            
-            Lua::GetMember("OnUpdate");
+        for (u32 i = 0; i < frames; i++) {
+            UpdateRuntime(m_Specification.FixedTimeStep);
+        }
+    }
 
-            Lua::PushValue(-2); // push the table (self)
-            Lua::PushNumber(BL_APP.GetDeltaTime());
+    void Scene::StepParallel(std::vector<Ref<Scene>>& scenes, u32 frames, ThreadPool& pool) {
+        BL_PROFILE_SCOPE("Scene::StepParallel");
 
-            Lua::CallFunction(2, 0);
+        for (Ref<Scene>& scene : scenes) {
+            // NOTE: A scene using a thread pool would wait on it from inside one of our jobs (which deadlocks, see ThreadPool)
+            BL_ASSERT(scene->m_Specification.SingleThreaded && !scene->m_ThreadPool, "Scenes stepped in parallel have to be single threaded!");
 
-            Lua::Pop(1);
+            // Cloning copy-on-write pools isn't thread safe, so scenes which were copied from each other get their own pools up front
+            scene->m_ECS->MakeAllWritable();
+        }
+
+        // NOTE: Every scene gets stepped by exactly one thread, and the Refs only get dereferenced there (their counters aren't atomic)
+        pool.ParallelFor(static_cast<u32>(scenes.size()), [&](u32 begin, u32 end) {
+            for (u32 i = begin; i < end; i++) {
+                scenes[i]->Step(frames);
+            }
         });
     }
 
+    f64 Scene::GetTime() const {
+        return m_Time;
+    }
+
+    u64 Scene::GetFrameCount() const {
+        return m_FrameCount;
+    }
+
+    void Scene::UpdateRuntime(f32 deltaTime) {
+        ExecutionScope scope(this);
+
+        // Sync point: changes recorded since the last update (e.g. from other threads)
+        m_CommandBuffer.Playback(this);
+
+        // NOTE: Streaming creates and destroys entities too, so it happens at the sync point
+        if (m_WorldPartition) {
+            m_WorldPartition->Update(GetSceneCamera().Transform.Position);
+        }
+
+        // NOTE: Scripts can touch any component, so as a system every other system would have to wait for them (and they for
+        // every system before them). Running them here on their own keeps the systems free to overlap with each other
+        RunScripts(deltaTime);
+
+        m_Systems.Run(this, deltaTime, GetThreadPool());
+
+        // Sync point: changes the scripts and systems recorded
+        m_CommandBuffer.Playback(this);
+
+        // NOTE: The window does this for its own input at the end of every frame
+        if (m_Input) {
+            Input::ResetKeyState();
+        }
+
+        m_Time += deltaTime;
+        m_FrameCount++;
+    }
+
     void Scene::OnRenderEditor(Ref<Framebuffer> target, SceneCamera& camera) {
+        UpdateWorldTransforms();
+
+        if (!m_Renderer) return; // headless scene
+
         m_Renderer->SetCamera(camera);
         m_Renderer->SetRenderTarget(target);
         m_Renderer->Render(this);
     }
 
     void Scene::OnRenderRuntime(Ref<Framebuffer> target) {
+        UpdateWorldTransforms();
+
+        if (!m_Renderer) return; // headless scene
+
         SceneCamera cam = GetSceneCamera();
 
         m_Renderer->SetCamera(cam);
@@ -184,31 +410,129 @@ namespace Blackberry {
     EntityID Scene::CreateEntity(const std::string& name) {
         u64 id = UUID();
         CreateEntityWithUUID(id);
-        m_NamedEntityMap[name] = id;
+        SetEntityName(id, name);
 
-        TagComponent& tag = m_ECS->GetComponent<TagComponent>(m_EntityMap.at(id));
-        tag.Name = name;
+        FinishEntityEdit(id);
         
-        return m_EntityMap.at(id);
+        return m_EntityMap.At(id);
     }
 
     EntityID Scene::CreateEntityWithUUID(u64 uuid) {
-        m_EntityMap[uuid] = m_ECS->CreateEntity();
+        EntityID entity = m_ECS->CreateEntity();
+        m_EntityMap.Insert(uuid, entity);
+
+        m_ECS->AddComponent<TagComponent>(entity, { "", uuid });
+        m_ECS->AddComponent<RelationshipComponent>(entity, {});
+
+        m_Hierarchy.Append(uuid, entity); // new entities don't have a parent so they are always root entities
+
+        return entity;
+    }
+
+    void Scene::ReserveEntities(u32 count) {
+        m_EntityMap.Reserve(count);
+        m_Hierarchy.Reserve(count);
+    }
+
+    std::vector<u64> Scene::MergeEntities(ECS* source) {
+        BL_PROFILE_SCOPE("Scene::MergeEntities");
+
+        auto& tags = source->GetPool<const TagComponent>();
+        const entt::sparse_set& sourceEntities = tags;
+
+        // Create all the entities first, so the components can be copied one pool at a time
+        std::vector<std::pair<EntityID, EntityID>> entities; // source entity, our entity
+        entities.reserve(tags.size());
+
+        for (auto it = sourceEntities.rbegin(); it != sourceEntities.rend(); it++) {
+            u64 uuid = tags.get(*it).UUID;
+
+            if (m_EntityMap.Contains(uuid)) {
+                BL_CORE_WARN("Entity with UUID {} already exists, skipping it!", uuid);
+                continue;
+            }
+
+            EntityID entity = m_ECS->CreateEntity();
+            m_EntityMap.Insert(uuid, entity);
+
+            entities.emplace_back(*it, entity);
+        }
+
+        AllComponents::ForEach([&]<typename T>() {
+            // NOTE: World transforms get added along with the transforms (and recomputed on the next update anyway)
+            if constexpr (!std::is_same_v<T, WorldTransformComponent>) {
+                auto& from = source->GetPool<const T>();
+                if (from.empty()) return;
+
+                auto& to = m_ECS->GetPool<T>();
+                for (auto [sourceEntity, entity] : entities) {
+                    if (from.contains(sourceEntity)) {
+                        to.emplace(entity, from.get(sourceEntity));
+                    }
+                }
+            }
+        });
 
-        m_ECS->AddComponent<TagComponent>(m_EntityMap.at(uuid), { "", uuid });
-        m_ECS->AddComponent<RelationshipComponent>(m_EntityMap.at(uuid), {});
+        {
+            auto& mergedTags = m_ECS->GetPool<const TagComponent>();
 
-        return m_EntityMap.at(uuid);
+            for (auto [sourceEntity, entity] : entities) {
+                const TagComponent& tag = mergedTags.get(entity);
+                SetEntityName(tag.UUID, tag.Name);
+            }
+        }
+
+        // Every root's subtree gets appended to the hierarchy as a whole (which keeps it in depth first order),
+        // if some entity's parent isn't part of source the hierarchy gets rebuilt instead
+        std::unordered_set<u64> merged;
+        merged.reserve(entities.size());
+
+        for (auto [sourceEntity, entity] : entities) {
+            merged.insert(tags.get(sourceEntity).UUID);
+        }
+
+        std::vector<u64> roots;
+        bool missingParent = false;
+
+        for (auto [sourceEntity, entity] : entities) {
+            const RelationshipComponent& rel = m_ECS->GetComponent<const RelationshipComponent>(entity);
+
+            if (rel.Parent == 0) {
+                roots.push_back(tags.get(sourceEntity).UUID);
+            } else if (!merged.contains(rel.Parent)) {
+                missingParent = true;
+            }
+        }
+
+        if (m_HierarchyDirty || missingParent) {
+            // NOTE: RefreshHierarchy only looks at the entities which are already in the hierarchy
+            for (auto [sourceEntity, entity] : entities) {
+                m_Hierarchy.Append(tags.get(sourceEntity).UUID, entity);
+            }
+
+            m_HierarchyDirty = true;
+        } else {
+            for (u64 root : roots) {
+                AppendToHierarchy(root, -1);
+            }
+        }
+
+        return roots;
     }
 
     void Scene::SetEntityParent(u64 entity, u64 parent) {
-        DetachEntity(entity);
+        UnlinkEntity(entity);
+        MarkTransformDirty(entity);
+
+        if (!m_HierarchyDirty) {
+            m_Hierarchy.SetParent(m_EntityMap.At(entity), parent != 0 ? m_EntityMap.At(parent) : entt::null);
+        }
 
-        RelationshipComponent& rel = m_ECS->GetComponent<RelationshipComponent>(m_EntityMap.at(entity));
+        RelationshipComponent& rel = m_ECS->GetComponent<RelationshipComponent>(m_EntityMap.At(entity));
         rel.Parent = parent;
 
         if (parent != 0) {
-            auto& pRel = m_ECS->GetComponent<RelationshipComponent>(m_EntityMap.at(parent));
+            auto& pRel = m_ECS->GetComponent<RelationshipComponent>(m_EntityMap.At(parent));
 
             u64 oldFirst = pRel.FirstChild;
             pRel.FirstChild = entity;
@@ -217,17 +541,26 @@ namespace Blackberry {
             rel.PrevSibling = 0;
 
             if (oldFirst != 0) {
-                auto& fRel = m_ECS->GetComponent<RelationshipComponent>(m_EntityMap.at(oldFirst));
+                auto& fRel = m_ECS->GetComponent<RelationshipComponent>(m_EntityMap.At(oldFirst));
                 fRel.PrevSibling = entity;
             }
         }
     }
 
     void Scene::DetachEntity(u64 uuid) {
-        auto& rel = m_ECS->GetComponent<RelationshipComponent>(m_EntityMap.at(uuid));
+        UnlinkEntity(uuid);
+        MarkTransformDirty(uuid);
+
+        if (!m_HierarchyDirty) {
+            m_Hierarchy.SetParent(m_EntityMap.At(uuid), entt::null);
+        }
+    }
+
+    void Scene::UnlinkEntity(u64 uuid) {
+        auto& rel = m_ECS->GetComponent<RelationshipComponent>(m_EntityMap.At(uuid));
 
         if (rel.Parent != 0) {
-            auto& pRel = m_ECS->GetComponent<RelationshipComponent>(m_EntityMap.at(rel.Parent));
+            auto& pRel = m_ECS->GetComponent<RelationshipComponent>(m_EntityMap.At(rel.Parent));
 
             if (pRel.FirstChild == uuid) {
                 pRel.FirstChild = rel.NextSibling;
@@ -235,13 +568,13 @@ namespace Blackberry {
         }
 
         if (rel.PrevSibling != 0) {
-            auto& psRel = m_ECS->GetComponent<RelationshipComponent>(m_EntityMap.at(rel.PrevSibling));
+            auto& psRel = m_ECS->GetComponent<RelationshipComponent>(m_EntityMap.At(rel.PrevSibling));
 
             psRel.NextSibling = rel.NextSibling;
         }
 
         if (rel.NextSibling != 0) {
-            auto& nsRel = m_ECS->GetComponent<RelationshipComponent>(m_EntityMap.at(rel.NextSibling));
+            auto& nsRel = m_ECS->GetComponent<RelationshipComponent>(m_EntityMap.At(rel.NextSibling));
 
             nsRel.PrevSibling = rel.PrevSibling;
         }
@@ -252,50 +585,243 @@ namespace Blackberry {
     }
 
     void Scene::FinishEntityEdit(u64 entity) {
-        auto& rel = m_ECS->GetComponent<RelationshipComponent>(m_EntityMap.at(entity));
+        if (m_HierarchyDirty) return; // gets rebuilt anyway
+
+        EntityID e = m_EntityMap.At(entity);
+        auto& rel = m_ECS->GetComponent<const RelationshipComponent>(e);
+
+        u32 index = m_Hierarchy.IndexOf(e);
+        BL_ASSERT(index != SceneHierarchy::s_InvalidIndex, "Entity with UUID {} is not in the hierarchy!", entity);
 
-        std::erase(m_RootEntities, entity); // remove entity from root entities (because entity was probably parented to something)
+        // SetEntityParent/DetachEntity already moved the entity, so this only fails if the relationship was edited directly
+        // (e.g. while loading a scene). In that case the whole hierarchy gets rebuilt once before it gets used next,
+        // which is a lot cheaper than moving every entity of a scene file around one by one
+        i32 parent = m_Hierarchy[index].Parent;
+        u64 hierarchyParent = parent < 0 ? 0 : m_Hierarchy[parent].UUID;
 
-        if (rel.Parent == 0) {
-            m_RootEntities.push_back(entity); // if entity was not parented to something
+        if (hierarchyParent != rel.Parent) {
+            m_HierarchyDirty = true;
         }
     }
 
     void Scene::DuplicateEntity(u64 entity) {
-        auto newEntity = ECS::CopyEntity(m_EntityMap.at(entity), &m_ECS->m_Registry, &m_ECS->m_Registry);
+        auto newEntity = m_ECS->CopyEntity(m_EntityMap.At(entity));
+
+        u64 uuid = m_ECS->GetComponent<const TagComponent>(newEntity).UUID;
+        m_EntityMap.Insert(uuid, newEntity);
+
+        // The copied relationship still points at the original's parent, siblings and children,
+        // so the duplicate starts out unlinked and then gets added as a new child of the same parent
+        u64 parent = m_ECS->GetComponent<const RelationshipComponent>(newEntity).Parent;
+        m_ECS->GetComponent<RelationshipComponent>(newEntity) = {};
+
+        m_Hierarchy.Append(uuid, newEntity);
 
-        u64 uuid = m_ECS->GetComponent<TagComponent>(newEntity).UUID;
-        m_EntityMap[uuid] = newEntity;
+        // NOTE: The duplicate takes the name over, FindEntity finds the entity which got named last
+        SetEntityName(uuid, m_ECS->GetComponent<const TagComponent>(newEntity).Name);
+
+        if (parent != 0) {
+            SetEntityParent(uuid, parent);
+        }
 
         FinishEntityEdit(uuid);
     }
 
-    void Scene::DestroyEntity(u64 uuid) {
-        BL_ASSERT(m_EntityMap.contains(uuid), "Entity with UUID {} does not exist!", uuid);
+    std::vector<u64> Scene::InstantiatePrefab(u64 prefabHandle, const std::vector<TransformComponent>& transforms) {
+        BL_PROFILE_SCOPE("Scene::InstantiatePrefab");
+
+        AssetManager& assets = Project::GetAssetManager();
+        BL_ASSERT(assets.ContainsAsset(prefabHandle), "Prefab asset {} does not exist!", prefabHandle);
+
+        Ref<Prefab> prefab = std::get<Ref<Prefab>>(assets.GetAsset(prefabHandle).Data);
+        ECS* source = prefab->GetECS();
+
+        const std::vector<Prefab::Node>& nodes = prefab->GetNodes();
+        u32 nodeCount = static_cast<u32>(nodes.size());
+        u32 instanceCount = static_cast<u32>(transforms.size());
+        u32 count = nodeCount * instanceCount;
+
+        if (count == 0) return {};
+
+        ReserveEntities(m_Hierarchy.Size() + count);
+
+        // Instance i's node n is at i * nodeCount + n
+        std::vector<EntityID> entities(count);
+        std::vector<u64> uuids(count);
+
+        m_ECS->CreateEntities(entities);
+
+        for (u32 i = 0; i < count; i++) {
+            uuids[i] = UUID();
+            m_EntityMap.Insert(uuids[i], entities[i]);
+        }
+
+        {
+            auto& tags = m_ECS->GetPool<TagComponent>();
+            auto& relationships = m_ECS->GetPool<RelationshipComponent>();
+            auto& instances = m_ECS->GetPool<PrefabInstanceComponent>();
+
+            auto& sourceTags = source->GetPool<const TagComponent>();
+
+            auto toUUID = [&](u32 instance, i32 node) {
+                return node < 0 ? 0 : uuids[instance * nodeCount + node];
+            };
+
+            for (u32 i = 0; i < instanceCount; i++) {
+                for (u32 n = 0; n < nodeCount; n++) {
+                    EntityID entity = entities[i * nodeCount + n];
+                    const Prefab::Node& node = nodes[n];
+
+                    tags.emplace(entity, TagComponent{ sourceTags.get(node.Entity).Name, uuids[i * nodeCount + n] });
+                    relationships.emplace(entity, RelationshipComponent{ toUUID(i, node.Parent), toUUID(i, node.FirstChild), toUUID(i, node.NextSibling), toUUID(i, node.PrevSibling) });
+                    instances.emplace(entity, PrefabInstanceComponent{ prefabHandle, n });
+                }
+            }
+        }
+
+        for (u32 i = 0; i < count; i++) {
+            SetEntityName(uuids[i], m_ECS->GetComponent<const TagComponent>(entities[i]).Name);
+        }
+
+        // Every other component gets added to all the instances of a node at once
+        std::vector<EntityID> nodeEntities(instanceCount);
+
+        AllComponents::ForEach([&]<typename T>() {
+            if constexpr (!std::is_same_v<T, TagComponent> && !std::is_same_v<T, RelationshipComponent> &&
+                          !std::is_same_v<T, WorldTransformComponent> && !std::is_same_v<T, PrefabInstanceComponent>) {
+                auto& from = source->GetPool<const T>();
+                if (from.empty()) return;
+
+                auto& to = m_ECS->GetPool<T>();
+
+                for (u32 n = 0; n < nodeCount; n++) {
+                    if (!from.contains(nodes[n].Entity)) continue;
 
-        auto& rel = m_ECS->GetComponent<RelationshipComponent>(m_EntityMap.at(uuid));
-        if (rel.Parent == 0) {
-            for (auto entity : m_RootEntities) {
-                BL_CORE_INFO("vector before erase: {}", entity);
+                    // The roots get the given transforms instead (below)
+                    if (std::is_same_v<T, TransformComponent> && n == 0) continue;
+
+                    for (u32 i = 0; i < instanceCount; i++) {
+                        nodeEntities[i] = entities[i * nodeCount + n];
+                    }
+
+                    if constexpr (std::is_same_v<T, MeshComponent>) {
+                        // NOTE: The materials stay with the prefab, instances only store the ones they override
+                        to.insert(nodeEntities.begin(), nodeEntities.end(), MeshComponent{ from.get(nodes[n].Entity).MeshHandle });
+                    } else {
+                        to.insert(nodeEntities.begin(), nodeEntities.end(), from.get(nodes[n].Entity));
+                    }
+                }
             }
-            std::erase(m_RootEntities, uuid);
-            for (auto entity : m_RootEntities) {
-                BL_CORE_INFO("vector after erase: {}", entity);
+        });
+
+        {
+            auto& transformPool = m_ECS->GetPool<TransformComponent>();
+
+            for (u32 i = 0; i < instanceCount; i++) {
+                transformPool.emplace(entities[i * nodeCount], transforms[i]);
             }
         }
 
-        u64 child = rel.FirstChild;
-        while (child != 0) {
-            Entity childEntity = Entity(GetEntityFromUUID(child), this);
-            RelationshipComponent childRel = childEntity.GetComponent<RelationshipComponent>(); // NOTE: **MAKE** A COPY TO THIS, THIS IS A COMPONENT OF A SOON TO BE DELETED ENTITY!
-        
-            DestroyEntity(child);
-        
-            child = childRel.NextSibling;
+        std::vector<u64> roots(instanceCount);
+
+        for (u32 i = 0; i < instanceCount; i++) {
+            roots[i] = uuids[i * nodeCount];
+
+            // NOTE: The nodes are already in depth first order, so every instance is appended as is
+            u32 first = m_Hierarchy.Size();
+
+            for (u32 n = 0; n < nodeCount; n++) {
+                i32 parent = (m_HierarchyDirty || nodes[n].Parent < 0) ? -1 : static_cast<i32>(first) + nodes[n].Parent;
+                m_Hierarchy.Append(uuids[i * nodeCount + n], entities[i * nodeCount + n], parent);
+            }
         }
 
-        m_ECS->DestroyEntity(m_EntityMap.at(uuid));
-        m_EntityMap.erase(uuid);
+        return roots;
+    }
+
+    u64 Scene::InstantiatePrefab(u64 prefab, const TransformComponent& transform) {
+        std::vector<u64> roots = InstantiatePrefab(prefab, std::vector<TransformComponent>{ transform });
+        return roots.empty() ? 0 : roots[0];
+    }
+
+    void Scene::DestroyEntity(u64 uuid) {
+        BL_ASSERT(m_EntityMap.Contains(uuid), "Entity with UUID {} does not exist!", uuid);
+
+        RefreshHierarchy();
+        UnlinkEntity(uuid); // the subtree goes away as a whole, so only its root has to be unlinked from its siblings
+
+        // NOTE: The subtree is contiguous in the hierarchy, so destroying all the children is a linear scan
+        EntityID entity = m_EntityMap.At(uuid);
+        u32 index = m_Hierarchy.IndexOf(entity);
+        u32 end = index + m_Hierarchy[index].SubtreeSize;
+
+        for (u32 i = index; i < end; i++) {
+            const SceneHierarchy::Node& node = m_Hierarchy[i];
+
+            UnregisterEntityName(node.UUID, node.Entity);
+
+            m_ECS->DestroyEntity(node.Entity);
+            m_EntityMap.Erase(node.UUID);
+        }
+
+        m_Hierarchy.Remove(entity);
+    }
+
+    void Scene::DestroyEntities(const std::vector<u64>& uuids) {
+        BL_PROFILE_SCOPE("Scene::DestroyEntities");
+
+        RefreshHierarchy();
+
+        std::vector<EntityID> entities;
+        entities.reserve(uuids.size());
+
+        // NOTE: Indexed by the entity's slot, so skipping duplicate uuids stays linear
+        std::vector<bool> seen;
+
+        for (u64 uuid : uuids) {
+            const EntityID* entity = m_EntityMap.Find(uuid);
+            if (!entity) continue;
+
+            u32 slot = static_cast<u32>(entt::to_entity(*entity));
+            if (slot >= seen.size()) seen.resize(slot + 1);
+            if (seen[slot]) continue;
+            seen[slot] = true;
+
+            UnlinkEntity(uuid);
+            entities.push_back(*entity);
+        }
+
+        if (entities.empty()) return;
+
+        // One pass over the hierarchy for all of the subtrees
+        std::vector<SceneHierarchy::Node> removedNodes;
+        m_Hierarchy.Remove(entities, removedNodes);
+
+        entities.clear();
+        for (const SceneHierarchy::Node& node : removedNodes) {
+            UnregisterEntityName(node.UUID, node.Entity);
+
+            entities.push_back(node.Entity);
+            m_EntityMap.Erase(node.UUID);
+        }
+
+        m_ECS->DestroyEntities(entities);
+    }
+
+    void Scene::SetWorldPartition(const WorldPartitionSpecification& spec) {
+        m_PartitionSpecification = spec;
+    }
+
+    WorldPartition* Scene::GetWorldPartition() {
+        return m_WorldPartition;
+    }
+
+    EntityCommandBuffer& Scene::GetCommandBuffer() {
+        return m_CommandBuffer;
+    }
+
+    SystemScheduler& Scene::GetSystems() {
+        return m_Systems;
     }
 
     void Scene::SetPaused(bool pause) {
@@ -307,52 +833,223 @@ namespace Blackberry {
     }
 
     EntityID Scene::GetEntity(const std::string& name) {
-        if (!m_NamedEntityMap.contains(name)) {
-            CreateEntity(name);
+        EntityID entity = FindEntity(name);
+
+        if (entity == entt::null) {
+            entity = CreateEntity(name);
         }
 
-        return m_EntityMap.at(m_NamedEntityMap.at(name));
+        return entity;
     }
 
-    EntityID Scene::GetEntityFromUUID(u64 uuid) {
-        auto& entityMap = m_EntityMap;
+    EntityID Scene::FindEntity(HashedString name) const {
+        const u64* uuid = m_NamedEntities.Find(name);
+        if (!uuid) return entt::null;
 
-        return entityMap.at(uuid);
+        const EntityID* entity = m_EntityMap.Find(*uuid);
+        return entity ? *entity : entt::null;
+    }
+
+    void Scene::SetEntityName(u64 uuid, InternedString name) {
+        EntityID entity = m_EntityMap.At(uuid);
+
+        UnregisterEntityName(uuid, entity);
+        m_NamedEntities.Insert(name.GetHash(), uuid);
+
+        // NOTE: name may be the tag's current name (e.g. when registering the name of a loaded entity)
+        TagComponent& tag = m_ECS->GetComponent<TagComponent>(entity);
+        tag.Name = name;
+    }
+
+    void Scene::UnregisterEntityName(u64 uuid, EntityID entity) {
+        if (m_NamedEntities.Size() == 0) return;
+
+        HashedString name = m_ECS->GetComponent<const TagComponent>(entity).Name.GetHash();
+
+        if (const u64* named = m_NamedEntities.Find(name); named && *named == uuid) {
+            m_NamedEntities.Erase(name);
+        }
+    }
+
+    EntityID Scene::GetEntityFromUUID(u64 uuid) {
+        return m_EntityMap.At(uuid);
     }
 
     std::vector<EntityID> Scene::GetEntities() {
         return m_ECS->GetAllEntities();
     }
 
-    TransformComponent Scene::GetEntityParentTransform(EntityID e) {
-        TransformComponent transform;
+    struct Scene::WorldTransformPools {
+        const entt::storage<TransformComponent>& Transforms;
+        entt::storage<WorldTransformComponent>& WorldTransforms;
+
+        ChangeTracker& WorldTransformChanges;
+        u32 Version;
+
+        WorldTransformComponent Identity; // the "parent" of root entities
+    };
+
+    void Scene::UpdateWorldTransforms() {
+        BL_PROFILE_SCOPE("Scene::UpdateWorldTransforms");
 
-        RelationshipComponent rel = m_ECS->GetComponent<RelationshipComponent>(e);
+        // NOTE: Editing the relationships directly can move any entity, so after a rebuild every world transform gets recomputed
+        bool rebuilt = m_HierarchyDirty;
+        RefreshHierarchy();
 
-        // We loop over all of the parents and add their transforms
-        while (rel.Parent) {
-            Entity parent(GetEntityFromUUID(rel.Parent), this);
+        u32 since = m_TransformVersion;
+        m_TransformVersion = m_ECS->AdvanceVersion();
 
-            if (parent.HasComponent<TransformComponent>()) {
-                auto& parentTransform = parent.GetComponent<TransformComponent>();
-                transform.Position += parentTransform.Position;
+        // Only the subtrees of the entities whose transform got marked as changed (or which got a new parent, see MarkTransformDirty)
+        // get recomputed, a static scene costs one look at the change tracker
+        m_DirtySubtrees.clear();
+
+        if (rebuilt) {
+            m_Hierarchy.EachRoot([&](u32 root) { m_DirtySubtrees.push_back(root); });
+        } else {
+            m_ECS->GetChanges<TransformComponent>().EachChangedSince(since, [&](EntityID entity) {
+                u32 index = m_Hierarchy.IndexOf(entity); // NOTE: Destroyed entities aren't in the hierarchy anymore
+                if (index != SceneHierarchy::s_InvalidIndex) {
+                    m_DirtySubtrees.push_back(index);
+                }
+            });
+
+            // Parents come before their children, so once sorted every subtree which lies inside the one before it can be dropped
+            std::sort(m_DirtySubtrees.begin(), m_DirtySubtrees.end());
+
+            const std::vector<SceneHierarchy::Node>& nodes = m_Hierarchy.GetNodes();
+            u32 count = 0;
+            u32 end = 0;
+
+            for (u32 index : m_DirtySubtrees) {
+                if (index < end) continue;
+
+                m_DirtySubtrees[count++] = index;
+                end = index + nodes[index].SubtreeSize;
             }
 
-            rel = parent.GetComponent<RelationshipComponent>();
+            m_DirtySubtrees.resize(count);
         }
 
-        return transform;
+        if (!m_DirtySubtrees.empty()) {
+            // NOTE: The pools get fetched once up front, this creates them if needed (entt lazily creates them on first access,
+            // which is NOT thread safe) and makes sure a copy-on-write scene only clones the world transforms
+            WorldTransformPools pools{
+                m_ECS->GetPool<const TransformComponent>(),
+                m_ECS->GetPool<WorldTransformComponent>(),
+                m_ECS->GetChanges<WorldTransformComponent>(),
+                m_ECS->GetVersion()
+            };
+
+            // NOTE: The workers mark changes concurrently, so the tracker has to be big enough for every entity up front
+            u32 entityCapacity = static_cast<u32>(m_ECS->m_Registry.storage<entt::entity>().size());
+            pools.WorldTransformChanges.Reserve(entityCapacity);
+
+            m_PropagatedTransforms.resize(m_Hierarchy.Size());
+
+            u32 subtreeCount = static_cast<u32>(m_DirtySubtrees.size());
+
+            if (subtreeCount < s_ParallelTransformThreshold) {
+                for (u32 subtree : m_DirtySubtrees) {
+                    UpdateWorldTransforms(pools, subtree);
+                }
+            } else {
+                // NOTE: The dirty subtrees never share entities and UpdateWorldTransforms doesn't add or remove any components,
+                // so every worker can safely write to its own entities' components
+                GetThreadPool()->ParallelFor(subtreeCount, [&](u32 begin, u32 end) {
+                    for (u32 i = begin; i < end; i++) {
+                        UpdateWorldTransforms(pools, m_DirtySubtrees[i]);
+                    }
+                });
+            }
+        }
+
+        UpdateSpatialIndex();
+    }
+
+    TransformComponent Scene::GetEntityParentTransform(EntityID e) {
+        u64 parent = m_ECS->GetComponent<const RelationshipComponent>(e).Parent;
+
+        // We walk up until we find a parent with a transform (entities without transforms just pass their parent's one down)
+        while (parent) {
+            EntityID parentEntity = GetEntityFromUUID(parent);
+
+            if (m_ECS->HasComponent<TransformComponent>(parentEntity)) {
+                return GetEntityTransform(parentEntity);
+            }
+
+            parent = m_ECS->GetComponent<const RelationshipComponent>(parentEntity).Parent;
+        }
+
+        return TransformComponent{};
     }
 
     TransformComponent Scene::GetEntityTransform(EntityID e) {
         BL_ASSERT(m_ECS->HasComponent<TransformComponent>(e), "Entity does not contain transform!");
 
-        TransformComponent transform = m_ECS->GetComponent<TransformComponent>(e);
-        transform.Position += GetEntityParentTransform(e).Position;
+        const TransformComponent& local = m_ECS->GetComponent<const TransformComponent>(e);
+
+        // Use the cached world transform if it is still valid
+        if (auto* world = m_ECS->TryGetComponent<const WorldTransformComponent>(e)) {
+            if (IsWorldTransformUpToDate(e)) {
+                return { world->Position, world->Rotation, world->Scale };
+            }
+        }
+
+        TransformComponent parent = GetEntityParentTransform(e);
+
+        TransformComponent transform;
+        transform.Position = BlVec3(parent.GetMatrix() * BlVec4(local.Position, 1.0f));
+        transform.Rotation = parent.Rotation * local.Rotation;
+        transform.Scale = parent.Scale * local.Scale;
 
         return transform;
     }
 
+    BlMat4 Scene::GetEntityWorldMatrix(EntityID e) {
+        const TransformComponent& local = m_ECS->GetComponent<const TransformComponent>(e);
+
+        if (auto* world = m_ECS->TryGetComponent<const WorldTransformComponent>(e)) {
+            if (IsWorldTransformUpToDate(e)) {
+                return world->Matrix;
+            }
+        }
+
+        return GetEntityParentTransform(e).GetMatrix() * local.GetMatrix();
+    }
+
+    bool Scene::IsWorldTransformUpToDate(EntityID e) const {
+        // NOTE: After the relationships got edited directly the hierarchy can't be trusted (and everything gets recomputed anyway)
+        if (m_HierarchyDirty) return false;
+
+        u32 index = m_Hierarchy.IndexOf(e);
+        if (index == SceneHierarchy::s_InvalidIndex) return false;
+
+        // The hierarchy stores the parents as indices, so this is a walk over an array (no hash lookups)
+        const ChangeTracker& changes = static_cast<const ECS*>(m_ECS)->GetChanges<TransformComponent>();
+        const std::vector<SceneHierarchy::Node>& nodes = m_Hierarchy.GetNodes();
+
+        for (i32 node = static_cast<i32>(index); node >= 0; node = nodes[node].Parent) {
+            if (changes.HasChangedSince(nodes[node].Entity, m_TransformVersion)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void Scene::SetEntityWorldTransform(EntityID e, const TransformComponent& world) {
+        BL_ASSERT(m_ECS->HasComponent<TransformComponent>(e), "Entity does not contain transform!");
+
+        TransformComponent parent = GetEntityParentTransform(e);
+        auto& local = m_ECS->GetComponent<TransformComponent>(e);
+
+        local.Position = BlVec3(glm::inverse(parent.GetMatrix()) * BlVec4(world.Position, 1.0f));
+        local.Rotation = glm::normalize(glm::inverse(parent.Rotation) * world.Rotation);
+        local.Scale = world.Scale / parent.Scale;
+
+        m_ECS->MarkChanged<TransformComponent>(e);
+    }
+
     ECS* Scene::GetECS() {
         return m_ECS;
     }
@@ -365,8 +1062,378 @@ namespace Blackberry {
         return m_Renderer;
     }
 
-    std::vector<u64>& Scene::GetRootEntities() {
-        return m_RootEntities;
+    void Scene::SetThreadPool(ThreadPool* pool) {
+        m_ThreadPool = pool;
+    }
+
+    ThreadPool* Scene::GetThreadPool() {
+        if (m_ThreadPool) return m_ThreadPool;
+
+        return m_Specification.SingleThreaded ? &GetInlineThreadPool() : &ThreadPool::Get();
+    }
+
+    InputState* Scene::GetInputState() {
+        return m_Input;
+    }
+
+    std::vector<u64> Scene::GetRootEntities() {
+        RefreshHierarchy();
+
+        std::vector<u64> roots;
+        m_Hierarchy.EachRoot([&](u32 root) { roots.push_back(m_Hierarchy[root].UUID); });
+
+        return roots;
+    }
+
+    const SceneHierarchy& Scene::GetHierarchy() {
+        RefreshHierarchy();
+
+        return m_Hierarchy;
+    }
+
+    const BoundingVolumeHierarchy& Scene::GetSpatialIndex() const {
+        return m_SpatialIndex;
+    }
+
+    // NOTE: The tree only knows the fat bounds, so every hit gets checked against the exact ones as well
+
+    void Scene::QueryBox(const AABB& box, std::vector<EntityID>& outEntities) const {
+        m_SpatialIndex.QueryBox(box, [&](EntityID entity) {
+            if (box.Overlaps(m_SpatialProxies[entt::to_entity(entity)].Bounds)) {
+                outEntities.push_back(entity);
+            }
+
+            return true;
+        });
+    }
+
+    void Scene::QuerySphere(const BlVec3& center, f32 radius, std::vector<EntityID>& outEntities) const {
+        m_SpatialIndex.QuerySphere(center, radius, [&](EntityID entity) {
+            if (m_SpatialProxies[entt::to_entity(entity)].Bounds.OverlapsSphere(center, radius)) {
+                outEntities.push_back(entity);
+            }
+
+            return true;
+        });
+    }
+
+    void Scene::QueryFrustum(const Frustum& frustum, std::vector<EntityID>& outEntities) const {
+        m_SpatialIndex.QueryFrustum(frustum, [&](EntityID entity) {
+            if (frustum.Overlaps(m_SpatialProxies[entt::to_entity(entity)].Bounds)) {
+                outEntities.push_back(entity);
+            }
+
+            return true;
+        });
+    }
+
+    EntityID Scene::Raycast(const Ray& ray, f32 maxDistance, f32* outDistance) const {
+        EntityID closest = entt::null;
+        f32 closestDistance = maxDistance;
+
+        m_SpatialIndex.Raycast(ray, maxDistance, [&](EntityID entity, f32) {
+            f32 distance = 0.0f;
+            f32 exitDistance = 0.0f;
+
+            if (ray.Intersects(m_SpatialProxies[entt::to_entity(entity)].Bounds, closestDistance, &distance, &exitDistance)) {
+                // If the ray starts inside the box use where it leaves the box instead (otherwise the camera's
+                // surroundings, e.g. a big light radius, would always win)
+                if (distance == 0.0f) distance = exitDistance;
+
+                if (distance < closestDistance) {
+                    closest = entity;
+                    closestDistance = distance;
+                }
+            }
+
+            return closestDistance; // only look for closer hits from now on
+        });
+
+        if (outDistance && closest != entt::null) *outDistance = closestDistance;
+
+        return closest;
+    }
+
+    AABB Scene::GetEntityBounds(EntityID entity) const {
+        u32 index = entt::to_entity(entity);
+
+        if (index < m_SpatialProxies.size() && m_SpatialProxies[index].Proxy != BoundingVolumeHierarchy::s_NullNode &&
+            m_SpatialIndex.GetEntity(m_SpatialProxies[index].Proxy) == entity) {
+            return m_SpatialProxies[index].Bounds;
+        }
+
+        return AABB::Empty();
+    }
+
+    void Scene::MarkBoundsDirty(EntityID entity) {
+        m_PendingBounds.push_back(entity);
+    }
+
+    void Scene::UpdateWorldTransforms(WorldTransformPools& pools, u32 root) {
+        const std::vector<SceneHierarchy::Node>& nodes = m_Hierarchy.GetNodes();
+        u32 end = root + nodes[root].SubtreeSize;
+
+        // The subtree hangs off the world transform of its closest ancestor with a transform (which didn't change)
+        const WorldTransformComponent* parentWorld = &pools.Identity;
+
+        for (i32 parent = nodes[root].Parent; parent >= 0; parent = nodes[parent].Parent) {
+            if (pools.Transforms.contains(nodes[parent].Entity)) {
+                parentWorld = &pools.WorldTransforms.get(nodes[parent].Entity);
+                break;
+            }
+        }
+
+        // Parents always come before their children, so by the time we get to a node its parent's world transform is up to date
+        for (u32 i = root; i < end; i++) {
+            const SceneHierarchy::Node& node = nodes[i];
+            const WorldTransformComponent* world = i == root ? parentWorld : m_PropagatedTransforms[node.Parent];
+
+            // Entities without a transform just pass their parent's world transform down
+            if (pools.Transforms.contains(node.Entity)) {
+                const TransformComponent& local = pools.Transforms.get(node.Entity);
+                auto& cached = pools.WorldTransforms.get(node.Entity); // always exists alongside the transform (see ECS::ECS)
+
+                cached.Matrix = world->Matrix * local.GetMatrix();
+                cached.Position = BlVec3(world->Matrix * BlVec4(local.Position, 1.0f));
+                cached.Rotation = world->Rotation * local.Rotation;
+                cached.Scale = world->Scale * local.Scale;
+
+                pools.WorldTransformChanges.MarkChanged(node.Entity, pools.Version);
+
+                world = &cached;
+            }
+
+            m_PropagatedTransforms[i] = world;
+        }
+    }
+
+    void Scene::RefreshHierarchy() {
+        if (!m_HierarchyDirty) return;
+
+        BL_PROFILE_SCOPE("Scene::RefreshHierarchy");
+
+        // Every entity is still in the hierarchy (just maybe under the wrong parent), so the current order of the roots gets kept
+        std::vector<u64> roots;
+        for (const SceneHierarchy::Node& node : m_Hierarchy.GetNodes()) {
+            if (m_ECS->GetComponent<const RelationshipComponent>(node.Entity).Parent == 0) {
+                roots.push_back(node.UUID);
+            }
+        }
+
+        m_Hierarchy.Clear();
+
+        for (u64 root : roots) {
+            AppendToHierarchy(root, -1);
+        }
+
+        m_HierarchyDirty = false;
+    }
+
+    void Scene::AppendToHierarchy(u64 uuid, i32 parent) {
+        EntityID entity = m_EntityMap.At(uuid);
+        i32 index = static_cast<i32>(m_Hierarchy.Append(uuid, entity, parent));
+
+        u64 child = m_ECS->GetComponent<const RelationshipComponent>(entity).FirstChild;
+        while (child != 0) {
+            AppendToHierarchy(child, index);
+
+            child = m_ECS->GetComponent<const RelationshipComponent>(m_EntityMap.At(child)).NextSibling;
+        }
+    }
+
+    void Scene::RegisterEngineSystems() {
+        // NOTE: The spatial index update needs the scene's project (for the mesh bounds), so transforms run on the main thread
+        m_Systems.AddSystem({
+            "Scene::Transforms",
+            AllComponents::MaskOf<TransformComponent, RelationshipComponent, MeshComponent, PointLightComponent,
+                SpotLightComponent, BoxColliderComponent, SphereColliderComponent>(), // the latter ones for the spatial index
+            AllComponents::MaskOf<WorldTransformComponent>(),
+            true
+        }, [](Scene* scene, f32) {
+            scene->UpdateWorldTransforms();
+        });
+
+        // Run the physics at a constant 60 fps
+        // NOTE: Jolt runs the simulation on its own job system, the sync back only writes to the transforms
+        m_Systems.AddSystem({
+            "Scene::Physics",
+            AllComponents::MaskOf<RelationshipComponent, WorldTransformComponent>(),
+            AllComponents::MaskOf<TransformComponent>(),
+            false
+        }, [](Scene* scene, f32 deltaTime) {
+            // NOTE: Always stepping by the same amount keeps the simulation deterministic (e.g. for Scene::Step in tests)
+            scene->m_PhysicsTickTime += deltaTime;
+            while (scene->m_PhysicsTickTime >= s_PhysicsTimeStep) {
+                scene->m_PhysicsWorld->Step(s_PhysicsTimeStep);
+                scene->m_PhysicsTickTime -= s_PhysicsTimeStep;
+            }
+        });
+    }
+
+    void Scene::RunScripts(f32 deltaTime) {
+        BL_PROFILE_SCOPE("Scene::Scripts");
+
+        auto scriptView = m_ECS->GetEntitiesWithComponents<const ScriptComponent>();
+
+        scriptView.each([&](auto entity, const ScriptComponent& script) {
+            Lua::SetExecutionContext(script.ModulePath.String());
+
+            Lua::GetMember("OnUpdate");
+
+            Lua::PushValue(-2); // push the table (self)
+            Lua::PushNumber(deltaTime);
+
+            Lua::CallFunction(2, 0);
+
+            Lua::Pop(1);
+        });
+    }
+
+    void Scene::UpdateSpatialIndex() {
+        BL_PROFILE_SCOPE("Scene::UpdateSpatialIndex");
+
+        // Entities which moved since the last update (UpdateWorldTransforms marks every world transform it recomputed),
+        // only the changed blocks get looked at so a mostly static scene doesn't cost a walk over the whole hierarchy
+        u32 since = m_SpatialIndexVersion;
+        m_SpatialIndexVersion = m_ECS->AdvanceVersion();
+
+        m_ECS->GetChanges<WorldTransformComponent>().EachChangedSince(since, [&](EntityID entity) {
+            u32 index = entt::to_entity(entity);
+            if (index < m_SpatialProxies.size() && m_SpatialProxies[index].Proxy != BoundingVolumeHierarchy::s_NullNode) {
+                RefreshEntityBounds(entity);
+            }
+        });
+
+        if (m_PendingBounds.empty()) return;
+
+        // NOTE: Entities whose bounds are only a guess get added to the list again, so swap it out first
+        std::vector<EntityID> pending;
+        pending.swap(m_PendingBounds);
+
+        for (EntityID entity : pending) {
+            RefreshEntityBounds(entity);
+        }
+    }
+
+    void Scene::RefreshEntityBounds(EntityID entity) {
+        u32 index = entt::to_entity(entity);
+        if (index >= m_SpatialProxies.size()) {
+            m_SpatialProxies.resize(index + 1);
+        }
+
+        SpatialProxy& proxy = m_SpatialProxies[index];
+
+        // The slot may still hold the proxy of a destroyed entity with the same index
+        if (proxy.Proxy != BoundingVolumeHierarchy::s_NullNode && m_SpatialIndex.GetEntity(proxy.Proxy) != entity) {
+            if (!m_ECS->m_Registry.valid(m_SpatialIndex.GetEntity(proxy.Proxy))) {
+                m_SpatialIndex.DestroyProxy(proxy.Proxy);
+                proxy.Proxy = BoundingVolumeHierarchy::s_NullNode;
+            } else {
+                return; // the entity is gone and the slot belongs to a newer one (which gets refreshed on its own)
+            }
+        }
+
+        AABB bounds;
+        bool exact = true;
+
+        if (!m_ECS->m_Registry.valid(entity) || !ComputeEntityBounds(entity, bounds, exact)) {
+            if (proxy.Proxy != BoundingVolumeHierarchy::s_NullNode) {
+                m_SpatialIndex.DestroyProxy(proxy.Proxy);
+                proxy.Proxy = BoundingVolumeHierarchy::s_NullNode;
+            }
+
+            return;
+        }
+
+        if (!exact) {
+            m_PendingBounds.push_back(entity); // try again next update
+        }
+
+        proxy.Bounds = bounds;
+
+        if (proxy.Proxy == BoundingVolumeHierarchy::s_NullNode) {
+            proxy.Proxy = m_SpatialIndex.CreateProxy(bounds, entity);
+        } else {
+            m_SpatialIndex.MoveProxy(proxy.Proxy, bounds);
+        }
+    }
+
+    bool Scene::ComputeEntityBounds(EntityID entity, AABB& outBounds, bool& outExact) {
+        const WorldTransformComponent* world = m_ECS->TryGetComponent<const WorldTransformComponent>(entity);
+        BlMat4 matrix = world ? world->Matrix : BlMat4(1.0f);
+        BlVec3 position = BlVec3(matrix[3]);
+
+        AABB bounds = AABB::Empty();
+        bool found = false;
+
+        outExact = true;
+
+        if (const MeshComponent* mesh = m_ECS->TryGetComponent<const MeshComponent>(entity)) {
+            AssetManager& assets = Project::GetAssetManager();
+
+            if (assets.ContainsAsset(mesh->MeshHandle)) {
+                const Model& model = std::get<Model>(assets.GetAsset(mesh->MeshHandle).Data);
+
+                AABB local = AABB::Empty();
+                for (const Mesh& m : model.Meshes) {
+                    local.Merge(m.Bounds.Transform(m.Transform));
+                }
+
+                if (local.IsValid()) {
+                    bounds.Merge(local.Transform(matrix));
+                }
+            } else {
+                bounds.Merge(AABB::FromCenter(BlVec3(0.0f), BlVec3(0.5f)).Transform(matrix)); // unit cube until the model shows up
+                outExact = false;
+            }
+
+            found = true;
+        }
+
+        // NOTE: Light ranges are in world space (they don't get scaled)
+        if (const PointLightComponent* light = m_ECS->TryGetComponent<const PointLightComponent>(entity)) {
+            bounds.Merge(AABB::FromCenter(position, BlVec3(light->Radius)));
+            found = true;
+        }
+
+        // NOTE: Spot lights don't have a range, so they only get a small box for picking
+        if (m_ECS->HasComponent<SpotLightComponent>(entity)) {
+            bounds.Merge(AABB::FromCenter(position, BlVec3(0.5f)));
+            found = true;
+        }
+
+        if (const BoxColliderComponent* box = m_ECS->TryGetComponent<const BoxColliderComponent>(entity)) {
+            bounds.Merge(AABB::FromCenter(BlVec3(0.0f), box->Scale).Transform(matrix));
+            found = true;
+        }
+
+        if (const SphereColliderComponent* sphere = m_ECS->TryGetComponent<const SphereColliderComponent>(entity)) {
+            bounds.Merge(AABB::FromCenter(BlVec3(0.0f), BlVec3(sphere->Radius)).Transform(matrix));
+            found = true;
+        }
+
+        if (!found) return false;
+
+        outBounds = bounds.IsValid() ? bounds : AABB::FromCenter(position, BlVec3(0.0f)); // e.g. a model without any meshes
+        return true;
+    }
+
+    void Scene::ConnectSpatialIndex() {
+        // NOTE: Cloning a shared pool (see ECS::CreateCopyOnWrite) doesn't fire any signals, only real adds/removes do
+        BoundedComponents::ForEach([&]<typename T>() {
+            m_ECS->m_Registry.on_construct<T>().template connect<&Scene::OnBoundsComponentChanged>(*this);
+            m_ECS->m_Registry.on_destroy<T>().template connect<&Scene::OnBoundsComponentChanged>(*this);
+        });
+    }
+
+    void Scene::OnBoundsComponentChanged(entt::registry& registry, entt::entity entity) {
+        // NOTE: on_destroy fires before the component is gone, so the entity only gets looked at on the next update
+        m_PendingBounds.push_back(entity);
+    }
+
+    void Scene::MarkTransformDirty(u64 uuid) {
+        // NOTE: A new parent moves the entity (and its children) without touching its local transform
+        m_ECS->MarkChanged<TransformComponent>(m_EntityMap.At(uuid));
     }
 
 } // namespace Blackberry
@@ -2,25 +2,61 @@
 
 #include "blackberry/scene/uuid.hpp"
 #include "blackberry/ecs/ecs.hpp"
+#include "blackberry/scene/entity_index.hpp"
+#include "blackberry/scene/scene_hierarchy.hpp"
+#include "blackberry/scene/entity_command_buffer.hpp"
+#include "blackberry/scene/system_scheduler.hpp"
+#include "blackberry/scene/bounding_volume_hierarchy.hpp"
+#include "blackberry/scene/world_partition.hpp"
 #include "blackberry/physics/physics_engine.hpp"
 #include "blackberry/scene/camera.hpp"
+#include "blackberry/core/hashed_string.hpp"
 
 #include <unordered_map>
 #include <string>
+#include <memory>
+#include <optional>
 
 namespace Blackberry {
 
     class SceneRenderer;
+    class ThreadPool;
+    class Project;
+    struct InputState;
+
+    namespace Lua {
+        struct Context;
+    } // namespace Lua
+
+    struct SceneSpecification {
+        // Headless scenes don't create a renderer, so they work without a window or GL context (tools, benchmarks, servers, tests)
+        // NOTE: Headless scenes have to be updated with OnUpdateRuntime(deltaTime) or Step, there may not be an application
+        bool Headless = false;
+        f32 FixedTimeStep = 1.0f / 60.0f; // how much game time one Step advances the scene by
+
+        // Runs everything (the systems, world transforms and physics) on the thread updating the scene instead of the thread pools,
+        // which is what you want when many scenes get updated in parallel (see Scene::StepParallel)
+        bool SingleThreaded = false;
+
+        // The project the scene loads its assets and scripts from (nullptr means the active one)
+        std::shared_ptr<Blackberry::Project> Project;
+    };
 
     class Scene {
     public:
         Scene();
+        Scene(const SceneSpecification& spec);
         ~Scene();
 
         static Ref<Scene> Create(const FS::Path& path);
+        static Ref<Scene> Create(const FS::Path& path, const SceneSpecification& spec);
 
+        // NOTE: Copies are copy-on-write, they share the component pools with the source until either of them writes to one
+        // NOTE: dest keeps its own specification (e.g. to copy a scene into a headless one)
         static void CopyTo(Ref<Scene> dest, Ref<Scene> source);
         static Ref<Scene> Copy(Ref<Scene> source);
+        // Frees the scene's entities (and its renderer/physics world unless they are shared with another scene)
+        // NOTE: Delete copies you are done with, otherwise they keep cloning every pool the source writes to
         void Delete();
 
         void OnRuntimeStart();
@@ -29,7 +65,22 @@ namespace Blackberry {
         SceneCamera GetSceneCamera();
 
         void OnUpdateEditor();
+        // Advances the scene by the application's frame time
         void OnUpdateRuntime();
+        // Advances the scene by deltaTime seconds of game time (does nothing while paused)
+        void OnUpdateRuntime(f32 deltaTime);
+        // Runs frames updates of FixedTimeStep back to back, as fast as possible (e.g. Step(60 * 60) simulates a minute of gameplay)
+        // NOTE: Also steps paused scenes, so a paused game can be advanced frame by frame
+        void Step(u32 frames = 1);
+
+        // Steps every scene frames times (see Step), the scenes get spread over the pool's threads
+        // NOTE: The scenes MUST be single threaded (see SceneSpecification::SingleThreaded) and MUST NOT share anything with each other,
+        // copies made with Scene::Copy share the physics world with their source, so copy them into new scenes with CopyTo instead
+        static void StepParallel(std::vector<Ref<Scene>>& scenes, u32 frames, ThreadPool& pool);
+
+        // The game time (every update's delta time added up since OnRuntimeStart) and how many updates ran since then
+        f64 GetTime() const;
+        u64 GetFrameCount() const;
 
         void OnRenderEditor(Ref<Framebuffer> target, SceneCamera& camera);
         void OnRenderRuntime(Ref<Framebuffer> target);
@@ -37,48 +88,209 @@ namespace Blackberry {
         EntityID CreateEntity(const std::string& name);
         EntityID CreateEntityWithUUID(u64 uuid);
 
+        // Preallocates room for count entities (e.g. when loading a scene file)
+        void ReserveEntities(u32 count);
+
+        // Copies every entity of source (e.g. a sub-scene loaded with SceneSerializer::DeserializeToECS) into this scene
+        // and returns the UUIDs of the root entities that got added, entities whose UUID already exists get skipped
+        // NOTE: The UUIDs stay the same, so source's relationships still work (the hierarchy gets appended subtree by subtree)
+        std::vector<u64> MergeEntities(ECS* source);
+
+        // NOTE: Both of these also move the entity (and its children) inside the packed hierarchy (see SceneHierarchy)
         void SetEntityParent(u64 entity, u64 parent);
         void DetachEntity(u64 uuid);
 
+        // Must be called after editing an entity's RelationshipComponent directly (e.g. when loading a scene)
         void FinishEntityEdit(u64 entity);
 
         void DuplicateEntity(u64 entity);
 
+        // Spawns one instance of a prefab asset per transform (which replaces the transform of the prefab's root)
+        // and returns the UUIDs of the instances' roots
+        // NOTE: Instances get named like any other entity, so FindEntity finds the last instance spawned
+        // NOTE: Instances share the prefab's defaults (see Prefab), so this is a lot cheaper than DuplicateEntity,
+        // all the entities and components get created in bulk, one component pool at a time
+        std::vector<u64> InstantiatePrefab(u64 prefab, const std::vector<TransformComponent>& transforms);
+        u64 InstantiatePrefab(u64 prefab, const TransformComponent& transform);
+
         void DestroyEntity(u64 uuid);
+        // Destroys all the entities (and their children) at once, uuids which don't exist (anymore) get skipped
+        void DestroyEntities(const std::vector<u64>& uuids);
+
+        // Structural changes recorded here get applied at the sync points in OnUpdateRuntime
+        // NOTE: Use this instead of creating/destroying entities directly from scripts, callbacks or other threads
+        EntityCommandBuffer& GetCommandBuffer();
+
+        // The systems OnUpdateRuntime runs (between the two command buffer sync points), add your own systems here
+        // NOTE: The engine systems (Scene::Transforms, Scene::Physics) get registered first, so a user system which conflicts
+        // with them runs after them (see SystemScheduler). The scripts aren't a system, they run on their own right before the systems
+        SystemScheduler& GetSystems();
+
+        // Streams the partition's cells in and out around the active camera while the scene runs (from OnRuntimeStart to OnRuntimeStop),
+        // the scene should be the partition's persistent scene (see WorldPartition::Build)
+        // NOTE: Scenes opened from a partition's Persistent.blscene get this set up by Scene::Create
+        void SetWorldPartition(const WorldPartitionSpecification& spec);
+        // nullptr if the scene isn't partitioned or isn't running
+        WorldPartition* GetWorldPartition();
 
         void SetPaused(bool pause);
         bool IsPaused() const;
 
+        // NOTE: Creates the entity if there is none with that name, use FindEntity to only look it up
         EntityID GetEntity(const std::string& name);
+        // Returns the entity with the name (entt::null if there is none), this never allocates or creates anything
+        // e.g. FindEntity("Player"_hs) doesn't even hash the name at runtime
+        // NOTE: If several entities have the same name the one which got named last gets found
+        EntityID FindEntity(HashedString name) const;
+        // Renames the entity, use this instead of changing TagComponent::Name directly (otherwise FindEntity still uses the old name)
+        void SetEntityName(u64 uuid, InternedString name);
         EntityID GetEntityFromUUID(u64 uuid);
         std::vector<EntityID> GetEntities();
 
+        // Recomputes the cached world transforms (WorldTransformComponent) of every entity whose local transform
+        // (or one of whose parents) changed since the last update, this is a linear scan over the hierarchy
+        // NOTE: Every root entity is an independent subtree, so big scenes get split across the scene's thread pool
+        void UpdateWorldTransforms();
+
         // NOTE: This gets ALL of the parent's transforms, not just one
         TransformComponent GetEntityParentTransform(EntityID e);
+        // NOTE: Both of these return world space transforms, the cached one from the last UpdateWorldTransforms unless the entity
+        // or one of its parents got marked as changed since then (then it gets computed from the parents' local transforms)
         TransformComponent GetEntityTransform(EntityID e);
+        BlMat4 GetEntityWorldMatrix(EntityID e);
+
+        // Converts a world space transform into the entity's local space and applies it
+        void SetEntityWorldTransform(EntityID e, const TransformComponent& world);
 
         ECS* GetECS();
         PhysicsEngine* GetPhysicsEngine();
         SceneRenderer* GetSceneRenderer();
 
-        std::vector<u64>& GetRootEntities();
+        // NOTE: If no thread pool is set the global one (ThreadPool::Get()) gets used, single threaded scenes use one without any threads
+        void SetThreadPool(ThreadPool* pool);
+        ThreadPool* GetThreadPool();
+
+        // The input the scene's scripts read, only headless scenes have their own (nullptr otherwise, they read the window's)
+        // e.g. Input::SetCurrentState(scene->GetInputState()) and then Input::SetKeyState to press a key
+        InputState* GetInputState();
+
+        // Spatial queries over every entity with a mesh, light or collider (see BoundingVolumeHierarchy)
+        // NOTE: The index gets updated at the end of UpdateWorldTransforms, so the results are as of the last update
+        const BoundingVolumeHierarchy& GetSpatialIndex() const;
+        void QueryBox(const AABB& box, std::vector<EntityID>& outEntities) const;
+        void QuerySphere(const BlVec3& center, f32 radius, std::vector<EntityID>& outEntities) const;
+        void QueryFrustum(const Frustum& frustum, std::vector<EntityID>& outEntities) const;
+        // Returns the closest entity whose bounds the ray hits (entt::null if there is none)
+        EntityID Raycast(const Ray& ray, f32 maxDistance, f32* outDistance = nullptr) const;
+        // World space bounds of the entity as of the last update (an invalid box if it isn't in the spatial index)
+        AABB GetEntityBounds(EntityID entity) const;
+
+        // Must be called after changing something that changes an entity's size without touching its transform
+        // (e.g. a light's radius or a mesh's model), adding/removing components and moving entities gets picked up automatically
+        void MarkBoundsDirty(EntityID entity);
+
+        std::vector<u64> GetRootEntities();
+        // NOTE: The hierarchy gets rebuilt first if it is out of date
+        const SceneHierarchy& GetHierarchy();
+
+    private:
+        // Creates a scene which uses the given renderer and physics world instead of creating its own
+        Scene(const SceneSpecification& spec, SceneRenderer* renderer, PhysicsEngine* physicsWorld);
+
+        // The component pools used by the world transform update (see scene.cpp)
+        struct WorldTransformPools;
+
+        void UpdateRuntime(f32 deltaTime);
+        // Calls OnUpdate of every script (on the calling thread, the scripts can touch any component)
+        void RunScripts(f32 deltaTime);
+
+        // Makes the scene's Lua context, input and project the current ones on the calling thread while it lives
+        class ExecutionScope;
+
+        // Recomputes the world transforms of the whole subtree starting at the hierarchy node root
+        void UpdateWorldTransforms(WorldTransformPools& pools, u32 root);
+        // Makes the next UpdateWorldTransforms recompute the entity's subtree
+        void MarkTransformDirty(u64 uuid);
+        // True if neither the entity nor any of its parents got marked as changed since the last UpdateWorldTransforms
+        bool IsWorldTransformUpToDate(EntityID e) const;
+
+        // Removes the entity from its parent's and siblings' RelationshipComponents
+        void UnlinkEntity(u64 uuid);
+        // Removes the entity's name from the name table (unless another entity took the name over since)
+        void UnregisterEntityName(u64 uuid, EntityID entity);
+
+        // Rebuilds the hierarchy from the RelationshipComponents if FinishEntityEdit found it to be out of date
+        void RefreshHierarchy();
+        void AppendToHierarchy(u64 uuid, i32 parent);
+
+        void RegisterEngineSystems();
+
+        // Brings the spatial index up to date with the entities whose world transform changed in the last update
+        // and the ones whose bounded components got added/removed (or were marked with MarkBoundsDirty)
+        void UpdateSpatialIndex();
+        void RefreshEntityBounds(EntityID entity);
+        // Returns false if the entity has no component with a size (so it doesn't belong in the spatial index),
+        // outExact is false if the bounds are only a guess (e.g. the mesh asset isn't loaded yet)
+        bool ComputeEntityBounds(EntityID entity, AABB& outBounds, bool& outExact);
+
+        void ConnectSpatialIndex();
+        void OnBoundsComponentChanged(entt::registry& registry, entt::entity entity);
 
     private:
         ECS* m_ECS = nullptr;
         PhysicsEngine* m_PhysicsWorld = nullptr;
         SceneRenderer* m_Renderer = nullptr;
-        std::unordered_map<u64, EntityID> m_EntityMap;
-        std::vector<u64> m_RootEntities;
-        std::unordered_map<std::string, u64> m_NamedEntityMap;
+        ThreadPool* m_ThreadPool = nullptr;
+        EntityIndex m_EntityMap;
+        SceneHierarchy m_Hierarchy;
+        bool m_HierarchyDirty = false;
+        FlatIndex<u64> m_NamedEntities; // name hash (HashedString) -> UUID
 
         const f32 m_Gravity = 9.8f;
 
+        SceneSpecification m_Specification;
+
+        // NOTE: Everything the scene runs its scripts with is per scene (see ExecutionScope), so several scenes can update at once
+        Lua::Context* m_LuaContext = nullptr; // created by OnRuntimeStart
+        InputState* m_Input = nullptr; // headless scenes only
+
+        std::optional<WorldPartitionSpecification> m_PartitionSpecification;
+        WorldPartition* m_WorldPartition = nullptr; // created by OnRuntimeStart
+
         f32 m_PhysicsTickTime = 0.0f;
+        f64 m_Time = 0.0;
+        u64 m_FrameCount = 0;
 
         bool m_Paused = false;
+        bool m_OwnsResources = false; // false if the renderer and physics world are shared with another scene
+
+        // The world transform each hierarchy node passes down to its children (scratch memory for UpdateWorldTransforms)
+        std::vector<const WorldTransformComponent*> m_PropagatedTransforms;
+        std::vector<u32> m_DirtySubtrees; // the hierarchy nodes whose subtrees get recomputed in the current update
+        u32 m_TransformVersion = 0; // the ECS version the world transforms were last brought up to date with
+
+        EntityCommandBuffer m_CommandBuffer;
+        SystemScheduler m_Systems;
+
+        struct SpatialProxy {
+            i32 Proxy = BoundingVolumeHierarchy::s_NullNode;
+            AABB Bounds; // the exact bounds (the tree only knows the fat ones)
+        };
+
+        BoundingVolumeHierarchy m_SpatialIndex;
+        std::vector<SpatialProxy> m_SpatialProxies; // indexed by entt::to_entity
+        std::vector<EntityID> m_PendingBounds; // entities to refresh on the next update (may contain duplicates and destroyed entities)
+        u32 m_SpatialIndexVersion = 0; // the ECS version the spatial index was last brought up to date with
+
+        // Below this many dirty subtrees the world transforms are updated on the calling thread (not worth waking up the workers)
+        static constexpr u32 s_ParallelTransformThreshold = 64;
+
+        // The physics always runs at a fixed rate, no matter how long the frames are
+        static constexpr f32 s_PhysicsTimeStep = 1.0f / 60.0f;
 
         friend class Entity;
         friend class SceneRenderer;
+        friend class EntityCommandBuffer;
     };
 
 } // namespace Blackberry
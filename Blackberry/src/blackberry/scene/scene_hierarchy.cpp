@@ -0,0 +1,190 @@
+#include "blackberry/scene/scene_hierarchy.hpp"
+#include "blackberry/core/util.hpp"
+
+#include <algorithm>
+
+namespace Blackberry {
+
+    void SceneHierarchy::Reserve(u32 count) {
+        m_Nodes.reserve(count);
+    }
+
+    void SceneHierarchy::Clear() {
+        m_Nodes.clear();
+        m_Positions.clear();
+    }
+
+    u32 SceneHierarchy::Append(u64 uuid, EntityID entity, i32 parent) {
+        BL_ASSERT(!Contains(entity), "Entity {} is already in the hierarchy!", static_cast<u32>(entity));
+        BL_ASSERT(parent < 0 || parent + m_Nodes[parent].SubtreeSize == m_Nodes.size(), "Appending would break the depth first order!");
+
+        u32 index = static_cast<u32>(m_Nodes.size());
+        m_Nodes.push_back({ uuid, entity, parent, 1 });
+
+        AddToSubtreeSizes(parent, 1);
+
+        u32 entityIndex = static_cast<u32>(entt::to_entity(entity));
+        if (entityIndex >= m_Positions.size()) {
+            m_Positions.resize(entityIndex + 1, s_InvalidIndex);
+        }
+        m_Positions[entityIndex] = index;
+
+        return index;
+    }
+
+    void SceneHierarchy::SetParent(EntityID entity, EntityID parent) {
+        u32 index = IndexOf(entity);
+        BL_ASSERT(index != s_InvalidIndex, "Entity {} is not in the hierarchy!", static_cast<u32>(entity));
+
+        if (parent == entt::null) {
+            if (m_Nodes[index].Parent < 0) return; // already a root entity
+
+            std::vector<Node> block = Extract(index);
+            Insert(static_cast<u32>(m_Nodes.size()), -1, block);
+
+            return;
+        }
+
+        u32 parentIndex = IndexOf(parent);
+        BL_ASSERT(parentIndex != s_InvalidIndex, "Entity {} is not in the hierarchy!", static_cast<u32>(parent));
+        BL_ASSERT(parentIndex < index || parentIndex >= index + m_Nodes[index].SubtreeSize, "Can't parent an entity to one of its own children!");
+
+        if (m_Nodes[index].Parent == static_cast<i32>(parentIndex) && index == parentIndex + 1) return; // already the first child
+
+        std::vector<Node> block = Extract(index);
+
+        parentIndex = IndexOf(parent); // the parent moved if it came after the extracted subtree
+        Insert(parentIndex + 1, static_cast<i32>(parentIndex), block);
+    }
+
+    void SceneHierarchy::Remove(EntityID entity) {
+        u32 index = IndexOf(entity);
+        BL_ASSERT(index != s_InvalidIndex, "Entity {} is not in the hierarchy!", static_cast<u32>(entity));
+
+        Extract(index);
+    }
+
+    void SceneHierarchy::Remove(const std::vector<EntityID>& entities, std::vector<Node>& removedNodes) {
+        std::vector<u32> indices;
+        indices.reserve(entities.size());
+
+        for (EntityID entity : entities) {
+            u32 index = IndexOf(entity);
+            BL_ASSERT(index != s_InvalidIndex, "Entity {} is not in the hierarchy!", static_cast<u32>(entity));
+
+            indices.push_back(index);
+        }
+
+        // Parents come before their children, so going in order means a subtree always gets marked before anything inside of it
+        std::sort(indices.begin(), indices.end());
+
+        std::vector<u8> removed(m_Nodes.size(), false);
+
+        for (u32 index : indices) {
+            if (removed[index]) continue; // part of a subtree which got removed already
+
+            u32 count = m_Nodes[index].SubtreeSize;
+            std::fill(removed.begin() + index, removed.begin() + index + count, true);
+
+            AddToSubtreeSizes(m_Nodes[index].Parent, -static_cast<i32>(count));
+        }
+
+        // Compact everything that is left (remapping the parent indices on the way)
+        std::vector<i32> newIndices(m_Nodes.size(), -1);
+        u32 count = 0;
+
+        for (u32 i = 0; i < m_Nodes.size(); i++) {
+            Node& node = m_Nodes[i];
+
+            if (removed[i]) {
+                m_Positions[entt::to_entity(node.Entity)] = s_InvalidIndex;
+                removedNodes.push_back(node);
+
+                continue;
+            }
+
+            node.Parent = node.Parent < 0 ? -1 : newIndices[node.Parent]; // the parent always survives if its child does
+            newIndices[i] = static_cast<i32>(count);
+
+            m_Positions[entt::to_entity(node.Entity)] = count;
+            m_Nodes[count++] = node;
+        }
+
+        m_Nodes.resize(count);
+    }
+
+    u32 SceneHierarchy::IndexOf(EntityID entity) const {
+        u32 entityIndex = static_cast<u32>(entt::to_entity(entity));
+        if (entityIndex >= m_Positions.size()) return s_InvalidIndex;
+
+        // NOTE: The entity index may have been reused by a newer version of the entity
+        u32 index = m_Positions[entityIndex];
+        if (index == s_InvalidIndex || m_Nodes[index].Entity != entity) return s_InvalidIndex;
+
+        return index;
+    }
+
+    bool SceneHierarchy::Contains(EntityID entity) const {
+        return IndexOf(entity) != s_InvalidIndex;
+    }
+
+    std::vector<SceneHierarchy::Node> SceneHierarchy::Extract(u32 index) {
+        u32 count = m_Nodes[index].SubtreeSize;
+        i32 parent = m_Nodes[index].Parent;
+
+        std::vector<Node> block(m_Nodes.begin() + index, m_Nodes.begin() + index + count);
+        for (Node& node : block) {
+            node.Parent = node.Parent < static_cast<i32>(index) ? -1 : node.Parent - static_cast<i32>(index);
+            m_Positions[entt::to_entity(node.Entity)] = s_InvalidIndex;
+        }
+
+        AddToSubtreeSizes(parent, -static_cast<i32>(count));
+
+        m_Nodes.erase(m_Nodes.begin() + index, m_Nodes.begin() + index + count);
+
+        // Everything after the subtree moved back by count (parents always come before their children,
+        // so only the nodes after index can have a parent which moved)
+        for (u32 i = index; i < m_Nodes.size(); i++) {
+            if (m_Nodes[i].Parent > static_cast<i32>(index)) {
+                m_Nodes[i].Parent -= static_cast<i32>(count);
+            }
+        }
+
+        UpdatePositions(index);
+
+        return block;
+    }
+
+    void SceneHierarchy::Insert(u32 position, i32 parent, std::vector<Node>& block) {
+        u32 count = static_cast<u32>(block.size());
+
+        for (u32 i = position; i < m_Nodes.size(); i++) {
+            if (m_Nodes[i].Parent >= static_cast<i32>(position)) {
+                m_Nodes[i].Parent += static_cast<i32>(count);
+            }
+        }
+
+        for (Node& node : block) {
+            node.Parent = node.Parent < 0 ? parent : node.Parent + static_cast<i32>(position);
+        }
+
+        m_Nodes.insert(m_Nodes.begin() + position, block.begin(), block.end());
+
+        AddToSubtreeSizes(parent, static_cast<i32>(count));
+        UpdatePositions(position);
+    }
+
+    void SceneHierarchy::AddToSubtreeSizes(i32 node, i32 amount) {
+        while (node >= 0) {
+            m_Nodes[node].SubtreeSize += amount;
+            node = m_Nodes[node].Parent;
+        }
+    }
+
+    void SceneHierarchy::UpdatePositions(u32 begin) {
+        for (u32 i = begin; i < m_Nodes.size(); i++) {
+            m_Positions[entt::to_entity(m_Nodes[i].Entity)] = i;
+        }
+    }
+
+} // namespace Blackberry
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "blackberry/core/types.hpp"
+#include "blackberry/ecs/ecs.hpp"
+
+#include <vector>
+
+namespace Blackberry {
+
+    // The scene's entity hierarchy packed into one array in depth first order
+    //
+    // Every node stores the index of its parent and the size of its subtree, so a node's descendants are always
+    // the SubtreeSize - 1 nodes right after it and a parent always comes before its children.
+    // This turns walking the hierarchy into a linear scan (no hash lookups, no pointer chasing),
+    // e.g. the nodes of a root entity's subtree are [root, root + SubtreeSize)
+    //
+    // NOTE: Children are ordered the same way as in RelationshipComponent (SetParent makes the entity the first child)
+    class SceneHierarchy {
+    public:
+        struct Node {
+            u64 UUID = 0;
+            EntityID Entity = entt::null;
+            i32 Parent = -1; // index of the parent node (-1 for root entities)
+            u32 SubtreeSize = 1; // the node itself + all of its descendants
+        };
+
+        static constexpr u32 s_InvalidIndex = ~0u;
+
+    public:
+        void Reserve(u32 count);
+        void Clear();
+
+        // Adds the entity as the last node of the array, parent MUST either be -1 (new root entity)
+        // or the index of a node whose subtree ends at the end of the array (used to build the hierarchy in depth first order)
+        u32 Append(u64 uuid, EntityID entity, i32 parent = -1);
+
+        // Moves the entity (and its whole subtree) to be the first child of parent
+        // NOTE: Passing entt::null makes the entity a root entity (placed after every other root)
+        void SetParent(EntityID entity, EntityID parent);
+
+        // Removes the entity and its whole subtree
+        void Remove(EntityID entity);
+        // Removes the subtrees of all the entities in one pass over the array (entities may be each other's children)
+        // NOTE: Every removed node gets added to removedNodes
+        void Remove(const std::vector<EntityID>& entities, std::vector<Node>& removedNodes);
+
+        u32 IndexOf(EntityID entity) const;
+        bool Contains(EntityID entity) const;
+
+        // Calls func(u32 index) for the node of every root entity (in order)
+        template <typename Func>
+        void EachRoot(Func&& func) const {
+            for (u32 i = 0; i < m_Nodes.size(); i += m_Nodes[i].SubtreeSize) {
+                func(i);
+            }
+        }
+
+        const Node& operator[](u32 index) const { return m_Nodes[index]; }
+        const std::vector<Node>& GetNodes() const { return m_Nodes; }
+        u32 Size() const { return static_cast<u32>(m_Nodes.size()); }
+
+    private:
+        // Takes the subtree starting at index out of the array (the parents in the returned block are relative to its start)
+        std::vector<Node> Extract(u32 index);
+        // Inserts a block returned by Extract at position as a child of parent
+        void Insert(u32 position, i32 parent, std::vector<Node>& block);
+
+        void AddToSubtreeSizes(i32 node, i32 amount);
+        void UpdatePositions(u32 begin);
+
+    private:
+        std::vector<Node> m_Nodes;
+        std::vector<u32> m_Positions; // entity index (entt::to_entity) -> node index
+    };
+
+} // namespace Blackberry
@@ -13,6 +13,23 @@ namespace Blackberry {
 
     static const Material DEFAULT_MATERIAL = Material::Create();
 
+    static GPUMaterial ToGPUMaterial(const Material& mat) {
+        GPUMaterial gpuMat;
+
+        gpuMat.AlbedoTexture = mat.UseAlbedoTexture ? mat.AlbedoTexture->BindlessHandle : 0;
+        gpuMat.MetallicTexture = mat.UseMetallicTexture ? mat.MetallicTexture->BindlessHandle : 0;
+        gpuMat.RoughnessTexture = mat.UseRoughnessTexture ? mat.RoughnessTexture->BindlessHandle : 0;
+        gpuMat.AOTexture = mat.UseAOTexture ? mat.AOTexture->BindlessHandle : 0;
+
+        gpuMat.AlbedoColor = mat.AlbedoColor;
+        gpuMat.MetallicFactor = mat.MetallicFactor;
+        gpuMat.RoughnessFactor = mat.RoughnessFactor;
+        gpuMat.AOFactor = mat.AOFactor;
+        gpuMat.Emission = mat.Emission;
+
+        return gpuMat;
+    }
+
     static BlVec4 NormalizeColor(BlColor color) {
         return BlVec4(
             static_cast<f32>(color.r) / 255.0f,
@@ -25,17 +42,6 @@ namespace Blackberry {
     SceneRenderer::SceneRenderer(Scene* scene) {
         m_Context = scene;
 
-        Ref<VertexBuffer> vbo = VertexBuffer::Create(BufferUsage::Dynamic);
-        Ref<IndexBuffer> ibo = IndexBuffer::Create(BufferUsage::Dynamic);
-        m_State.GeometryBuffer = VertexArray::Create();
-        m_State.GeometryBuffer->SetVertexBuffer(vbo);
-        m_State.GeometryBuffer->SetIndexBuffer(ibo);
-        m_State.GeometryBuffer->SetVertexLayout({
-           {0, ShaderDataType::Float3, "Position"},
-           {1, ShaderDataType::Float3, "Normal"},
-           {2, ShaderDataType::Float2, "TexCoord"}
-        });
-
         m_State.MeshGeometryShader = Shader::Create(FS::Path("Assets/Shaders/Default/GeometryPass.vert"), FS::Path("Assets/Shaders/Default/GeometryPass.frag"));
         m_State.MeshLightingShader = Shader::Create(FS::Path("Assets/Shaders/Default/Core/Quad.vert"), FS::Path("Assets/Shaders/Default/LightingPass.frag"));
         m_State.SkyboxShader = Shader::Create(FS::Path("Assets/Shaders/Default/Skybox.vert"), FS::Path("Assets/Shaders/Default/Skybox.frag"));
@@ -60,6 +66,11 @@ namespace Blackberry {
         m_State.PointLightBuffer = ShaderStorageBuffer::Create(3);
         m_State.SpotLightBuffer = ShaderStorageBuffer::Create(4);
 
+        // Slot 0 is for materials without an ID
+        m_State.Materials.push_back(GPUMaterial{});
+        m_State.MaterialVersions.push_back(0);
+        m_State.MaterialDirtyEnd = 1;
+
         {
             FramebufferSpecification spec;
             spec.Width = 1920;
@@ -139,53 +150,29 @@ namespace Blackberry {
                 spec.Height *= 0.5f;
             }
         }
+
+        RegisterExtractionSystems();
     }
 
     // SceneRenderer::~SceneRenderer() {}
 
     void SceneRenderer::Render(Scene* scene) {
+        m_Context = scene; // the renderer can be shared between scenes (see Scene::Copy)
+
         {
             BL_PROFILE_SCOPE("SceneRenderer::Render");
 
             {
-                auto view = scene->m_ECS->GetEntitiesWithComponents<TransformComponent, DirectionalLightComponent>();
-                
-                view.each([&](TransformComponent& transform, DirectionalLightComponent& light) {
-                    AddDirectionalLight(transform, light);    
-                });
-            }
-            
-            {
-                auto view = scene->m_ECS->GetEntitiesWithComponents<TransformComponent, PointLightComponent>();
-                
-                view.each([&](TransformComponent& transform, PointLightComponent& light) {
-                    AddPointLight(transform, light);
-                });
-            }
-            
-            {
-                auto view = scene->m_ECS->GetEntitiesWithComponents<TransformComponent, SpotLightComponent>();
-                
-                view.each([&](TransformComponent& transform, SpotLightComponent& light) {
-                    AddSpotLight(transform, light);
-                });
-            }
-           
-            {
-                auto view = scene->m_ECS->GetEntitiesWithComponents<TransformComponent, MeshComponent>();
-                
-                view.each([&](entt::entity id, TransformComponent& transform, MeshComponent& mesh) {
-                    AddModel(transform, mesh, BlColor(255, 255, 255, 255), static_cast<u32>(id));
-                });
-            }
-            
-            {
-                auto view = scene->m_ECS->GetEntitiesWithComponents<EnvironmentComponent>();
-                
-                view.each([&](EnvironmentComponent& env) {
-                    AddEnvironment(env);
-                });
+                BL_PROFILE_SCOPE("SceneRenderer::Cull");
+
+                m_Frustum = Frustum::FromMatrix(m_Camera.GetCameraMatrix());
+
+                m_VisibleEntities.clear();
+                scene->QueryFrustum(m_Frustum, m_VisibleEntities);
             }
+
+            // NOTE: Extraction doesn't depend on the frame time
+            m_ExtractionSystems.Run(scene, 0.0f, scene->GetThreadPool());
         }
 
         Flush();
@@ -205,74 +192,152 @@ namespace Blackberry {
 
     void SceneRenderer::RenderEntity(Entity entity) {
         if (entity.HasComponent<TransformComponent>() && entity.HasComponent<MeshComponent>()) {
-            auto& transform = entity.GetComponent<TransformComponent>();
-            auto& mesh = entity.GetComponent<MeshComponent>();
+            BlMat4 transform = m_Context->GetEntityWorldMatrix(entity.ID);
+            auto& mesh = entity.GetComponent<const MeshComponent>();
 
-            AddModel(transform, mesh, BlColor(255, 255, 255, 255), static_cast<u32>(entity.ID));
+            const MeshComponent* defaults = nullptr;
+            if (entity.HasComponent<PrefabInstanceComponent>()) {
+                defaults = GetPrefabMeshDefaults(entity.GetComponent<const PrefabInstanceComponent>());
+            }
+
+            AddModel(transform, mesh, BlColor(255, 255, 255, 255), static_cast<u32>(entity.ID), defaults);
         }
     }
 
-    void SceneRenderer::AddMesh(const TransformComponent& transform, const Mesh& mesh, const Material& mat, BlColor color, u32 entityID, u32 meshIndex) {
-        // We only need send vertices once per mesh
-        if (!m_State.Meshes[entityID].contains(meshIndex)) {
-            auto& meshInstance = m_State.Meshes[entityID][meshIndex];
-            meshInstance.MeshVertices.reserve(mesh.Positions.size());
-            meshInstance.MeshIndices.reserve(mesh.Indices.size());
+    SystemScheduler& SceneRenderer::GetExtractionSystems() {
+        return m_ExtractionSystems;
+    }
 
-            BlVec4 normColor = NormalizeColor(color);
+    void SceneRenderer::RegisterExtractionSystems() {
+        // NOTE: Every extraction system fills its own part of m_State, so the lights get gathered on a worker
+        // while the main thread goes through the meshes (those need the asset manager, which isn't thread safe)
+        m_ExtractionSystems.AddSystem({
+            "SceneRenderer::ExtractLights",
+            AllComponents::MaskOf<WorldTransformComponent, DirectionalLightComponent, PointLightComponent, SpotLightComponent>(),
+            0,
+            false
+        }, [this](Scene* scene, f32) {
+            {
+                auto view = scene->m_ECS->GetEntitiesWithComponents<const WorldTransformComponent, const DirectionalLightComponent>();
 
-            // vertices
-            for (u32 i = 0; i < mesh.Positions.size(); i++) {
-                SceneMeshVertex vert = SceneMeshVertex(mesh.Positions[i], mesh.Normals[i], mesh.TexCoords[i]);
-                meshInstance.MeshVertices.push_back(vert);
+                view.each([&](const WorldTransformComponent& transform, const DirectionalLightComponent& light) {
+                    AddDirectionalLight(transform, light);
+                });
             }
 
-            // indices
-            for (u32 i = 0; i < mesh.Indices.size(); i++) {
-                meshInstance.MeshIndices.push_back(mesh.Indices[i]);
+            {
+                // NOTE: A point light's bounds cover its whole radius, so the ones outside the frustum can't light anything visible
+                auto& lights = scene->m_ECS->GetPool<const PointLightComponent>();
+                auto& transforms = scene->m_ECS->GetPool<const WorldTransformComponent>();
+
+                for (EntityID entity : m_VisibleEntities) {
+                    if (lights.contains(entity) && transforms.contains(entity)) {
+                        AddPointLight(transforms.get(entity), lights.get(entity));
+                    }
+                }
             }
-        }
 
-        auto& meshInstance = m_State.Meshes[entityID][meshIndex];
+            {
+                // NOTE: Spot lights reach infinitely far (their bounds are only for picking), so they get tested by their cone instead,
+                // the ones outside the frustum which point away from it can't light anything visible
+                auto group = scene->m_ECS->GetGroup<const SpotLightComponent>(entt::get<const WorldTransformComponent>);
 
-        TransformComponent transformMat = m_Context->GetEntityTransform(static_cast<EntityID>(entityID));
-        BlMat4 final = transformMat.GetMatrix() * mesh.Transform;
+                group.each([&](const SpotLightComponent& light, const WorldTransformComponent& transform) {
+                    BlVec3 direction = BlVec3(transform.Rotation.x, transform.Rotation.y, transform.Rotation.z); // same as AddSpotLight
+
+                    if (m_Frustum.OverlapsCone(transform.Position, direction, glm::radians(light.Cutoff))) {
+                        AddSpotLight(transform, light);
+                    }
+                });
+            }
+        });
+
+        m_ExtractionSystems.AddSystem({
+            "SceneRenderer::ExtractMeshes",
+            AllComponents::MaskOf<WorldTransformComponent, MeshComponent, PrefabInstanceComponent>(),
+            0,
+            true
+        }, [this](Scene* scene, f32) {
+            // NOTE: Only the meshes the spatial index found in the frustum (see Render)
+            auto& meshes = scene->m_ECS->GetPool<const MeshComponent>();
+            auto& transforms = scene->m_ECS->GetPool<const WorldTransformComponent>();
+            auto& instances = scene->m_ECS->GetPool<const PrefabInstanceComponent>();
+
+            // NOTE: Every prefab gets looked up in the asset manager once per frame, not once per instance
+            m_PrefabCache.clear();
+
+            for (EntityID entity : m_VisibleEntities) {
+                if (meshes.contains(entity) && transforms.contains(entity)) {
+                    const MeshComponent* defaults = instances.contains(entity) ? GetCachedPrefabMeshDefaults(instances.get(entity)) : nullptr;
+
+                    AddModel(transforms.get(entity).Matrix, meshes.get(entity), BlColor(255, 255, 255, 255), static_cast<u32>(entity), defaults);
+                }
+            }
+        });
+
+        m_ExtractionSystems.AddSystem({
+            "SceneRenderer::ExtractEnvironment",
+            AllComponents::MaskOf<EnvironmentComponent>(),
+            0,
+            true
+        }, [this](Scene* scene, f32) {
+            auto view = scene->m_ECS->GetEntitiesWithComponents<const EnvironmentComponent>();
+
+            view.each([&](const EnvironmentComponent& env) {
+                AddEnvironment(env);
+            });
+        });
+    }
+
+    void SceneRenderer::AddMesh(const BlMat4& transform, const Mesh& mesh, const Material& mat, BlColor color, u32 entityID, const MeshBatchKey& key) {
+        // NOTE: The vertices got uploaded when the model got loaded (see MeshArena), only the offsets are needed here
+        if (!mesh.Allocation.IsValid()) return;
+
+        auto& meshInstance = m_State.Meshes[key];
+        meshInstance.Allocation = mesh.Allocation;
+
+        BlMat4 final = transform * mesh.Transform;
 
-        GPUMaterial gpuMat;
-        
-        if (mat.ID != 0) {
-            gpuMat.UseAlbedoTexture = mat.UseAlbedoTexture;
-            gpuMat.AlbedoTexture = mat.AlbedoTexture->BindlessHandle;
-            gpuMat.AlbedoColor = mat.AlbedoColor;
-            
-            gpuMat.UseMetallicTexture = mat.UseMetallicTexture;
-            gpuMat.MetallicTexture = mat.MetallicTexture->BindlessHandle;
-            gpuMat.MetallicFactor = mat.MetallicFactor;
-            
-            gpuMat.UseRoughnessTexture = mat.UseRoughnessTexture;
-            gpuMat.RoughnessTexture = mat.RoughnessTexture->BindlessHandle;
-            gpuMat.RoughnessFactor = mat.RoughnessFactor;
-            
-            gpuMat.UseAOTexture = mat.UseAOTexture;
-            gpuMat.AOTexture = mat.AOTexture->BindlessHandle;
-            gpuMat.AOFactor = mat.AOFactor;
-        
-            gpuMat.Emission = mat.Emission;
-        }
-        
-        meshInstance.MaterialData.push_back(gpuMat);
-        
         GPUInstanceData data;
         data.Transform = final;
-        data.MaterialIndex = meshInstance.MaterialData.size() - 1;
+        data.MaterialIndex = GetMaterialIndex(mat);
         data.EntityID = entityID;
+
+        // NOTE: The entity was in the frustum, but a model's meshes can still be outside of it (e.g. a big building)
+        if (m_State.MeshCullingEnabled && mesh.Bounds.IsValid()) {
+            m_State.CullBoxes.Add(mesh.Bounds.Transform(final));
+            m_State.PendingInstances.push_back({ &meshInstance, data });
+            return;
+        }
         
         meshInstance.InstanceData.push_back(data);
 
         meshInstance.InstanceCount++;
     }
 
-    void SceneRenderer::AddModel(const TransformComponent& transform, const MeshComponent& model, BlColor color, u32 entityID) {
+    const MeshComponent* SceneRenderer::GetPrefabMeshDefaults(const PrefabInstanceComponent& instance) {
+        AssetManager& assets = Project::GetAssetManager();
+        if (!assets.ContainsAsset(instance.Prefab)) return nullptr;
+
+        const Ref<Prefab>& prefab = std::get<Ref<Prefab>>(assets.GetAsset(instance.Prefab).Data);
+        return prefab->GetMeshDefaults(instance.Node);
+    }
+
+    const MeshComponent* SceneRenderer::GetCachedPrefabMeshDefaults(const PrefabInstanceComponent& instance) {
+        auto [it, inserted] = m_PrefabCache.try_emplace(instance.Prefab, nullptr);
+
+        if (inserted) {
+            AssetManager& assets = Project::GetAssetManager();
+
+            if (assets.ContainsAsset(instance.Prefab)) {
+                it->second = std::get<Ref<Prefab>>(assets.GetAsset(instance.Prefab).Data).Data();
+            }
+        }
+
+        return it->second ? it->second->GetMeshDefaults(instance.Node) : nullptr;
+    }
+
+    void SceneRenderer::AddModel(const BlMat4& transform, const MeshComponent& model, BlColor color, u32 entityID, const MeshComponent* defaults) {
         if (Project::GetAssetManager().ContainsAsset(model.MeshHandle)) {
             const Asset& asset = Project::GetAssetManager().GetAsset(model.MeshHandle);
             auto& trueModel = std::get<Model>(asset.Data);
@@ -283,19 +348,22 @@ namespace Blackberry {
 
                 mat = &trueModel.Materials[mesh.MaterialIndex];
 
-                if (model.MaterialHandles.contains(mesh.MaterialIndex)) {
-                    u64 matHandle = model.MaterialHandles.at(mesh.MaterialIndex);
-                    if (Project::GetAssetManager().ContainsAsset(matHandle)) {
-                        mat = &std::get<Material>(Project::GetAssetManager().GetAsset(matHandle).Data);
-                    }
+                // NOTE: A handle of 0 means the material isn't overridden
+                u64 matHandle = model.MaterialHandles.Get(mesh.MaterialIndex);
+                if (matHandle == 0 && defaults) {
+                    matHandle = defaults->MaterialHandles.Get(mesh.MaterialIndex);
                 }
 
-                AddMesh(transform, trueModel.Meshes[i], *mat, color, entityID, i);
+                if (matHandle != 0 && Project::GetAssetManager().ContainsAsset(matHandle)) {
+                    mat = &std::get<Material>(Project::GetAssetManager().GetAsset(matHandle).Data);
+                }
+
+                AddMesh(transform, trueModel.Meshes[i], *mat, color, entityID, { model.MeshHandle, i });
             }
         }
     }
 
-    void SceneRenderer::AddDirectionalLight(const TransformComponent& transform, const DirectionalLightComponent& light) {
+    void SceneRenderer::AddDirectionalLight(const WorldTransformComponent& transform, const DirectionalLightComponent& light) {
         GPUDirectionalLight l;
         l.Direction = BlVec4(transform.Rotation.x, transform.Rotation.y, transform.Rotation.z, 0.0f);
         l.Color = BlVec4(light.Color.x, light.Color.y, light.Color.z, 0.0f);
@@ -304,7 +372,7 @@ namespace Blackberry {
         m_State.DirectionalLight = l;
     }
 
-    void SceneRenderer::AddPointLight(const TransformComponent& transform, const PointLightComponent& light) {
+    void SceneRenderer::AddPointLight(const WorldTransformComponent& transform, const PointLightComponent& light) {
         GPUPointLight l;
         l.Position = BlVec4(transform.Position.x, transform.Position.y, transform.Position.z, 0.0f);
         l.Color = BlVec4(light.Color.x, light.Color.y, light.Color.z, 0.0f);
@@ -313,7 +381,7 @@ namespace Blackberry {
         m_State.PointLights.push_back(l);
     }
 
-    void SceneRenderer::AddSpotLight(const TransformComponent& transform, const SpotLightComponent& light) {
+    void SceneRenderer::AddSpotLight(const WorldTransformComponent& transform, const SpotLightComponent& light) {
         GPUSpotLight l;
         l.Position = BlVec4(transform.Position.x, transform.Position.y, transform.Position.z, 0.0f);
         l.Direction = BlVec4(transform.Rotation.x, transform.Rotation.y, transform.Rotation.z, glm::cos(glm::radians(light.Cutoff)));
@@ -362,29 +430,45 @@ namespace Blackberry {
         api.EnableCapability(RendererCapability::FaceCull);
         api.SetDepthFunc(DepthFunc::Lequal);
 
-        for (auto& [id, e] : m_State.Meshes) {
-            for (auto& [index, instance] : e) {
-                m_State.GeometryBuffer->GetVertexBuffer()->UpdateData(instance.MeshVertices.data(), sizeof(SceneMeshVertex), instance.MeshVertices.size());
-                m_State.GeometryBuffer->GetIndexBuffer()->UpdateData(instance.MeshIndices.data(), sizeof(u32), instance.MeshIndices.size());
+        CullMeshInstances();
+        UploadMaterials();
 
-                {
-                    BL_PROFILE_SCOPE("SceneRenderer::Flush/Passing instance data");
-                    m_State.InstanceDataBuffer.ReserveMemory(sizeof(GPUInstanceData) * instance.InstanceData.size(), instance.InstanceData.data());
-                }
+        m_State.InstanceData.clear();
+        m_State.DrawCommands.clear();
 
-                {
-                    BL_PROFILE_SCOPE("SceneRenderer::Flush/Passing materials");
-                    m_State.MaterialBuffer.ReserveMemory(sizeof(GPUMaterial) * instance.MaterialData.size(), instance.MaterialData.data());
-                }
+        // Every batch becomes one command and its instances get appended to the shared instance buffer
+        for (auto& [key, instance] : m_State.Meshes) {
+            if (instance.InstanceCount == 0) continue;
+
+            const MeshAllocation& mesh = instance.Allocation;
 
-                api.DrawVertexArrayInstanced(m_State.GeometryBuffer, instance.InstanceCount);
+            DrawIndexedIndirectCommand command;
+            command.IndexCount = mesh.IndexCount;
+            command.InstanceCount = instance.InstanceCount;
+            command.FirstIndex = mesh.FirstIndex;
+            command.BaseVertex = static_cast<i32>(mesh.BaseVertex);
+            command.BaseInstance = static_cast<u32>(m_State.InstanceData.size());
 
-                instance.InstanceCount = 0;
-                instance.InstanceData.clear();
-                instance.MaterialData.clear();
-                instance.MeshIndices.clear();
-                instance.MeshVertices.clear();
+            m_State.DrawCommands.push_back(command);
+            m_State.InstanceData.insert(m_State.InstanceData.end(), instance.InstanceData.begin(), instance.InstanceData.end());
+
+            instance.InstanceCount = 0;
+            instance.InstanceData.clear();
+        }
+
+        m_State.MeshDrawCalls = 0;
+
+        if (!m_State.DrawCommands.empty()) {
+            {
+                BL_PROFILE_SCOPE("SceneRenderer::Flush/Passing instance data");
+                m_State.InstanceDataBuffer.ReserveMemory(sizeof(GPUInstanceData) * m_State.InstanceData.size(), m_State.InstanceData.data());
             }
+
+            Ref<VertexArray>& arena = MeshArena::GetVertexArray();
+
+            // NOTE: No fallback, the engine needs a 4.6 context anyway (bindless textures, gl_BaseInstance in the shaders)
+            api.DrawIndexedIndirect(arena, m_State.DrawCommands);
+            m_State.MeshDrawCalls = 1;
         }
 
         api.UnBindFramebuffer();
@@ -590,43 +674,86 @@ namespace Blackberry {
     }
 
     u32 SceneRenderer::GetMaterialIndex(const Material& mat) {
-        if (mat.ID == 0) return 0; // default material
-
-        // u32 matIndex = 0;
-        // 
-        // if (m_State.MaterialIndex >= 16) {
-        //     Flush();
-        // }
-        // 
-        // bool texAlreadyExists = false;
-
-        // Loop through all of the current materials to see if we already have a
-        // matching material
-        // for (u32 i = 0; i < m_State.MaterialIndex; i++) {
-        //     if (mat.ID == m_State.Materials[i].ID) {
-        //         matIndex = i;
-        //         texAlreadyExists = true;
-        // 
-        //         break;
-        //     }
-        // }
-        // 
-        // // If we haven't found a suitable material we create a new slot
-        // if (!texAlreadyExists) {
-        //     matIndex = m_State.MaterialIndex;
-        // 
-        //     m_State.Materials[m_State.MaterialIndex] = mat;
-        //     m_State.MaterialIndex++;
-        //     texAlreadyExists = true;
-        // }
-
-        return 0;
+        if (mat.ID == 0) return 0;
+
+        u32 index = static_cast<u32>(m_State.Materials.size());
+        auto [it, inserted] = m_State.MaterialIndices.try_emplace(mat.ID, index);
+
+        if (inserted) {
+            m_State.Materials.push_back(ToGPUMaterial(mat));
+            m_State.MaterialVersions.push_back(mat.Version);
+        } else {
+            index = it->second;
+
+            if (m_State.MaterialVersions[index] == mat.Version) return index;
+
+            m_State.Materials[index] = ToGPUMaterial(mat);
+            m_State.MaterialVersions[index] = mat.Version;
+        }
+
+        if (m_State.MaterialDirtyBegin == m_State.MaterialDirtyEnd) {
+            m_State.MaterialDirtyBegin = index;
+            m_State.MaterialDirtyEnd = index + 1;
+        } else {
+            m_State.MaterialDirtyBegin = std::min(m_State.MaterialDirtyBegin, index);
+            m_State.MaterialDirtyEnd = std::max(m_State.MaterialDirtyEnd, index + 1);
+        }
+
+        return index;
+    }
+
+    void SceneRenderer::UploadMaterials() {
+        BL_PROFILE_SCOPE("SceneRenderer::UploadMaterials");
+
+        u32 count = static_cast<u32>(m_State.Materials.size());
+
+        if (count > m_State.MaterialBufferCapacity) {
+            // Out of room, the whole table goes into a bigger buffer
+            m_State.MaterialBufferCapacity = std::max(count, m_State.MaterialBufferCapacity * 2);
+
+            m_State.MaterialBuffer.ReserveMemory(sizeof(GPUMaterial) * m_State.MaterialBufferCapacity);
+            m_State.MaterialBuffer.UpdateMemory(0, sizeof(GPUMaterial) * count, m_State.Materials.data());
+        } else if (m_State.MaterialDirtyBegin != m_State.MaterialDirtyEnd) {
+            u32 begin = m_State.MaterialDirtyBegin;
+            u32 end = m_State.MaterialDirtyEnd;
+
+            m_State.MaterialBuffer.UpdateMemory(sizeof(GPUMaterial) * begin, sizeof(GPUMaterial) * (end - begin), m_State.Materials.data() + begin);
+        }
+
+        m_State.MaterialDirtyBegin = 0;
+        m_State.MaterialDirtyEnd = 0;
+
+        // NOTE: Every scene renderer has its own material buffer on the same binding
+        m_State.MaterialBuffer.Bind();
+    }
+
+    void SceneRenderer::CullMeshInstances() {
+        BL_PROFILE_SCOPE("SceneRenderer::CullMeshInstances");
+
+        Frustum frustum = Frustum::FromMatrix(m_Camera.GetCameraMatrix());
+        u32 visible = m_State.CullBoxes.Cull(frustum, m_State.CullResults);
+
+        for (u32 i = 0; i < m_State.PendingInstances.size(); i++) {
+            if (!m_State.CullResults[i]) continue;
+
+            PendingMeshInstance& pending = m_State.PendingInstances[i];
+            pending.Batch->InstanceData.push_back(pending.Data);
+            pending.Batch->InstanceCount++;
+        }
+
+        Instrumentor::AddCount("SceneRenderer::VisibleMeshInstances", visible);
+        Instrumentor::AddCount("SceneRenderer::CulledMeshInstances", m_State.CullBoxes.Size() - visible);
+
+        m_State.CullBoxes.Clear();
+        m_State.PendingInstances.clear();
     }
 
     void SceneRenderer::ResetState() {
         BL_PROFILE_SCOPE("SceneRenderer::ResetState");
 
         m_State.Meshes.clear();
+        m_State.CullBoxes.Clear();
+        m_State.PendingInstances.clear();
 
         m_State.PointLights.clear();
         m_State.SpotLights.clear();
@@ -6,17 +6,15 @@
 #include "blackberry/model/material.hpp"
 #include "blackberry/renderer/shader_storage_buffer.hpp"
 #include "blackberry/renderer/environment_map.hpp"
+#include "blackberry/renderer/mesh_arena.hpp"
+#include "blackberry/scene/frustum_culling.hpp"
 #include "blackberry/scene/entity.hpp"
+#include "blackberry/scene/system_scheduler.hpp"
 
 namespace Blackberry {
 
     class Scene; // forward declaration since SceneRenderer will need scene but scene will also need scene renderer
-
-    struct SceneMeshVertex {
-        BlVec3 Position;
-        BlVec3 Normal;
-        BlVec2 TexCoord;
-    };
+    class Prefab;
 
     struct GPUDirectionalLight {
         BlVec4 Direction; // w is unused
@@ -42,41 +40,54 @@ namespace Blackberry {
         BlVec4 Color; // w is used for intensity
     };
 
+    // NOTE: 64 bytes (one cache line) and laid out to match std430 without any padding, a texture handle
+    // of 0 means the texture isn't used (the factor/color gets used instead)
     struct alignas(16) GPUMaterial {
-        int UseAlbedoTexture = false;
         u64 AlbedoTexture = 0;
-        BlVec4 AlbedoColor;
-
-        int UseMetallicTexture = false;
         u64 MetallicTexture = 0;
-        f32 MetallicFactor = 0.0f;
-
-        int UseRoughnessTexture = false;
         u64 RoughnessTexture = 0;
-        f32 RoughnessFactor = 0.0f;
-
-        int UseAOTexture = false;
         u64 AOTexture = 0;
-        f32 AOFactor = 0.0f;
 
+        BlVec4 AlbedoColor = BlVec4(0.0f);
+
+        f32 MetallicFactor = 0.0f;
+        f32 RoughnessFactor = 0.0f;
+        f32 AOFactor = 0.0f;
         f32 Emission = 0.0f;
     };
 
+    static_assert(sizeof(GPUMaterial) == 64);
+
+    // Every entity drawing the same mesh of the same model goes into one batch (one instanced draw)
+    // NOTE: Materials aren't part of the key, every instance has its own entry in the material buffer
+    struct MeshBatchKey {
+        u64 Model = 0; // asset handle of the model
+        u32 MeshIndex = 0;
+
+        bool operator==(const MeshBatchKey& other) const = default;
+    };
+
+    struct MeshBatchKeyHash {
+        std::size_t operator()(const MeshBatchKey& key) const {
+            return std::hash<u64>()(key.Model) ^ (std::hash<u32>()(key.MeshIndex) * 0x9E3779B97F4A7C15ull);
+        }
+    };
+
     // All the info needed to render a mesh (using instanced rendering)
     struct MeshInstance {
-        std::vector<SceneMeshVertex> MeshVertices;
-        std::vector<u32> MeshIndices;
+        MeshAllocation Allocation; // where the mesh's vertices and indices are in the MeshArena
 
         u32 InstanceCount = 0;
         std::vector<GPUInstanceData> InstanceData; // The size of this should be equal to InstanceCount
+    };
 
-        std::vector<GPUMaterial> MaterialData; // The size of this should be equal to InstanceCount
+    // An instance which only gets added to its batch if its box passes the frustum test (see SceneRenderer::CullMeshInstances)
+    struct PendingMeshInstance {
+        MeshInstance* Batch = nullptr; // NOTE: Fine to point into Meshes, unordered_map never moves its values
+        GPUInstanceData Data;
     };
 
     struct SceneRendererState {
-        // vertex arrays
-        Ref<VertexArray> GeometryBuffer;
-
         // shaders
         Ref<Shader> MeshGeometryShader;
         Ref<Shader> MeshLightingShader;
@@ -101,9 +112,28 @@ namespace Blackberry {
         std::vector<GPUSpotLight> SpotLights;
         GPUDirectionalLight DirectionalLight;
 
-        // All the meshes we want to render (NOTE: probably super ineffecient)
-        // The way you get a specific mesh is: Meshes[entityID][meshIndex]
-        std::unordered_map<u32, std::unordered_map<u32, MeshInstance>> Meshes;
+        // All the meshes we want to render, batched by model and mesh: Meshes[{modelHandle, meshIndex}]
+        std::unordered_map<MeshBatchKey, MeshInstance, MeshBatchKeyHash> Meshes;
+        u32 MeshDrawCalls = 0; // how many draws the last geometry pass took
+
+        // The world space box of every pending instance (same order as PendingInstances)
+        CullingBoxes CullBoxes;
+        std::vector<PendingMeshInstance> PendingInstances;
+        std::vector<u8> CullResults;
+        bool MeshCullingEnabled = true; // per mesh culling, the entities themselves always get culled (see Render)
+
+        // Every batch's instances one after another and a draw command per batch (rebuilt every geometry pass)
+        std::vector<GPUInstanceData> InstanceData;
+        std::vector<DrawIndexedIndirectCommand> DrawCommands;
+
+        // Every material the scene has drawn, one entry per Material::ID (index 0 is for materials without an ID)
+        // NOTE: Kept across frames, an entry only gets uploaded again when the material's version changes (see Material::MarkChanged)
+        std::vector<GPUMaterial> Materials;
+        std::vector<u32> MaterialVersions; // the Material::Version each entry was uploaded with
+        std::unordered_map<u32, u32> MaterialIndices; // Material::ID -> index into Materials
+        u32 MaterialDirtyBegin = 0; // the entries in [begin, end) still need to be uploaded
+        u32 MaterialDirtyEnd = 0;
+        u32 MaterialBufferCapacity = 0; // how many entries MaterialBuffer has room for
 
         Ref<Framebuffer> GBuffer; // For deffered rendering
 
@@ -151,17 +181,33 @@ namespace Blackberry {
 
         SceneRendererState& GetState();
 
-    private:
-        void AddMesh(const TransformComponent& transform, const Mesh& mesh, const Material& mat, BlColor color, u32 entityID, u32 meshIndex);
-        void AddModel(const TransformComponent& transform, const MeshComponent& model, BlColor color, u32 entityID);
+        // The systems Render runs to gather the lights, meshes and environment of the scene (before flushing)
+        SystemScheduler& GetExtractionSystems();
 
-        void AddDirectionalLight(const TransformComponent& transform, const DirectionalLightComponent& light);
-        void AddPointLight(const TransformComponent& transform, const PointLightComponent& light);
-        void AddSpotLight(const TransformComponent& transform, const SpotLightComponent& light);
+    private:
+        // NOTE: transform is the world matrix of the entity
+        void AddMesh(const BlMat4& transform, const Mesh& mesh, const Material& mat, BlColor color, u32 entityID, const MeshBatchKey& key);
+        // Returns the prefab's mesh for the instance (nullptr if the prefab isn't loaded or the node has no mesh)
+        const MeshComponent* GetPrefabMeshDefaults(const PrefabInstanceComponent& instance);
+        // Same as GetPrefabMeshDefaults, but the prefabs come from m_PrefabCache (only valid during the mesh extraction)
+        const MeshComponent* GetCachedPrefabMeshDefaults(const PrefabInstanceComponent& instance);
+        // NOTE: defaults is the prefab's mesh for prefab instances (materials the instance doesn't override come from there)
+        void AddModel(const BlMat4& transform, const MeshComponent& model, BlColor color, u32 entityID, const MeshComponent* defaults = nullptr);
+
+        void AddDirectionalLight(const WorldTransformComponent& transform, const DirectionalLightComponent& light);
+        void AddPointLight(const WorldTransformComponent& transform, const PointLightComponent& light);
+        void AddSpotLight(const WorldTransformComponent& transform, const SpotLightComponent& light);
 
         void AddEnvironment(const EnvironmentComponent& env);
 
+        // Returns where the material is in the material buffer (adding it or marking it for upload if it changed)
         u32 GetMaterialIndex(const Material& mat);
+        // Uploads the materials that got added or changed since the last upload
+        void UploadMaterials();
+        // Tests the pending instances against the camera's frustum and adds the visible ones to their batches
+        void CullMeshInstances();
+
+        void RegisterExtractionSystems();
 
     private:
         SceneRendererState m_State;
@@ -170,6 +216,11 @@ namespace Blackberry {
         Ref<Framebuffer> m_RenderTarget;
 
         Scene* m_Context = nullptr;
+
+        SystemScheduler m_ExtractionSystems;
+        Frustum m_Frustum; // the camera's, as of the last Render
+        std::vector<EntityID> m_VisibleEntities; // every entity whose bounds overlap the camera's frustum (see Render)
+        std::unordered_map<u64, const Prefab*> m_PrefabCache; // prefab asset -> prefab (nullptr if it isn't loaded), refilled every frame
     };
 
 } // namespace Blackberry
\ No newline at end of file
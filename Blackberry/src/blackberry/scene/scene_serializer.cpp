@@ -6,175 +6,247 @@
 
 namespace Blackberry {
 
-    static void SerializeEntity(YAML::Emitter& out, Entity e) {
-        BL_ASSERT(e.HasComponent<TagComponent>(), "All entities must have a TagComponent!");
-
-        out << YAML::BeginMap; // Entity
-
-        if (e.HasComponent<TagComponent>()) {
-            auto& tag = e.GetComponent<TagComponent>();
-
-            out << YAML::Key << "TagComponent";
-            out << YAML::BeginMap; // TagComponent
-
-            out << YAML::Key << "UUID" << YAML::Value << tag.UUID;
-            out << YAML::Key << "Name" << YAML::Value << tag.Name;
+#pragma region ComponentSerialization
 
-            out << YAML::EndMap; // TagComponent
-        }
-
-        if (e.HasComponent<RelationshipComponent>()) {
-            auto& rel = e.GetComponent<RelationshipComponent>();
-
-            out << YAML::Key << "RelationshipComponent";
-            out << YAML::BeginMap; // RelationshipComponent
-
-            out << YAML::Key << "Parent" << YAML::Value << rel.Parent;
-            out << YAML::Key << "FirstChild" << YAML::Value << rel.FirstChild;
-            out << YAML::Key << "NextSibling" << YAML::Value << rel.NextSibling;
-            out << YAML::Key << "PrevSibling" << YAML::Value << rel.PrevSibling;
+    // NOTE: Every component marked as serializable in component_registry.hpp needs both a SerializeComponent and DeserializeComponent overload
 
-            out << YAML::EndMap; // RelationshipComponent
-        }
-
-        if (e.HasComponent<TransformComponent>()) {
-            auto& transform = e.GetComponent<TransformComponent>();
+    static void SerializeComponent(YAML::Emitter& out, const TagComponent& tag) {
+        out << YAML::Key << "UUID" << YAML::Value << tag.UUID;
+        out << YAML::Key << "Name" << YAML::Value << tag.Name.String();
+    }
 
-            out << YAML::Key << "TransformComponent";
-            out << YAML::BeginMap; // TransformComponent
+    static void DeserializeComponent(const YAML::Node& node, TagComponent& tag) {
+        tag.UUID = node["UUID"].as<u64>();
+        tag.Name = node["Name"].as<std::string>();
+    }
 
-            out << YAML::Key << "Position" << YAML::Value << transform.Position;
-            out << YAML::Key << "Rotation" << YAML::Value << transform.Rotation;
-            out << YAML::Key << "Scale" << YAML::Value << transform.Scale;
+    static void SerializeComponent(YAML::Emitter& out, const RelationshipComponent& rel) {
+        out << YAML::Key << "Parent" << YAML::Value << rel.Parent;
+        out << YAML::Key << "FirstChild" << YAML::Value << rel.FirstChild;
+        out << YAML::Key << "NextSibling" << YAML::Value << rel.NextSibling;
+        out << YAML::Key << "PrevSibling" << YAML::Value << rel.PrevSibling;
+    }
 
-            out << YAML::EndMap; // TransformComponent
-        }
+    static void DeserializeComponent(const YAML::Node& node, RelationshipComponent& rel) {
+        rel.Parent = node["Parent"].as<u64>();
+        rel.FirstChild = node["FirstChild"].as<u64>();
+        rel.NextSibling = node["NextSibling"].as<u64>();
+        rel.PrevSibling = node["PrevSibling"].as<u64>();
+    }
 
-        if (e.HasComponent<MeshComponent>()) {
-            auto& mesh = e.GetComponent<MeshComponent>();
+    static void SerializeComponent(YAML::Emitter& out, const TransformComponent& transform) {
+        out << YAML::Key << "Position" << YAML::Value << transform.Position;
+        out << YAML::Key << "Rotation" << YAML::Value << transform.Rotation;
+        out << YAML::Key << "Scale" << YAML::Value << transform.Scale;
+    }
 
-            out << YAML::Key << "MeshComponent";
-            out << YAML::BeginMap; // MeshComponent
+    static void DeserializeComponent(const YAML::Node& node, TransformComponent& transform) {
+        transform.Position = node["Position"].as<BlVec3>();
+        transform.Rotation = node["Rotation"].as<BlQuat>();
+        transform.Scale = node["Scale"].as<BlVec3>();
+    }
 
-            out << YAML::Key << "MeshHandle" << YAML::Value << mesh.MeshHandle;
-            out << YAML::Key << "MaterialHandles" << YAML::Value << mesh.MaterialHandles;
+    static void SerializeComponent(YAML::Emitter& out, const MeshComponent& mesh) {
+        out << YAML::Key << "MeshHandle" << YAML::Value << mesh.MeshHandle;
 
-            out << YAML::EndMap; // MeshComponent
-        }
+        // NOTE: Written as a map (sorted by material index) so the files don't depend on the order the overrides were set in
+        std::map<u32, u64> materials;
+        mesh.MaterialHandles.Each([&](u32 index, u64 handle) { materials[index] = handle; });
 
-        if (e.HasComponent<CameraComponent>()) {
-            auto& camera = e.GetComponent<CameraComponent>();
+        out << YAML::Key << "MaterialHandles" << YAML::Value << materials;
+    }
 
-            out << YAML::Key << "CameraComponent";
-            out << YAML::BeginMap; // CameraComponent
+    static void DeserializeComponent(const YAML::Node& node, MeshComponent& mesh) {
+        mesh.MeshHandle = node["MeshHandle"].as<u64>();
 
-            out << YAML::Key << "FOV" << YAML::Value << camera.FOV;
-            out << YAML::Key << "Near" << YAML::Value << camera.Near;
-            out << YAML::Key << "Far" << YAML::Value << camera.Far;
+        for (auto [index, handle] : node["MaterialHandles"].as<std::map<u32, u64>>()) {
+            if (index > MaterialOverrides::s_MaxMaterialIndex) {
+                BL_CORE_WARN("Mesh {} overrides material {}, which is out of range, the override is dropped!", mesh.MeshHandle, index);
+                continue;
+            }
 
-            out << YAML::EndMap; // CameraComponent
+            if (!mesh.MaterialHandles.Set(index, handle)) {
+                BL_CORE_WARN("Mesh {} overrides more than {} materials, material {} is dropped!", mesh.MeshHandle, MaterialOverrides::s_Capacity, index);
+            }
         }
+    }
 
-        if (e.HasComponent<ScriptComponent>()) {
-            auto& script = e.GetComponent<ScriptComponent>();
-
-            out << YAML::Key << "ScriptComponent";
-            out << YAML::BeginMap; // ScriptComponent
+    static void SerializeComponent(YAML::Emitter& out, const CameraComponent& camera) {
+        out << YAML::Key << "FOV" << YAML::Value << camera.FOV;
+        out << YAML::Key << "Near" << YAML::Value << camera.Near;
+        out << YAML::Key << "Far" << YAML::Value << camera.Far;
+    }
 
-            out << YAML::Key << "ModulePath" << YAML::Value << script.ModulePath.String();
+    static void DeserializeComponent(const YAML::Node& node, CameraComponent& camera) {
+        camera.FOV = node["FOV"].as<f32>();
+        camera.Near = node["Near"].as<f32>();
+        camera.Far = node["Far"].as<f32>();
+    }
 
-            out << YAML::EndMap; // ScriptComponent
-        }
+    static void SerializeComponent(YAML::Emitter& out, const ScriptComponent& script) {
+        out << YAML::Key << "ModulePath" << YAML::Value << script.ModulePath.String();
+    }
 
-        if (e.HasComponent<RigidBodyComponent>()) {
-            auto& rigidBody = e.GetComponent<RigidBodyComponent>();
+    static void DeserializeComponent(const YAML::Node& node, ScriptComponent& script) {
+        script.ModulePath = FS::Path(node["ModulePath"].as<std::string>()).String();
+    }
 
-            out << YAML::Key << "RigidBodyComponent";
-            out << YAML::BeginMap; // RigidBodyComponent
+    static void SerializeComponent(YAML::Emitter& out, const RigidBodyComponent& rigidBody) {
+        out << YAML::Key << "Type" << YAML::Value << RigidBodyTypeToString(rigidBody.Type);
+        out << YAML::Key << "Resitution" << YAML::Value << rigidBody.Resitution;
+        out << YAML::Key << "Friction" << YAML::Value << rigidBody.Friction;
+    }
 
-            out << YAML::Key << "Type" << YAML::Value << RigidBodyTypeToString(rigidBody.Type);
-            out << YAML::Key << "Resitution" << YAML::Value << rigidBody.Resitution;
-            out << YAML::Key << "Friction" << YAML::Value << rigidBody.Friction;
+    static void DeserializeComponent(const YAML::Node& node, RigidBodyComponent& rigidBody) {
+        rigidBody.Type = StringToRigidBodyType(node["Type"].as<std::string>());
+        rigidBody.Resitution = node["Resitution"].as<f32>();
+        rigidBody.Friction = node["Friction"].as<f32>();
+    }
 
-            out << YAML::EndMap; // RigidBodyComponent
-        }
+    static void SerializeComponent(YAML::Emitter& out, const BoxColliderComponent& collider) {
+        out << YAML::Key << "Scale" << YAML::Value << collider.Scale;
+    }
 
-        if (e.HasComponent<BoxColliderComponent>()) {
-            auto& collider = e.GetComponent<BoxColliderComponent>();
+    static void DeserializeComponent(const YAML::Node& node, BoxColliderComponent& collider) {
+        collider.Scale = node["Scale"].as<BlVec3>();
+    }
 
-            out << YAML::Key << "BoxColliderComponent";
-            out << YAML::BeginMap; // BoxColliderComponent
+    static void SerializeComponent(YAML::Emitter& out, const SphereColliderComponent& collider) {
+        out << YAML::Key << "Radius" << YAML::Value << collider.Radius;
+    }
 
-            out << YAML::Key << "Scale" << YAML::Value << collider.Scale;
+    static void DeserializeComponent(const YAML::Node& node, SphereColliderComponent& collider) {
+        collider.Radius = node["Radius"].as<f32>();
+    }
 
-            out << YAML::EndMap; // BoxColliderComponent
-        }
+    static void SerializeComponent(YAML::Emitter& out, const TextComponent& text) {
+        out << YAML::Key << "Contents" << YAML::Value << text.Contents;
+        out << YAML::Key << "FontHandle" << YAML::Value << text.FontHandle;
+        out << YAML::Key << "Kerning" << YAML::Value << text.Kerning;
+        out << YAML::Key << "LineSpacing" << YAML::Value << text.LineSpacing;
+    }
 
-        if (e.HasComponent<SphereColliderComponent>()) {
-            auto& collider = e.GetComponent<SphereColliderComponent>();
+    static void DeserializeComponent(const YAML::Node& node, TextComponent& text) {
+        text.Contents = node["Contents"].as<std::string>();
+        text.FontHandle = node["FontHandle"].as<u64>();
+        text.Kerning = node["Kerning"].as<f32>();
+        text.LineSpacing = node["LineSpacing"].as<f32>();
+    }
 
-            out << YAML::Key << "SphereColliderComponent";
-            out << YAML::BeginMap; // SphereColliderComponent
+    static void SerializeComponent(YAML::Emitter& out, const DirectionalLightComponent& light) {
+        out << YAML::Key << "Color" << YAML::Value << light.Color;
+        out << YAML::Key << "Intensity" << YAML::Value << light.Intensity;
+    }
 
-            out << YAML::Key << "Radius" << YAML::Value << collider.Radius;
+    static void DeserializeComponent(const YAML::Node& node, DirectionalLightComponent& light) {
+        light.Color = node["Color"].as<BlVec3>();
+        light.Intensity = node["Intensity"].as<f32>();
+    }
 
-            out << YAML::EndMap; // SphereColliderComponent
-        }
+    static void SerializeComponent(YAML::Emitter& out, const PointLightComponent& light) {
+        out << YAML::Key << "Color" << YAML::Value << light.Color;
+        out << YAML::Key << "Radius" << YAML::Value << light.Radius;
+        out << YAML::Key << "Intensity" << YAML::Value << light.Intensity;
+    }
 
-        if (e.HasComponent<DirectionalLightComponent>()) {
-            auto& light = e.GetComponent<DirectionalLightComponent>();
+    static void DeserializeComponent(const YAML::Node& node, PointLightComponent& light) {
+        light.Color = node["Color"].as<BlVec3>();
+        light.Radius = node["Radius"].as<f32>();
+        light.Intensity = node["Intensity"].as<f32>();
+    }
 
-            out << YAML::Key << "DirectionalLightComponent";
-            out << YAML::BeginMap; // DirectionalLightComponent
+    static void SerializeComponent(YAML::Emitter& out, const SpotLightComponent& light) {
+        out << YAML::Key << "Color" << YAML::Value << light.Color;
+        out << YAML::Key << "Cutoff" << YAML::Value << light.Cutoff;
+        out << YAML::Key << "Intensity" << YAML::Value << light.Intensity;
+    }
 
-            out << YAML::Key << "Color" << YAML::Value << light.Color;
-            out << YAML::Key << "Intensity" << YAML::Value << light.Intensity;
+    static void DeserializeComponent(const YAML::Node& node, SpotLightComponent& light) {
+        light.Color = node["Color"].as<BlVec3>();
+        light.Cutoff = node["Cutoff"].as<f32>();
+        light.Intensity = node["Intensity"].as<f32>();
+    }
 
-            out << YAML::EndMap; // DirectionalLightComponent
-        }
+    static void SerializeComponent(YAML::Emitter& out, const EnvironmentComponent& env) {
+        out << YAML::Key << "EnvironmentMap" << YAML::Value << env.EnvironmentMap;
+        out << YAML::Key << "LevelOfDetail" << YAML::Value << env.LevelOfDetail;
+        out << YAML::Key << "EnableBloom" << YAML::Value << env.EnableBloom;
+        out << YAML::Key << "BloomThreshold" << YAML::Value << env.BloomThreshold;
+    }
 
-        if (e.HasComponent<PointLightComponent>()) {
-            auto& light = e.GetComponent<PointLightComponent>();
+    static void DeserializeComponent(const YAML::Node& node, EnvironmentComponent& env) {
+        env.EnvironmentMap = node["EnvironmentMap"].as<u64>();
+        env.LevelOfDetail = node["LevelOfDetail"].as<f32>();
+        env.EnableBloom = node["EnableBloom"].as<bool>();
+        env.BloomThreshold = node["BloomThreshold"].as<f32>();
+    }
 
-            out << YAML::Key << "PointLightComponent";
-            out << YAML::BeginMap; // PointLightComponent
+    static void SerializeComponent(YAML::Emitter& out, const PrefabInstanceComponent& instance) {
+        out << YAML::Key << "Prefab" << YAML::Value << instance.Prefab;
+        out << YAML::Key << "Node" << YAML::Value << instance.Node;
+    }
 
-            out << YAML::Key << "Color" << YAML::Value << light.Color;
-            out << YAML::Key << "Radius" << YAML::Value << light.Radius;
-            out << YAML::Key << "Intensity" << YAML::Value << light.Intensity;
+    static void DeserializeComponent(const YAML::Node& node, PrefabInstanceComponent& instance) {
+        instance.Prefab = node["Prefab"].as<u64>();
+        instance.Node = node["Node"].as<u32>();
+    }
 
-            out << YAML::EndMap; // PointLightComponent
-        }
+#pragma endregion
 
-        if (e.HasComponent<EnvironmentComponent>()) {
-            auto& env = e.GetComponent<EnvironmentComponent>();
+    static void SerializeEntity(YAML::Emitter& out, Entity e) {
+        BL_ASSERT(e.HasComponent<TagComponent>(), "All entities must have a TagComponent!");
 
-            out << YAML::Key << "EnvironmentComponent";
-            out << YAML::BeginMap; // EnvironmentComponent
+        out << YAML::BeginMap; // Entity
 
-            out << YAML::Key << "EnvironmentMap" << YAML::Value << env.EnvironmentMap;
-            out << YAML::Key << "LevelOfDetail" << YAML::Value << env.LevelOfDetail;
-            out << YAML::Key << "EnableBloom" << YAML::Value << env.EnableBloom;
-            out << YAML::Key << "BloomThreshold" << YAML::Value << env.BloomThreshold;
+        AllComponents::ForEach([&]<typename T>() {
+            if constexpr (ComponentTraits<T>::Serializable) {
+                if (!e.HasComponent<T>()) return;
 
-            out << YAML::EndMap; // EnvironmentComponent
-        }
+                out << YAML::Key << ComponentTraits<T>::Name;
+                out << YAML::BeginMap;
+                SerializeComponent(out, e.GetComponent<T>());
+                out << YAML::EndMap;
+            }
+        });
 
         out << YAML::EndMap; // Entity
     }
 
+    // Adds (or overwrites) every serialized component of the yaml entity to entity
+    static void DeserializeEntity(const YAML::Node& node, ECS* ecs, EntityID entity) {
+        AllComponents::ForEach([&]<typename T>() {
+            if constexpr (ComponentTraits<T>::Serializable) {
+                auto yamlComponent = node[ComponentTraits<T>::Name];
+                if (!yamlComponent) return;
+
+                // NOTE: Some components (tag, relationship) already get created by Scene::CreateEntityWithUUID
+                if (T* existing = ecs->TryGetComponent<T>(entity)) {
+                    DeserializeComponent(yamlComponent, *existing);
+                } else {
+                    T component;
+                    DeserializeComponent(yamlComponent, component);
+                    ecs->AddComponent<T>(entity, component);
+                }
+            }
+        });
+    }
+
     SceneSerializer::SceneSerializer(Ref<Scene> scene)
         : m_Scene(scene) {}
 
     void SceneSerializer::Serialize(const FS::Path& path) {
-        if (m_Scene->GetEntities().size() == 0) return;
+        Serialize(path, m_Scene->GetEntities());
+    }
+
+    void SceneSerializer::Serialize(const FS::Path& path, const std::vector<EntityID>& entities) {
+        if (entities.size() == 0) return;
         YAML::Emitter out;
 
         out << YAML::BeginMap;
         out << YAML::Key << "Entities" << YAML::Value << YAML::BeginSeq;
 
         // entities
-        for (auto& id : m_Scene->GetEntities()) {
+        for (auto& id : entities) {
             Entity entity(id, m_Scene);
             SerializeEntity(out, entity);
         }
@@ -193,141 +265,42 @@ namespace Blackberry {
         if (!node["Entities"]) return;
 
         YAML::Node entities = node["Entities"];
+        m_Scene->ReserveEntities(static_cast<u32>(entities.size()));
 
         for (auto entity : entities) {
-            Entity e;
-
-            if (entity["TagComponent"]) {
-                auto yamlTag = entity["TagComponent"];
-
-                e = Entity(m_Scene->CreateEntityWithUUID(yamlTag["UUID"].as<u64>()), m_Scene);
-                auto& tag = e.GetComponent<TagComponent>();
-                tag.Name = yamlTag["Name"].as<std::string>();
-            }
-
-            if (entity["RelationshipComponent"]) {
-                auto yamlRel = entity["RelationshipComponent"];
-
-                auto& rel = e.GetComponent<RelationshipComponent>();
-                rel.Parent = yamlRel["Parent"].as<u64>();
-                rel.FirstChild = yamlRel["FirstChild"].as<u64>();
-                rel.NextSibling = yamlRel["NextSibling"].as<u64>();
-                rel.PrevSibling = yamlRel["PrevSibling"].as<u64>();
-            }
-
-            if (entity["TagComponent"]) {
-                auto yamlTag = entity["TagComponent"];
-
-                auto& tag = e.GetComponent<TagComponent>();
-                tag.Name = yamlTag["Name"].as<std::string>();
-            }
-
-            if (entity["TransformComponent"]) {
-                auto yamlTransform = entity["TransformComponent"];
-
-                TransformComponent transform;
-                transform.Position = yamlTransform["Position"].as<BlVec3>();
-                transform.Rotation = yamlTransform["Rotation"].as<BlQuat>();
-                transform.Scale = yamlTransform["Scale"].as<BlVec3>();
-
-                e.AddComponent<TransformComponent>(transform);
-            }
-
-            if (entity["MeshComponent"]) {
-                auto yamlMesh = entity["MeshComponent"];
+            BL_ASSERT(entity["TagComponent"], "All entities must have a TagComponent!");
 
-                MeshComponent mesh;
-                mesh.MeshHandle = yamlMesh["MeshHandle"].as<u64>();
-                mesh.MaterialHandles = yamlMesh["MaterialHandles"].as<std::map<u32, u64>>();
-
-                e.AddComponent<MeshComponent>(mesh);
-            }
+            u64 uuid = entity["TagComponent"]["UUID"].as<u64>();
+            EntityID e = m_Scene->CreateEntityWithUUID(uuid);
 
-            if (entity["CameraComponent"]) {
-                auto yamlCamera = entity["CameraComponent"];
-
-                CameraComponent camera;
-                camera.FOV = yamlCamera["FOV"].as<f32>();
-                camera.Near = yamlCamera["Near"].as<f32>();
-                camera.Far = yamlCamera["Far"].as<f32>();
-
-                e.AddComponent<CameraComponent>(camera);
-            }
+            DeserializeEntity(entity, m_Scene->GetECS(), e);
 
-            if (entity["ScriptComponent"]) {
-                auto yamlScript = entity["ScriptComponent"];
-
-                ScriptComponent script;
-                script.ModulePath = yamlScript["ModulePath"].as<std::string>();
-
-                e.AddComponent<ScriptComponent>(script);
-            }
-
-            if (entity["RigidBodyComponent"]) {
-                auto yamlRigidBody = entity["RigidBodyComponent"];
-
-                RigidBodyComponent rigidBody;
-                rigidBody.Type = StringToRigidBodyType(yamlRigidBody["Type"].as<std::string>());
-                rigidBody.Resitution = yamlRigidBody["Resitution"].as<f32>();
-                rigidBody.Friction = yamlRigidBody["Friction"].as<f32>();
-
-                e.AddComponent<RigidBodyComponent>(rigidBody);
-            }
-
-            if (entity["BoxColliderComponent"]) {
-                auto yamlCollider = entity["BoxColliderComponent"];
-
-                BoxColliderComponent collider;
-                collider.Scale = yamlCollider["Scale"].as<BlVec3>();
-
-                e.AddComponent<BoxColliderComponent>(collider);
-            }
-
-            if (entity["SphereColliderComponent"]) {
-                auto yamlCollider = entity["SphereColliderComponent"];
-
-                SphereColliderComponent collider;
-                collider.Radius = yamlCollider["Radius"].as<f32>();
-
-                e.AddComponent<SphereColliderComponent>(collider);
-            }
-
-
-            if (entity["DirectionalLightComponent"]) {
-                auto yamlLight = entity["DirectionalLightComponent"];
-
-                DirectionalLightComponent light;
-                light.Color = yamlLight["Color"].as<BlVec3>();
-                light.Intensity = yamlLight["Intensity"].as<f32>();
-
-                e.AddComponent<DirectionalLightComponent>(light);
-            }
+            m_Scene->SetEntityName(uuid, m_Scene->GetECS()->GetComponent<const TagComponent>(e).Name);
+            m_Scene->FinishEntityEdit(uuid);
+        }
+    }
 
-            if (entity["PointLightComponent"]) {
-                auto yamlLight = entity["PointLightComponent"];
+    ECS* SceneSerializer::DeserializeToECS(const FS::Path& path) {
+        std::string contents = Util::ReadEntireFile(path);
 
-                PointLightComponent light;
-                light.Color = yamlLight["Color"].as<BlVec3>();
-                light.Radius = yamlLight["Radius"].as<f32>();
-                light.Intensity = yamlLight["Intensity"].as<f32>();
+        YAML::Node node = YAML::Load(contents.c_str());
 
-                e.AddComponent<PointLightComponent>(light);
-            }
+        if (!node["Entities"]) return nullptr;
 
-            if (entity["EnvironmentComponent"]) {
-                auto yamlEnv = entity["EnvironmentComponent"];
+        ECS* ecs = new ECS();
 
-                EnvironmentComponent env;
-                env.EnvironmentMap = yamlEnv["EnvironmentMap"].as<u64>();
-                env.LevelOfDetail = yamlEnv["LevelOfDetail"].as<f32>();
-                env.EnableBloom = yamlEnv["EnableBloom"].as<bool>();
-                env.BloomThreshold = yamlEnv["BloomThreshold"].as<f32>();
+        for (auto entity : node["Entities"]) {
+            BL_ASSERT(entity["TagComponent"], "All entities must have a TagComponent!");
 
-                e.AddComponent<EnvironmentComponent>(env);
-            }
+            // Same components CreateEntityWithUUID would give it
+            EntityID e = ecs->CreateEntity();
+            ecs->AddComponent<TagComponent>(e, { "", entity["TagComponent"]["UUID"].as<u64>() });
+            ecs->AddComponent<RelationshipComponent>(e, {});
 
-            m_Scene->FinishEntityEdit(e.GetComponent<TagComponent>().UUID);
+            DeserializeEntity(entity, ecs, e);
         }
+
+        return ecs;
     }
 
 } // namespace Blackberry
\ No newline at end of file
@@ -11,8 +11,14 @@ namespace Blackberry {
         SceneSerializer(Ref<Scene> scene);
 
         void Serialize(const FS::Path& path);
+        // Only writes the given entities (e.g. one cell of a partitioned world, see WorldPartition)
+        void Serialize(const FS::Path& path, const std::vector<EntityID>& entities);
         void Deserialize(const FS::Path& path);
 
+        // Loads a scene file into a standalone ECS without touching any scene, project or asset (safe to call from worker threads)
+        // NOTE: The entities can then be moved into a scene with Scene::MergeEntities, returns nullptr if the file has no entities
+        static ECS* DeserializeToECS(const FS::Path& path);
+
     private:
         Ref<Scene> m_Scene = nullptr;
     };
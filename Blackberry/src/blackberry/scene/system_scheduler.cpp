@@ -0,0 +1,148 @@
+#include "blackberry/scene/system_scheduler.hpp"
+#include "blackberry/scene/scene.hpp"
+#include "blackberry/core/util.hpp"
+#include "blackberry/core/timer.hpp"
+#include "blackberry/core/thread_pool.hpp"
+
+#include <mutex>
+#include <condition_variable>
+#include <string_view>
+
+namespace Blackberry {
+
+    void SystemScheduler::AddSystem(const SystemSpecification& spec, const SystemFunc& func) {
+        BL_ASSERT(spec.Name, "Systems need a name!");
+
+        m_Systems.push_back(spec);
+        m_Funcs.push_back(func);
+    }
+
+    void SystemScheduler::RemoveSystem(const char* name) {
+        for (u32 i = 0; i < m_Systems.size(); i++) {
+            if (std::string_view(m_Systems[i].Name) == name) {
+                m_Systems.erase(m_Systems.begin() + i);
+                m_Funcs.erase(m_Funcs.begin() + i);
+
+                return;
+            }
+        }
+    }
+
+    void SystemScheduler::Clear() {
+        m_Systems.clear();
+        m_Funcs.clear();
+    }
+
+    void SystemScheduler::Run(Scene* scene, f32 deltaTime, ThreadPool* pool) {
+        u32 count = static_cast<u32>(m_Systems.size());
+        if (count == 0) return;
+
+        // Build the dependency graph (systems can get added/removed at any time, and it is tiny compared to running them)
+        std::vector<u32> waitingOn(count, 0); // how many unfinished systems each system still waits for
+        std::vector<std::vector<u32>> dependents(count);
+
+        u32 reads = 0;
+        u32 writes = 0;
+        u32 workerAccess = 0; // everything the systems which may run on other threads access
+
+        for (u32 j = 0; j < count; j++) {
+            for (u32 i = 0; i < j; i++) {
+                if (Conflicts(m_Systems[i], m_Systems[j])) {
+                    dependents[i].push_back(j);
+                    waitingOn[j]++;
+                }
+            }
+
+            reads |= m_Systems[j].Reads;
+            writes |= m_Systems[j].Writes;
+
+            if (!m_Systems[j].MainThread) {
+                workerAccess |= m_Systems[j].Reads | m_Systems[j].Writes;
+            }
+        }
+
+        // NOTE: Creating pools/groups and cloning copy-on-write pools isn't thread safe, so all of that happens here before any system runs
+        scene->GetECS()->PreparePools(reads, writes);
+        if (pool) {
+            scene->GetECS()->PrepareGroups(workerAccess);
+        }
+
+        std::mutex mutex;
+        std::condition_variable systemFinished;
+
+        std::vector<u32> ready;
+        std::vector<f32> timings(count, 0.0f);
+        u32 finished = 0;
+
+        for (u32 i = 0; i < count; i++) {
+            if (waitingOn[i] == 0) {
+                ready.push_back(i);
+            }
+        }
+
+        auto runSystem = [&](u32 system) {
+            Timer timer;
+            timer.Start();
+
+            m_Funcs[system](scene, deltaTime);
+
+            f32 time = timer.ElapsedNanoseconds();
+
+            std::lock_guard<std::mutex> lock(mutex);
+
+            timings[system] = time;
+            finished++;
+
+            for (u32 dependent : dependents[system]) {
+                if (--waitingOn[dependent] == 0) {
+                    ready.push_back(dependent);
+                }
+            }
+
+            // NOTE: Notify while still holding the lock, everything used here lives on Run's stack
+            // and is gone as soon as the main thread sees the last system finish
+            systemFinished.notify_all();
+        };
+
+        std::vector<u32> batch;
+
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                systemFinished.wait(lock, [&]() { return !ready.empty() || finished == count; });
+
+                if (finished == count) break;
+
+                std::swap(batch, ready);
+            }
+
+            // Hand out the worker systems first so they run while we are busy with the main thread ones
+            for (u32 system : batch) {
+                if (!m_Systems[system].MainThread && pool) {
+                    pool->Submit([&runSystem, system]() { runSystem(system); });
+                }
+            }
+
+            for (u32 system : batch) {
+                if (m_Systems[system].MainThread || !pool) {
+                    runSystem(system);
+                }
+            }
+
+            batch.clear();
+        }
+
+        for (u32 i = 0; i < count; i++) {
+            Instrumentor::SetTimePoint(m_Systems[i].Name, { timings[i] });
+        }
+    }
+
+    const std::vector<SystemSpecification>& SystemScheduler::GetSystems() const {
+        return m_Systems;
+    }
+
+    bool SystemScheduler::Conflicts(const SystemSpecification& a, const SystemSpecification& b) {
+        return (a.Writes & (b.Reads | b.Writes)) != 0 || (b.Writes & a.Reads) != 0;
+    }
+
+} // namespace Blackberry
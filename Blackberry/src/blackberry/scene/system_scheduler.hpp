@@ -0,0 +1,60 @@
+#pragma once
+
+#include "blackberry/core/types.hpp"
+#include "blackberry/ecs/component_registry.hpp"
+
+#include <vector>
+#include <functional>
+
+namespace Blackberry {
+
+    class Scene;
+    class ThreadPool;
+
+    struct SystemSpecification {
+        // NOTE: Also used as the system's Instrumentor key, so it MUST stay alive as long as the scheduler (use a string literal)
+        const char* Name = nullptr;
+
+        // The components the system accesses, use AllComponents::MaskOf<...>() (AllComponents::AllMask for everything)
+        u32 Reads = 0;
+        u32 Writes = 0;
+
+        // Main thread systems run on the thread calling SystemScheduler::Run (needed for Lua, OpenGL, the asset manager
+        // and anything else which calls ThreadPool::Wait)
+        bool MainThread = false;
+    };
+
+    // Runs a set of systems, where every system declares which components it reads and writes
+    //
+    // Every Run builds a dependency graph from the declarations: a system waits for every system registered before it
+    // which writes to something it reads or writes, or reads something it writes. Systems which don't conflict run at the same time
+    // (the ones which aren't main thread systems go to the thread pool), so the result is the same as running them one after another
+    //
+    // Rules for systems:
+    // - Systems MUST NOT create/destroy entities or add/remove components, record those in the scene's command buffer instead
+    // - Only read the components you declared (the pools of components nobody writes may be shared with other threads)
+    // - Every system gets timed as a whole and shows up in the Instrumentor under its name (scopes timed with BL_PROFILE_SCOPE
+    //   on several threads at once get added up)
+    class SystemScheduler {
+    public:
+        using SystemFunc = std::function<void(Scene* scene, f32 deltaTime)>;
+
+        void AddSystem(const SystemSpecification& spec, const SystemFunc& func);
+        void RemoveSystem(const char* name);
+        void Clear();
+
+        // Blocks until every system has run
+        void Run(Scene* scene, f32 deltaTime, ThreadPool* pool);
+
+        const std::vector<SystemSpecification>& GetSystems() const;
+
+    private:
+        // True if b (registered after a) has to wait for a
+        static bool Conflicts(const SystemSpecification& a, const SystemSpecification& b);
+
+    private:
+        std::vector<SystemSpecification> m_Systems;
+        std::vector<SystemFunc> m_Funcs;
+    };
+
+} // namespace Blackberry
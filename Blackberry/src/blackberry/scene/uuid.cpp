@@ -4,9 +4,9 @@
 
 namespace Blackberry {
 
-    static std::random_device s_RandomDevice;
-	static std::mt19937_64 s_Engine(s_RandomDevice());
-	static std::uniform_int_distribution<u64> s_UniformDistribution;
+    // NOTE: One engine per thread so UUIDs can be generated from any thread (e.g. EntityCommandBuffer::CreateEntity)
+    static thread_local std::mt19937_64 s_Engine(std::random_device{}());
+	static thread_local std::uniform_int_distribution<u64> s_UniformDistribution;
 
     u64 UUID() {
         return s_UniformDistribution(s_Engine);
@@ -0,0 +1,425 @@
+#include "blackberry/scene/world_partition.hpp"
+#include "blackberry/scene/scene.hpp"
+#include "blackberry/scene/scene_serializer.hpp"
+#include "blackberry/core/thread_pool.hpp"
+#include "blackberry/core/util.hpp"
+#include "blackberry/core/timer.hpp"
+#include "blackberry/core/yaml_utils.hpp"
+#include "blackberry/project/project.hpp"
+#include "blackberry/assets/asset_manager.hpp"
+
+#include <map>
+#include <cmath>
+#include <fstream>
+#include <algorithm>
+
+namespace Blackberry {
+
+    // Rough size of an entity in memory (the components plus their sparse set entries), used for the memory budget
+    static u64 EstimateEntityBytes(ECS* ecs, EntityID entity) {
+        u64 bytes = 2 * sizeof(EntityID);
+
+        AllComponents::ForEach([&]<typename T>() {
+            if (const T* component = ecs->TryGetComponent<const T>(entity)) {
+                bytes += sizeof(T) + 2 * sizeof(EntityID) + GetHeapSize(*component);
+            }
+        });
+
+        return bytes;
+    }
+
+    // Root entities which have to be loaded no matter where the streaming position is
+    static bool IsPersistent(ECS* ecs, const SceneHierarchy& hierarchy, u32 root) {
+        if (!ecs->HasComponent<TransformComponent>(hierarchy[root].Entity)) return true;
+
+        for (u32 i = root; i < root + hierarchy[root].SubtreeSize; i++) {
+            if (ecs->HasComponent<CameraComponent, ScriptComponent, DirectionalLightComponent, EnvironmentComponent>(hierarchy[i].Entity)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // The models the entities use (sorted, without duplicates)
+    static std::vector<u64> GetModels(ECS* ecs, const std::vector<EntityID>& entities) {
+        std::vector<u64> models;
+
+        for (EntityID entity : entities) {
+            if (const MeshComponent* mesh = ecs->TryGetComponent<const MeshComponent>(entity)) {
+                if (mesh->MeshHandle != 0) {
+                    models.push_back(mesh->MeshHandle);
+                }
+            }
+        }
+
+        std::sort(models.begin(), models.end());
+        models.erase(std::unique(models.begin(), models.end()), models.end());
+
+        return models;
+    }
+
+    WorldPartition::WorldPartition(Scene* scene, const WorldPartitionSpecification& spec)
+        : m_Scene(scene), m_Specification(spec) {
+        BL_ASSERT(spec.UnloadRadius >= spec.LoadRadius, "The unload radius must not be smaller than the load radius!");
+
+        LoadIndex();
+        UnloadUnusedModels();
+    }
+
+    WorldPartition::~WorldPartition() {
+        {
+            std::unique_lock lock(m_Mutex);
+            m_LoadFinished.wait(lock, [this]() { return m_PendingLoads == 0; });
+
+            for (FinishedLoad& load : m_FinishedLoads) {
+                delete load.Entities;
+            }
+        }
+
+        if (m_ModelUsers.empty()) return;
+
+        AssetManager& assets = Project::GetAssetManager();
+
+        for (auto& [model, users] : m_ModelUsers) {
+            if (assets.IsAssetUnloaded(model)) {
+                assets.LoadAsset(model);
+            }
+        }
+    }
+
+    void WorldPartition::Build(Ref<Scene> scene, const FS::Path& directory, f32 cellSize) {
+        BL_PROFILE_SCOPE("WorldPartition::Build");
+
+        scene->UpdateWorldTransforms();
+
+        ECS* ecs = scene->GetECS();
+        const SceneHierarchy& hierarchy = scene->GetHierarchy();
+
+        struct CellEntities {
+            std::vector<EntityID> Entities;
+            u64 EstimatedBytes = 0;
+        };
+
+        std::vector<EntityID> persistent;
+        std::map<std::pair<i32, i32>, CellEntities> cells; // ordered, so building the same scene twice gives the same index
+
+        hierarchy.EachRoot([&](u32 root) {
+            u32 end = root + hierarchy[root].SubtreeSize;
+
+            if (IsPersistent(ecs, hierarchy, root)) {
+                for (u32 i = root; i < end; i++) {
+                    persistent.push_back(hierarchy[i].Entity);
+                }
+
+                return;
+            }
+
+            const BlVec3& position = ecs->GetComponent<const WorldTransformComponent>(hierarchy[root].Entity).Position;
+            CellEntities& cell = cells[{ static_cast<i32>(std::floor(position.x / cellSize)), static_cast<i32>(std::floor(position.z / cellSize)) }];
+
+            for (u32 i = root; i < end; i++) {
+                cell.Entities.push_back(hierarchy[i].Entity);
+                cell.EstimatedBytes += EstimateEntityBytes(ecs, hierarchy[i].Entity);
+            }
+        });
+
+        SceneSerializer serializer(scene);
+        serializer.Serialize(directory / s_PersistentFileName, persistent);
+
+        YAML::Emitter out;
+
+        out << YAML::BeginMap;
+        out << YAML::Key << "CellSize" << YAML::Value << cellSize;
+        out << YAML::Key << "PersistentModels" << YAML::Value << YAML::Flow << GetModels(ecs, persistent);
+        out << YAML::Key << "Cells" << YAML::Value << YAML::BeginSeq;
+
+        for (auto& [coords, cell] : cells) {
+            std::string file = "Cell_" + std::to_string(coords.first) + "_" + std::to_string(coords.second) + ".blscene";
+            serializer.Serialize(directory / file, cell.Entities);
+
+            out << YAML::BeginMap;
+            out << YAML::Key << "X" << YAML::Value << coords.first;
+            out << YAML::Key << "Z" << YAML::Value << coords.second;
+            out << YAML::Key << "File" << YAML::Value << file;
+            out << YAML::Key << "EntityCount" << YAML::Value << cell.Entities.size();
+            out << YAML::Key << "EstimatedBytes" << YAML::Value << cell.EstimatedBytes;
+            out << YAML::Key << "Models" << YAML::Value << YAML::Flow << GetModels(ecs, cell.Entities);
+            out << YAML::EndMap;
+        }
+
+        out << YAML::EndSeq << YAML::EndMap;
+
+        std::ofstream stream(directory / s_IndexFileName);
+        stream << out.c_str();
+
+        BL_CORE_INFO("Partitioned scene into {} cells ({} persistent entities)", cells.size(), persistent.size());
+    }
+
+    void WorldPartition::Update(const BlVec3& position) {
+        BL_PROFILE_SCOPE("WorldPartition::Update");
+
+        MergeFinishedLoads();
+
+        std::vector<std::pair<f32, u32>> candidates; // distance, cell
+
+        for (u32 i = 0; i < m_Cells.size(); i++) {
+            Cell& cell = m_Cells[i];
+            f32 distance = GetDistance(cell, position);
+
+            if (distance > m_Specification.UnloadRadius) {
+                if (cell.State == CellState::Loaded) {
+                    Unload(i);
+                } else if (cell.State == CellState::Loading) {
+                    cell.Cancelled = true;
+                }
+            } else if (distance <= m_Specification.LoadRadius) {
+                if (cell.State == CellState::Unloaded) {
+                    candidates.emplace_back(distance, i);
+                } else if (cell.State == CellState::Loading) {
+                    cell.Cancelled = false; // came back before it finished loading
+                }
+            }
+        }
+
+        std::sort(candidates.begin(), candidates.end());
+
+        for (auto [distance, index] : candidates) {
+            u64 bytes = m_Cells[index].EstimatedBytes;
+
+            // Make room by unloading the loaded cells which are further away than this one (furthest first)
+            while (m_LoadedBytes + bytes > m_Specification.MemoryBudget) {
+                i32 furthest = -1;
+                f32 furthestDistance = distance;
+
+                for (u32 i = 0; i < m_Cells.size(); i++) {
+                    if (m_Cells[i].State != CellState::Loaded) continue;
+
+                    f32 d = GetDistance(m_Cells[i], position);
+                    if (d > furthestDistance) {
+                        furthest = static_cast<i32>(i);
+                        furthestDistance = d;
+                    }
+                }
+
+                if (furthest < 0) break;
+
+                Unload(static_cast<u32>(furthest));
+            }
+
+            // Everything which is left is closer than this cell, so none of the further cells fit either
+            if (m_LoadedBytes + bytes > m_Specification.MemoryBudget) break;
+
+            RequestLoad(index);
+        }
+    }
+
+    void WorldPartition::UnloadAll() {
+        for (u32 i = 0; i < m_Cells.size(); i++) {
+            if (m_Cells[i].State == CellState::Loaded) {
+                Unload(i);
+            } else if (m_Cells[i].State == CellState::Loading) {
+                m_Cells[i].Cancelled = true;
+            }
+        }
+    }
+
+    const std::vector<WorldPartition::Cell>& WorldPartition::GetCells() const {
+        return m_Cells;
+    }
+
+    u32 WorldPartition::GetLoadedCellCount() const {
+        return static_cast<u32>(std::count_if(m_Cells.begin(), m_Cells.end(), [](const Cell& cell) { return cell.State == CellState::Loaded; }));
+    }
+
+    u64 WorldPartition::GetLoadedBytes() const {
+        return m_LoadedBytes;
+    }
+
+    void WorldPartition::LoadIndex() {
+        std::string contents = Util::ReadEntireFile(m_Specification.Directory / s_IndexFileName);
+
+        YAML::Node node = YAML::Load(contents.c_str());
+
+        if (!node["Cells"]) {
+            BL_CORE_WARN("No world partition found in {}!", m_Specification.Directory.String());
+            return;
+        }
+
+        m_CellSize = node["CellSize"].as<f32>();
+
+        for (auto yamlCell : node["Cells"]) {
+            Cell cell;
+            cell.X = yamlCell["X"].as<i32>();
+            cell.Z = yamlCell["Z"].as<i32>();
+            cell.File = yamlCell["File"].as<std::string>();
+            cell.EstimatedBytes = yamlCell["EstimatedBytes"].as<u64>();
+
+            if (yamlCell["Models"]) {
+                cell.Models = yamlCell["Models"].as<std::vector<u64>>();
+            }
+
+            m_Cells.push_back(cell);
+        }
+
+        if (!m_Specification.StreamAssets) return;
+
+        for (const Cell& cell : m_Cells) {
+            for (u64 model : cell.Models) {
+                m_ModelUsers[model] = 0;
+            }
+        }
+
+        // The models used outside of the cells have to stay loaded
+        if (node["PersistentModels"]) {
+            for (u64 model : node["PersistentModels"].as<std::vector<u64>>()) {
+                m_ModelUsers.erase(model);
+            }
+        }
+
+        if (m_ModelUsers.empty()) return; // the cells don't use any models (and the scene may not even have a project)
+
+        for (auto& [handle, asset] : Project::GetAssetManager().GetAllAssets()) {
+            if (asset.Type != AssetType::Prefab) continue;
+
+            const Ref<Prefab>& prefab = std::get<Ref<Prefab>>(asset.Data);
+            if (!prefab) continue;
+
+            prefab->GetECS()->GetEntitiesWithComponents<const MeshComponent>().each([&](const MeshComponent& mesh) {
+                m_ModelUsers.erase(mesh.MeshHandle);
+            });
+        }
+    }
+
+    void WorldPartition::RequestLoad(u32 index) {
+        Cell& cell = m_Cells[index];
+        cell.State = CellState::Loading;
+        cell.Cancelled = false;
+
+        m_LoadedBytes += cell.EstimatedBytes;
+
+        {
+            std::lock_guard lock(m_Mutex);
+            m_PendingLoads++;
+        }
+
+        FS::Path path = m_Specification.Directory / cell.File;
+        ThreadPool* pool = m_Specification.Pool ? m_Specification.Pool : &ThreadPool::Get();
+
+        // NOTE: Parsing the file only touches the job's own ECS, the scene only gets modified in MergeFinishedLoads
+        pool->Submit([this, index, path]() {
+            ECS* entities = SceneSerializer::DeserializeToECS(path);
+
+            std::lock_guard lock(m_Mutex);
+            m_FinishedLoads.push_back({ index, entities });
+            m_PendingLoads--;
+
+            m_LoadFinished.notify_all();
+        });
+    }
+
+    void WorldPartition::Unload(u32 index) {
+        Cell& cell = m_Cells[index];
+
+        // NOTE: Destroying the roots also destroys all of their children
+        m_Scene->DestroyEntities(cell.Roots);
+        ReleaseModels(cell);
+
+        cell.Roots.clear();
+        cell.State = CellState::Unloaded;
+
+        m_LoadedBytes -= cell.EstimatedBytes;
+    }
+
+    void WorldPartition::MergeFinishedLoads() {
+        std::vector<FinishedLoad> finished;
+
+        {
+            std::lock_guard lock(m_Mutex);
+            finished.swap(m_FinishedLoads);
+        }
+
+        u32 merged = 0;
+
+        for (u32 i = 0; i < finished.size(); i++) {
+            FinishedLoad& load = finished[i];
+            Cell& cell = m_Cells[load.Cell];
+
+            if (cell.Cancelled || !load.Entities) {
+                delete load.Entities;
+
+                cell.State = CellState::Unloaded;
+                cell.Cancelled = false;
+                m_LoadedBytes -= cell.EstimatedBytes;
+
+                continue;
+            }
+
+            // The rest has to wait for the next update
+            if (merged == m_Specification.MaxMergesPerUpdate) {
+                std::lock_guard lock(m_Mutex);
+                m_FinishedLoads.insert(m_FinishedLoads.end(), finished.begin() + i, finished.end());
+
+                break;
+            }
+
+            // NOTE: The models get loaded first, so the entities have their bounds (and get drawn) right away
+            AcquireModels(cell);
+
+            cell.Roots = m_Scene->MergeEntities(load.Entities);
+            cell.State = CellState::Loaded;
+
+            delete load.Entities;
+            merged++;
+        }
+    }
+
+    void WorldPartition::AcquireModels(const Cell& cell) {
+        AssetManager& assets = Project::GetAssetManager();
+
+        for (u64 model : cell.Models) {
+            auto it = m_ModelUsers.find(model);
+            if (it == m_ModelUsers.end()) continue; // not streamed
+
+            if (it->second++ == 0 && assets.IsAssetUnloaded(model)) {
+                assets.LoadAsset(model);
+            }
+        }
+    }
+
+    void WorldPartition::ReleaseModels(const Cell& cell) {
+        AssetManager& assets = Project::GetAssetManager();
+
+        for (u64 model : cell.Models) {
+            auto it = m_ModelUsers.find(model);
+            if (it == m_ModelUsers.end()) continue;
+
+            if (--it->second == 0) {
+                assets.UnloadAsset(model);
+            }
+        }
+    }
+
+    void WorldPartition::UnloadUnusedModels() {
+        if (m_ModelUsers.empty()) return;
+
+        AssetManager& assets = Project::GetAssetManager();
+
+        for (auto& [model, users] : m_ModelUsers) {
+            if (users == 0) {
+                assets.UnloadAsset(model);
+            }
+        }
+    }
+
+    f32 WorldPartition::GetDistance(const Cell& cell, const BlVec3& position) const {
+        f32 minX = static_cast<f32>(cell.X) * m_CellSize;
+        f32 minZ = static_cast<f32>(cell.Z) * m_CellSize;
+
+        f32 dx = std::max({ minX - position.x, 0.0f, position.x - (minX + m_CellSize) });
+        f32 dz = std::max({ minZ - position.z, 0.0f, position.z - (minZ + m_CellSize) });
+
+        return std::sqrt(dx * dx + dz * dz);
+    }
+
+} // namespace Blackberry
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "blackberry/core/types.hpp"
+#include "blackberry/core/path.hpp"
+#include "blackberry/core/memory.hpp"
+#include "blackberry/ecs/ecs.hpp"
+
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+
+namespace Blackberry {
+
+    class Scene;
+    class ThreadPool;
+
+    struct WorldPartitionSpecification {
+        FS::Path Directory; // the directory WorldPartition::Build wrote the cells to
+
+        // Cells within LoadRadius of the streaming position get loaded, but only get unloaded once they are further away
+        // than UnloadRadius (so walking along a cell border doesn't keep loading and unloading it)
+        f32 LoadRadius = 128.0f;
+        f32 UnloadRadius = 192.0f;
+
+        // Estimated bytes of the loaded cells, once this is reached the furthest cells get unloaded to make room for closer ones
+        u64 MemoryBudget = 256ull * 1024 * 1024;
+
+        // How many finished cells get merged into the scene per update (merging is the only part which runs on the main thread)
+        u32 MaxMergesPerUpdate = 4;
+
+        // Unloads the models which only the unloaded cells use and loads them again along with the cells (see AssetManager::UnloadAsset)
+        // NOTE: Needs the scene's project, turn it off for scenes without one (e.g. headless tools)
+        bool StreamAssets = true;
+
+        ThreadPool* Pool = nullptr; // NOTE: If no thread pool is set the global one (ThreadPool::Get()) gets used
+    };
+
+    // Streams a big scene in and out in square cells (on the xz plane) around a position (e.g. the camera or the player)
+    //
+    // The scene first gets split up with Build: every root entity (and its children) goes into the cell its root is in,
+    // and every cell gets written as its own scene file. The entities which have to always be there (no transform,
+    // cameras, scripts, directional lights, environments) go into Persistent.blscene, which is the scene to open and stream into.
+    //
+    // Cells get parsed into a standalone ECS on worker threads (see SceneSerializer::DeserializeToECS),
+    // the main thread only merges the finished ones into the scene (Scene::MergeEntities) during Update
+    //
+    // The models the cells use get streamed along with them: a model which no loaded cell uses gets unloaded
+    // (unless the persistent entities or a prefab use it), and loaded again on the main thread right before the cell gets merged
+    // NOTE: The rest of the assets stay loaded, they are owned by the project's asset manager
+    class WorldPartition {
+    public:
+        enum class CellState { Unloaded, Loading, Loaded };
+
+        struct Cell {
+            i32 X = 0;
+            i32 Z = 0;
+            FS::Path File; // relative to the partition's directory
+
+            u64 EstimatedBytes = 0;
+
+            CellState State = CellState::Unloaded;
+            bool Cancelled = false; // the cell left the unload radius while it was loading, so it gets thrown away once it's done
+            std::vector<u64> Roots; // the root entities the cell added to the scene (while it is loaded)
+            std::vector<u64> Models; // asset handles of the models the cell's entities use
+        };
+
+    public:
+        WorldPartition(Scene* scene, const WorldPartitionSpecification& spec);
+        // NOTE: Waits for the cells which are still loading, loaded cells stay in the scene and the unloaded models get loaded again
+        ~WorldPartition();
+
+        WorldPartition(const WorldPartition&) = delete;
+        WorldPartition& operator=(const WorldPartition&) = delete;
+
+        // Splits the scene into cells of cellSize x cellSize and writes them (and the index) into directory, which has to exist
+        static void Build(Ref<Scene> scene, const FS::Path& directory, f32 cellSize);
+
+        // Merges cells which finished loading, unloads cells outside the unload radius and starts loading the ones
+        // inside the load radius (closest first) while they fit into the memory budget
+        // NOTE: Must be called from the main thread, outside of the scene's update (it creates and destroys entities)
+        void Update(const BlVec3& position);
+
+        // Unloads every cell (cells which are still loading get thrown away once they are done)
+        void UnloadAll();
+
+        const std::vector<Cell>& GetCells() const;
+        u32 GetLoadedCellCount() const;
+        u64 GetLoadedBytes() const; // estimated, includes the cells which are still loading
+
+        static constexpr const char* s_IndexFileName = "World.blpartition";
+        static constexpr const char* s_PersistentFileName = "Persistent.blscene";
+
+    private:
+        void LoadIndex();
+
+        void RequestLoad(u32 cell);
+        void Unload(u32 cell);
+        void MergeFinishedLoads();
+
+        // Keep track of how many loaded cells use each model, the first cell loads it and the last one unloads it
+        void AcquireModels(const Cell& cell);
+        void ReleaseModels(const Cell& cell);
+        void UnloadUnusedModels();
+
+        // Distance from position to the closest point of the cell (on the xz plane)
+        f32 GetDistance(const Cell& cell, const BlVec3& position) const;
+
+    private:
+        Scene* m_Scene = nullptr;
+        WorldPartitionSpecification m_Specification;
+
+        f32 m_CellSize = 0.0f;
+        std::vector<Cell> m_Cells;
+        u64 m_LoadedBytes = 0;
+
+        std::unordered_map<u64, u32> m_ModelUsers; // model -> loaded cells using it (only the models which get streamed)
+
+        struct FinishedLoad {
+            u32 Cell = 0;
+            ECS* Entities = nullptr; // nullptr if the file couldn't be loaded
+        };
+
+        // Shared with the loading jobs
+        std::mutex m_Mutex;
+        std::condition_variable m_LoadFinished;
+        std::vector<FinishedLoad> m_FinishedLoads;
+        u32 m_PendingLoads = 0;
+    };
+
+} // namespace Blackberry
@@ -6,6 +6,7 @@
 #include "glad/gl.h"
 
 #include <iostream>
+#include <algorithm>
 
 namespace Blackberry {
 
@@ -93,6 +94,12 @@ namespace Blackberry {
         }
     }
 
+    OpenGLRendererAPI::~OpenGLRendererAPI() {
+        if (m_IndirectBuffer != 0) {
+            glDeleteBuffers(1, &m_IndirectBuffer);
+        }
+    }
+
     void OpenGLRendererAPI::SetViewportSize(BlVec2 size) const {
         glViewport(0, 0, size.x, size.y);
         m_PreviousFramebufferSize = m_CurrentFramebufferSize;
@@ -204,6 +211,40 @@ namespace Blackberry {
         glBindVertexArray(0);
     }
 
+    void OpenGLRendererAPI::DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, u32 indexCount, u32 firstIndex, u32 baseVertex, u32 count, u32 baseInstance) const {
+        glBindVertexArray(vertexArray->ID);
+
+        glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, reinterpret_cast<void*>(static_cast<uintptr_t>(firstIndex) * sizeof(u32)), count, baseVertex, baseInstance);
+
+        glBindVertexArray(0);
+    }
+
+    void OpenGLRendererAPI::DrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const std::vector<DrawIndexedIndirectCommand>& commands) const {
+        if (commands.empty()) return;
+
+        u32 size = static_cast<u32>(sizeof(DrawIndexedIndirectCommand) * commands.size());
+
+        if (m_IndirectBuffer == 0) {
+            glCreateBuffers(1, &m_IndirectBuffer);
+        }
+
+        // NOTE: Only reallocated when the commands don't fit anymore
+        if (size > m_IndirectBufferSize) {
+            m_IndirectBufferSize = std::max(size, m_IndirectBufferSize * 2);
+            glNamedBufferData(m_IndirectBuffer, m_IndirectBufferSize, nullptr, GL_STREAM_DRAW);
+        }
+
+        glNamedBufferSubData(m_IndirectBuffer, 0, size, commands.data());
+
+        glBindVertexArray(vertexArray->ID);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_IndirectBuffer);
+
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(commands.size()), 0);
+
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        glBindVertexArray(0);
+    }
+
     void OpenGLRendererAPI::BindShader(const Ref<Shader>& shader) const {
         glUseProgram(shader->ID);
     }
@@ -13,6 +13,7 @@ namespace Blackberry {
     class OpenGLRendererAPI : public RendererAPI {
     public:
         OpenGLRendererAPI();
+        virtual ~OpenGLRendererAPI() override;
 
         virtual void SetViewportSize(BlVec2 size) const override;
         virtual void ClearFramebuffer(const BlVec4& color = BlVec4(0.0f)) const override;
@@ -28,6 +29,8 @@ namespace Blackberry {
         
         virtual void DrawVertexArray(const Ref<VertexArray>& vertexArray) const override;
         virtual void DrawVertexArrayInstanced(const Ref<VertexArray>& vertexArray, u32 count) const override;
+        virtual void DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, u32 indexCount, u32 firstIndex, u32 baseVertex, u32 count, u32 baseInstance) const override;
+        virtual void DrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const std::vector<DrawIndexedIndirectCommand>& commands) const override;
 
         virtual void BindShader(const Ref<Shader>& shader) const override;
 
@@ -43,6 +46,9 @@ namespace Blackberry {
     private:
         mutable BlVec2 m_CurrentFramebufferSize;
         mutable BlVec2 m_PreviousFramebufferSize;
+
+        mutable u32 m_IndirectBuffer = 0; // the commands of DrawIndexedIndirect (created on the first indirect draw)
+        mutable u32 m_IndirectBufferSize = 0;
     };
 
 } // namespace Blackberry
@@ -0,0 +1,75 @@
+// Microbenchmark for copying scenes with the heap owning components (names, material overrides, script paths)
+// Usage: component-copy-benchmark [entity count] (defaults to 100k)
+//
+// Every entity gets a name which is too long for the small string optimization, a transform and a mesh with two
+// material overrides, every 10th entity gets a script. Reports the time of a full ECS::Copy (what starting to play a
+// scene used to cost and what copying a prefab/world cell still does) and the memory the ECS uses (see ECS::GetStats)
+
+#include "blackberry/ecs/ecs.hpp"
+#include "blackberry/core/timer.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace Blackberry;
+
+static constexpr u32 s_Iterations = 10;
+
+static ECS* BuildECS(u32 count) {
+    ECS* ecs = new ECS();
+
+    for (u32 i = 0; i < count; i++) {
+        EntityID entity = ecs->CreateEntity();
+
+        ecs->AddComponent<TagComponent>(entity, TagComponent{ "Environment Prop " + std::to_string(i), i + 1ull });
+        ecs->AddComponent<TransformComponent>(entity, TransformComponent{});
+
+        MeshComponent mesh;
+        mesh.MeshHandle = i % 16;
+        mesh.MaterialHandles.Set(0, 100 + i % 8);
+        mesh.MaterialHandles.Set(2, 200 + i % 8);
+        ecs->AddComponent<MeshComponent>(entity, mesh);
+
+        if (i % 10 == 0) {
+            ScriptComponent script;
+            script.ModulePath = "Scripts/Props/Rotate.lua";
+            ecs->AddComponent<ScriptComponent>(entity, script);
+        }
+    }
+
+    return ecs;
+}
+
+int main(int argc, char** argv) {
+    u32 count = argc > 1 ? static_cast<u32>(std::strtoul(argv[1], nullptr, 10)) : 100'000;
+
+    ECS* ecs = BuildECS(count);
+
+    delete ECS::Copy(ecs); // warm up
+
+    Timer timer;
+    timer.Start();
+
+    for (u32 i = 0; i < s_Iterations; i++) {
+        delete ECS::Copy(ecs);
+    }
+
+    f32 copyTime = timer.ElapsedMilliseconds() / static_cast<f32>(s_Iterations);
+
+    ECSStats stats = ecs->GetStats();
+
+    std::printf("%u entities, average of %u iterations\n", count, s_Iterations);
+    std::printf("%-22s %10.3f ms\n", "ECS::Copy", copyTime);
+    std::printf("%-22s %10.2f MB\n", "ECS memory", stats.GetTotalBytes() / (1024.0 * 1024.0));
+    std::printf("%-22s %10.2f MB (%u strings)\n", "Interned strings", stats.InternedStringBytes / (1024.0 * 1024.0), stats.InternedStrings);
+
+    for (const ComponentPoolStats& pool : stats.Pools) {
+        if (pool.Count == 0) continue;
+
+        std::printf("  %-20s %8u x %4u B, %8.2f MB (heap %.2f MB)\n", pool.Name, pool.Count, pool.ComponentSize,
+            pool.GetTotalBytes() / (1024.0 * 1024.0), pool.HeapBytes / (1024.0 * 1024.0));
+    }
+
+    delete ecs;
+}
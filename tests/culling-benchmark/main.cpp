@@ -0,0 +1,227 @@
+// Benchmark and equivalence check for CullingBoxes::Cull
+// First checks that every kernel the build supports (AVX, SSE and the scalar one, which also does the boxes left over
+// after the last full vector) gives exactly the same answer as Frustum::Overlaps, for box counts which aren't a multiple
+// of 8 and for boxes which touch a plane exactly. Then times the old loop (Frustum::Overlaps per box) against every kernel
+// Usage: culling-benchmark [iterations] (defaults to 20), exits with 1 if any kernel disagrees
+
+#include "blackberry/scene/frustum_culling.hpp"
+#include "blackberry/core/timer.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+using namespace Blackberry;
+
+static const char* GetKernelName(CullingKernel kernel) {
+    switch (kernel) {
+        case CullingKernel::Scalar: return "scalar";
+        case CullingKernel::SSE: return "SSE";
+        case CullingKernel::AVX: return "AVX";
+    }
+
+    return "";
+}
+
+static std::vector<CullingKernel> GetSupportedKernels() {
+    std::vector<CullingKernel> kernels;
+
+    for (CullingKernel kernel : { CullingKernel::Scalar, CullingKernel::SSE, CullingKernel::AVX }) {
+        if (CullingBoxes::IsSupported(kernel)) {
+            kernels.push_back(kernel);
+        }
+    }
+
+    return kernels;
+}
+
+static Frustum GetCameraFrustum() {
+    BlMat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 500.0f);
+    BlMat4 view = glm::lookAt(BlVec3(0.0f, 10.0f, 0.0f), BlVec3(50.0f, 0.0f, -100.0f), BlVec3(0.0f, 1.0f, 0.0f));
+
+    return Frustum::FromMatrix(projection * view);
+}
+
+// Boxes all around the camera, about a third of them end up in the frustum
+static std::vector<AABB> GetRandomBoxes(u32 count, u32 seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<f32> position(-500.0f, 500.0f);
+    std::uniform_real_distribution<f32> size(0.1f, 10.0f);
+
+    std::vector<AABB> boxes(count);
+    for (AABB& box : boxes) {
+        box = AABB::FromCenter(BlVec3(position(rng), position(rng) * 0.1f, position(rng)), BlVec3(size(rng), size(rng), size(rng)));
+    }
+
+    return boxes;
+}
+
+// The cube from -10 to 10 on every axis, the numbers are exact so boxes can touch the planes exactly
+static Frustum GetCubeFrustum() {
+    Frustum frustum;
+    frustum.Planes[0] = BlVec4( 1.0f,  0.0f,  0.0f, 10.0f);
+    frustum.Planes[1] = BlVec4(-1.0f,  0.0f,  0.0f, 10.0f);
+    frustum.Planes[2] = BlVec4( 0.0f,  1.0f,  0.0f, 10.0f);
+    frustum.Planes[3] = BlVec4( 0.0f, -1.0f,  0.0f, 10.0f);
+    frustum.Planes[4] = BlVec4( 0.0f,  0.0f,  1.0f, 10.0f);
+    frustum.Planes[5] = BlVec4( 0.0f,  0.0f, -1.0f, 10.0f);
+
+    return frustum;
+}
+
+// Boxes right outside of every face of the cube frustum: touching it exactly (visible), a tiny gap away (culled) and overlapping it
+static std::vector<AABB> GetBoxesOnPlanes() {
+    std::vector<AABB> boxes;
+
+    for (u32 axis = 0; axis < 3; axis++) {
+        for (f32 side : { -1.0f, 1.0f }) {
+            for (f32 gap : { 0.0f, 0.125f, -0.25f }) {
+                for (f32 extent : { 0.5f, 2.0f, 0.0f }) {
+                    BlVec3 center(0.0f);
+                    center[axis] = side * (10.0f + extent + gap);
+
+                    boxes.push_back(AABB::FromCenter(center, BlVec3(extent)));
+                }
+            }
+        }
+    }
+
+    return boxes;
+}
+
+// Returns how many boxes the kernel got wrong (compared to Frustum::Overlaps)
+static u32 CheckKernel(const Frustum& frustum, const std::vector<AABB>& boxes, CullingKernel kernel, const char* name) {
+    CullingBoxes culling;
+    for (const AABB& box : boxes) {
+        culling.Add(box);
+    }
+
+    std::vector<u8> visible;
+    u32 visibleCount = culling.Cull(frustum, visible, kernel);
+
+    u32 expectedCount = 0;
+    u32 mismatches = 0;
+
+    for (u32 i = 0; i < boxes.size(); i++) {
+        bool expected = frustum.Overlaps(boxes[i]);
+        expectedCount += expected;
+
+        if (visible[i] != static_cast<u8>(expected)) {
+            if (mismatches < 5) {
+                std::printf("  %s, %s kernel: box %u is %s, Frustum::Overlaps says %s\n", name, GetKernelName(kernel), i,
+                            visible[i] ? "visible" : "culled", expected ? "visible" : "culled");
+            }
+
+            mismatches++;
+        }
+    }
+
+    if (visibleCount != expectedCount) {
+        std::printf("  %s, %s kernel: counted %u visible boxes, there are %u\n", name, GetKernelName(kernel), visibleCount, expectedCount);
+        mismatches++;
+    }
+
+    return mismatches;
+}
+
+static u32 CheckEquivalence(const std::vector<CullingKernel>& kernels) {
+    u32 errors = 0;
+
+    Frustum camera = GetCameraFrustum();
+    Frustum cube = GetCubeFrustum();
+
+    // Every count from 0 to 40 (so every possible amount of boxes left over after the last full vector) plus some bigger ones
+    std::vector<u32> counts;
+    for (u32 count = 0; count <= 40; count++) {
+        counts.push_back(count);
+    }
+    counts.insert(counts.end(), { 1000, 1001, 1003, 1007, 100003 });
+
+    std::vector<AABB> onPlanes = GetBoxesOnPlanes();
+
+    for (CullingKernel kernel : kernels) {
+        u32 kernelErrors = 0;
+
+        for (u32 count : counts) {
+            kernelErrors += CheckKernel(camera, GetRandomBoxes(count, count), kernel, "random boxes");
+
+            // The boxes on the planes repeated up to count, so they land in the vectors as well as in the leftovers
+            std::vector<AABB> boxes(count);
+            for (u32 i = 0; i < count; i++) {
+                boxes[i] = onPlanes[i % onPlanes.size()];
+            }
+
+            kernelErrors += CheckKernel(cube, boxes, kernel, "boxes on the planes");
+        }
+
+        std::printf("%-8s %s\n", GetKernelName(kernel), kernelErrors == 0 ? "matches Frustum::Overlaps" : "DOES NOT match Frustum::Overlaps");
+        errors += kernelErrors;
+    }
+
+    return errors;
+}
+
+static void RunBenchmark(const std::vector<CullingKernel>& kernels, u32 count, u32 iterations) {
+    Frustum frustum = GetCameraFrustum();
+    std::vector<AABB> boxes = GetRandomBoxes(count, 42);
+
+    CullingBoxes culling;
+    culling.Reserve(count);
+    for (const AABB& box : boxes) {
+        culling.Add(box);
+    }
+
+    std::vector<u8> visible(count);
+    u32 checksum = 0; // NOTE: Keeps the compiler from throwing the loops away
+
+    // What the renderer did before: one Frustum::Overlaps per box
+    Timer timer;
+    timer.Start();
+
+    for (u32 it = 0; it < iterations; it++) {
+        for (u32 i = 0; i < count; i++) {
+            visible[i] = frustum.Overlaps(boxes[i]);
+            checksum += visible[i];
+        }
+    }
+
+    f32 baseline = timer.ElapsedMilliseconds() / static_cast<f32>(iterations);
+    std::printf("%10u %-10s %10.3f %9.2fx\n", count, "Overlaps", baseline, 1.0f);
+
+    for (CullingKernel kernel : kernels) {
+        timer.Start();
+
+        for (u32 it = 0; it < iterations; it++) {
+            checksum += culling.Cull(frustum, visible, kernel);
+        }
+
+        f32 ms = timer.ElapsedMilliseconds() / static_cast<f32>(iterations);
+        std::printf("%10u %-10s %10.3f %9.2fx\n", count, GetKernelName(kernel), ms, baseline / ms);
+    }
+
+    if (checksum == 0) {
+        std::printf("(nothing was visible)\n");
+    }
+}
+
+int main(int argc, char** argv) {
+    u32 iterations = argc > 1 ? static_cast<u32>(std::strtoul(argv[1], nullptr, 10)) : 20;
+
+    std::vector<CullingKernel> kernels = GetSupportedKernels();
+
+    u32 errors = CheckEquivalence(kernels);
+
+    std::printf("\n%10s %-10s %10s %10s\n", "boxes", "kernel", "ms", "speedup");
+    for (u32 count : { 10000u, 100000u, 1000000u }) {
+        RunBenchmark(kernels, count, iterations);
+    }
+
+    if (errors != 0) {
+        std::printf("\nFAILED (%u mismatches)\n", errors);
+        return 1;
+    }
+
+    return 0;
+}
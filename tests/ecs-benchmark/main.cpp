@@ -0,0 +1,263 @@
+// Headless benchmark for the core Scene/ECS operations (no window, no GL context)
+// Usage: ecs-benchmark [--out results.json] [--baseline baseline.json] [entity counts...] (defaults to 1k, 100k and 1M)
+//
+// Every operation gets timed at every entity count and the results get written as JSON, when a baseline
+// (the results of an earlier run) is passed every result gets compared against it and the benchmark
+// fails (returns 1) if anything got more than s_RegressionThreshold slower
+
+#include "blackberry/scene/scene.hpp"
+#include "blackberry/scene/scene_serializer.hpp"
+#include "blackberry/physics/physics_engine.hpp"
+#include "blackberry/core/timer.hpp"
+#include "blackberry/core/log.hpp"
+
+#include "json.hpp"
+using json = nlohmann::json;
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <random>
+#include <fstream>
+#include <algorithm>
+
+using namespace Blackberry;
+
+static constexpr f64 s_RegressionThreshold = 0.10; // 10%
+
+// Caps for the operations which are too slow to run once per entity at 1M entities
+static constexpr u32 s_MaxDuplicates = 10'000;
+static constexpr u32 s_MaxReparents = 1'000;
+
+// Keeps the compiler from optimizing the loops away
+static volatile f32 s_Sink = 0.0f;
+
+struct BenchmarkResult {
+    std::string Name;
+    u32 Entities = 0;
+    u32 Operations = 0; // how many times the operation ran (e.g. how many entities got duplicated)
+    f64 Milliseconds = 0.0; // for all the operations together
+};
+
+static std::vector<BenchmarkResult> s_Results;
+
+template <typename Func>
+static void Measure(const char* name, u32 entities, u32 operations, Func&& func) {
+    Timer timer;
+    timer.Start();
+
+    func();
+
+    f64 ms = timer.ElapsedMilliseconds();
+    s_Results.push_back({ name, entities, operations, ms });
+
+    std::printf("%-28s %10u %10u %12.3f\n", name, entities, operations, ms);
+}
+
+// For the cheap operations, runs func iterations times and reports the average
+template <typename Func>
+static void MeasureAverage(const char* name, u32 entities, u32 iterations, Func&& func) {
+    func(); // warm up
+
+    Timer timer;
+    timer.Start();
+
+    for (u32 i = 0; i < iterations; i++) {
+        func();
+    }
+
+    f64 ms = timer.ElapsedMilliseconds() / static_cast<f64>(iterations);
+    s_Results.push_back({ name, entities, entities, ms });
+
+    std::printf("%-28s %10u %10u %12.3f\n", name, entities, entities, ms);
+}
+
+static void RunBenchmarks(u32 count) {
+    SceneSpecification spec;
+    spec.Headless = true;
+
+    Ref<Scene> scene(new Scene(spec));
+
+    std::vector<u64> uuids(count);
+
+    Measure("CreateEntities", count, count, [&]() {
+        scene->ReserveEntities(count);
+
+        for (u32 i = 0; i < count; i++) {
+            EntityID entity = scene->CreateEntity("Entity");
+            scene->GetECS()->AddComponent<TransformComponent>(entity, TransformComponent{});
+
+            uuids[i] = scene->GetECS()->GetComponent<const TagComponent>(entity).UUID;
+        }
+    });
+
+    std::mt19937 rng(1234);
+
+    // NOTE: Only the second half gets reparented (and only under the first half), so there can't be any cycles
+    u32 reparents = std::min(count / 2, s_MaxReparents);
+    std::uniform_int_distribution<u32> parents(0, std::max(count / 2, 1u) - 1);
+
+    Measure("SetEntityParent", count, reparents, [&]() {
+        for (u32 i = 0; i < reparents; i++) {
+            scene->SetEntityParent(uuids[count / 2 + i], uuids[parents(rng)]);
+        }
+    });
+
+    u32 iterations = std::clamp(10'000'000u / std::max(count, 1u), 1u, 100u);
+
+    MeasureAverage("ViewIteration", count, iterations, [&]() {
+        f32 sum = 0.0f;
+        scene->GetECS()->GetEntitiesWithComponents<const TransformComponent, const RelationshipComponent>().each(
+            [&](const TransformComponent& transform, const RelationshipComponent& relationship) {
+                sum += transform.Position.x + static_cast<f32>(relationship.Parent & 1);
+            });
+        s_Sink = sum;
+    });
+
+    std::vector<u64> shuffled = uuids;
+    std::shuffle(shuffled.begin(), shuffled.end(), rng);
+
+    MeasureAverage("UUIDLookup", count, iterations, [&]() {
+        u32 sum = 0;
+        for (u64 uuid : shuffled) {
+            sum += static_cast<u32>(entt::to_entity(scene->GetEntityFromUUID(uuid)));
+        }
+        s_Sink = static_cast<f32>(sum);
+    });
+
+    MeasureAverage("Scene::Copy", count, iterations, [&]() {
+        Ref<Scene> copy = Scene::Copy(scene);
+        copy->Delete();
+    });
+
+    // What a copy costs once every pool got written to (e.g. after a few frames of playing)
+    MeasureAverage("Scene::Copy (all written)", count, std::max(iterations / 10, 1u), [&]() {
+        Ref<Scene> copy = Scene::Copy(scene);
+        copy->GetECS()->MakeAllWritable();
+        copy->Delete();
+    });
+
+    u32 duplicates = std::min(count, s_MaxDuplicates);
+
+    Measure("DuplicateEntity", count, duplicates, [&]() {
+        for (u32 i = 0; i < duplicates; i++) {
+            scene->DuplicateEntity(uuids[i]);
+        }
+    });
+
+    FS::Path path = "ecs-benchmark-scene.blscene";
+    u32 entityCount = static_cast<u32>(scene->GetEntities().size());
+
+    Measure("SceneSerializer::Serialize", entityCount, entityCount, [&]() {
+        SceneSerializer serializer(scene);
+        serializer.Serialize(path);
+    });
+
+    Ref<Scene> loaded(new Scene(spec));
+
+    Measure("SceneSerializer::Deserialize", entityCount, entityCount, [&]() {
+        SceneSerializer serializer(loaded);
+        serializer.Deserialize(path);
+    });
+
+    loaded->Delete();
+    std::remove(path.String().c_str());
+
+    std::vector<u64> roots = scene->GetRootEntities();
+
+    Measure("DestroyEntities", entityCount, entityCount, [&]() {
+        scene->DestroyEntities(roots); // the children go with them
+    });
+
+    scene->Delete();
+}
+
+static std::string ResultKey(const BenchmarkResult& result) {
+    return result.Name + "/" + std::to_string(result.Entities);
+}
+
+static void WriteResults(const std::string& path) {
+    json j;
+
+    for (const BenchmarkResult& result : s_Results) {
+        j["Results"][ResultKey(result)] = {
+            {"Name", result.Name},
+            {"Entities", result.Entities},
+            {"Operations", result.Operations},
+            {"Milliseconds", result.Milliseconds}
+        };
+    }
+
+    std::ofstream stream(path);
+    stream << j.dump(4);
+}
+
+// Returns how many results got slower than the threshold
+static u32 CompareWithBaseline(const std::string& path) {
+    std::ifstream stream(path);
+    if (!stream) {
+        std::printf("Could not open baseline %s!\n", path.c_str());
+        return 0;
+    }
+
+    json baseline = json::parse(stream);
+    u32 regressions = 0;
+
+    std::printf("\n%-40s %12s %12s %9s\n", "compared to baseline", "baseline", "current", "change");
+
+    for (const BenchmarkResult& result : s_Results) {
+        std::string key = ResultKey(result);
+        if (!baseline["Results"].contains(key)) continue;
+
+        f64 before = baseline["Results"][key]["Milliseconds"].get<f64>();
+        f64 change = before > 0.0 ? result.Milliseconds / before - 1.0 : 0.0;
+        bool regressed = change > s_RegressionThreshold;
+
+        std::printf("%-40s %12.3f %12.3f %+8.1f%%%s\n", key.c_str(), before, result.Milliseconds, change * 100.0, regressed ? "  REGRESSION" : "");
+
+        if (regressed) regressions++;
+    }
+
+    return regressions;
+}
+
+int main(int argc, char** argv) {
+    Logger::GetCoreLogger()->set_level(spdlog::level::warn); // duplicating entities logs every copy
+
+    PhysicsEngine::Initialize(); // every scene owns a physics world
+
+    std::string outPath = "ecs-benchmark.json";
+    std::string baselinePath;
+    std::vector<u32> entityCounts;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            baselinePath = argv[++i];
+        } else {
+            entityCounts.push_back(static_cast<u32>(std::strtoul(argv[i], nullptr, 10)));
+        }
+    }
+
+    if (entityCounts.empty()) {
+        entityCounts = { 1'000, 100'000, 1'000'000 };
+    }
+
+    std::printf("%-28s %10s %10s %12s\n", "", "entities", "ops", "ms");
+
+    for (u32 count : entityCounts) {
+        RunBenchmarks(count);
+    }
+
+    WriteResults(outPath);
+    std::printf("\nWrote results to %s\n", outPath.c_str());
+
+    u32 regressions = baselinePath.empty() ? 0 : CompareWithBaseline(baselinePath);
+
+    PhysicsEngine::Shutdown();
+
+    return regressions > 0 ? 1 : 0;
+}
@@ -0,0 +1,117 @@
+// Microbenchmark comparing EntityIndex (Scene's UUID -> entity map) with std::unordered_map
+// Usage: entity-index-benchmark [entity count] (defaults to 1M)
+
+#include "blackberry/scene/entity_index.hpp"
+#include "blackberry/core/timer.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <random>
+#include <unordered_map>
+#include <algorithm>
+
+using namespace Blackberry;
+
+struct BenchmarkResult {
+    f32 Insert = 0.0f;
+    f32 ReservedInsert = 0.0f;
+    f32 Hit = 0.0f;
+    f32 Miss = 0.0f;
+    f32 Erase = 0.0f;
+};
+
+// Keeps the compiler from optimizing the lookups away
+static volatile u64 s_Sink = 0;
+
+template <typename InsertFunc, typename FindFunc, typename EraseFunc, typename ReserveFunc>
+static BenchmarkResult Run(const std::vector<u64>& keys, const std::vector<u64>& lookups, const std::vector<u64>& misses,
+                           InsertFunc insert, FindFunc find, EraseFunc erase, ReserveFunc reserve) {
+    BenchmarkResult result;
+    Timer timer;
+
+    timer.Start();
+    for (u32 i = 0; i < keys.size(); i++) {
+        insert(keys[i], static_cast<EntityID>(i));
+    }
+    result.Insert = timer.ElapsedMilliseconds();
+
+    u64 sum = 0;
+    timer.Start();
+    for (u64 key : lookups) {
+        sum += find(key);
+    }
+    result.Hit = timer.ElapsedMilliseconds();
+
+    timer.Start();
+    for (u64 key : misses) {
+        sum += find(key);
+    }
+    result.Miss = timer.ElapsedMilliseconds();
+
+    timer.Start();
+    for (u64 key : keys) {
+        erase(key);
+    }
+    result.Erase = timer.ElapsedMilliseconds();
+
+    // Same thing again, but this time the map knows the final size up front (like when loading a scene)
+    reserve(static_cast<u32>(keys.size()));
+    timer.Start();
+    for (u32 i = 0; i < keys.size(); i++) {
+        insert(keys[i], static_cast<EntityID>(i));
+    }
+    result.ReservedInsert = timer.ElapsedMilliseconds();
+
+    s_Sink = sum;
+
+    return result;
+}
+
+static void Print(const char* name, const BenchmarkResult& result, u32 count) {
+    auto nsPerOp = [count](f32 ms) { return ms * 1'000'000.0f / static_cast<f32>(count); };
+
+    std::printf("%-20s %10.2f %10.2f %10.2f %10.2f %10.2f\n", name,
+                nsPerOp(result.Insert), nsPerOp(result.ReservedInsert), nsPerOp(result.Hit), nsPerOp(result.Miss), nsPerOp(result.Erase));
+}
+
+int main(int argc, char** argv) {
+    u32 count = argc > 1 ? static_cast<u32>(std::strtoul(argv[1], nullptr, 10)) : 1'000'000;
+
+    std::mt19937_64 rng(1234);
+    std::vector<u64> keys(count);
+    std::vector<u64> misses(count);
+    for (u32 i = 0; i < count; i++) {
+        keys[i] = rng();
+        misses[i] = rng();
+    }
+
+    // Look the keys up in a different order than they were inserted
+    std::vector<u64> lookups = keys;
+    std::shuffle(lookups.begin(), lookups.end(), rng);
+
+    BenchmarkResult indexResult;
+    {
+        EntityIndex index;
+        indexResult = Run(keys, lookups, misses,
+            [&](u64 key, EntityID entity) { index.Insert(key, entity); },
+            [&](u64 key) -> u64 { const EntityID* entity = index.Find(key); return entity ? static_cast<u64>(*entity) : 0; },
+            [&](u64 key) { index.Erase(key); },
+            [&](u32 size) { index.Reserve(size); });
+    }
+
+    BenchmarkResult mapResult;
+    {
+        std::unordered_map<u64, EntityID> map;
+        mapResult = Run(keys, lookups, misses,
+            [&](u64 key, EntityID entity) { map[key] = entity; },
+            [&](u64 key) -> u64 { auto it = map.find(key); return it != map.end() ? static_cast<u64>(it->second) : 0; },
+            [&](u64 key) { map.erase(key); },
+            [&](u32 size) { map.reserve(size); });
+    }
+
+    std::printf("%u entities (ns per operation)\n", count);
+    std::printf("%-20s %10s %10s %10s %10s %10s\n", "", "insert", "reserved", "hit", "miss", "erase");
+    Print("EntityIndex", indexResult, count);
+    Print("std::unordered_map", mapResult, count);
+}
@@ -0,0 +1,150 @@
+// Microbenchmark comparing the engine's owning groups (see EngineGroups in ecs.hpp) with the sparse set views they replaced
+// Usage: group-benchmark [entity count] (defaults to 1M)
+//
+// Every entity gets a transform, but only some of them get meshes/lights/rigid bodies (added in a shuffled order),
+// so the views have to jump around the pools while the groups walk packed arrays
+
+#include "blackberry/ecs/ecs.hpp"
+#include "blackberry/core/timer.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+using namespace Blackberry;
+
+static constexpr u32 s_Iterations = 20;
+
+// Keeps the compiler from optimizing the loops away
+static volatile f32 s_Sink = 0.0f;
+
+static ECS* BuildECS(u32 count) {
+    ECS* ecs = new ECS();
+
+    std::vector<EntityID> entities(count);
+    for (u32 i = 0; i < count; i++) {
+        entities[i] = ecs->CreateEntity();
+        ecs->AddComponent<TransformComponent>(entities[i], TransformComponent{});
+    }
+
+    // The same seed every time, so every ECS gets the exact same components in the exact same order
+    std::mt19937 rng(1234);
+    std::shuffle(entities.begin(), entities.end(), rng);
+
+    for (u32 i = 0; i < count; i++) {
+        EntityID entity = entities[i];
+
+        if (i % 2 == 0) {
+            MeshComponent mesh;
+            mesh.MeshHandle = i;
+            ecs->AddComponent<MeshComponent>(entity, mesh);
+        }
+
+        if (i % 8 == 1) {
+            ecs->AddComponent<PointLightComponent>(entity, PointLightComponent{});
+        }
+
+        if (i % 4 == 2) {
+            ecs->AddComponent<RigidBodyComponent>(entity, RigidBodyComponent{});
+            ecs->AddComponent<BoxColliderComponent>(entity, BoxColliderComponent{});
+        }
+    }
+
+    return ecs;
+}
+
+// Returns the average time of one iteration in milliseconds
+template <typename Func>
+static f32 Measure(Func&& func) {
+    func(); // warm up
+
+    Timer timer;
+    timer.Start();
+
+    for (u32 i = 0; i < s_Iterations; i++) {
+        func();
+    }
+
+    return timer.ElapsedMilliseconds() / static_cast<f32>(s_Iterations);
+}
+
+static void Print(const char* name, f32 view, f32 group) {
+    std::printf("%-28s %10.3f %10.3f %9.2fx\n", name, view, group, view / group);
+}
+
+int main(int argc, char** argv) {
+    u32 count = argc > 1 ? static_cast<u32>(std::strtoul(argv[1], nullptr, 10)) : 1'000'000;
+
+    // NOTE: Two separate ECSs, creating a group sorts its pools which would also speed the views up
+    ECS* viewECS = BuildECS(count);
+    ECS* groupECS = BuildECS(count);
+
+    f32 meshView = Measure([&]() {
+        f32 sum = 0.0f;
+        viewECS->GetEntitiesWithComponents<const WorldTransformComponent, const MeshComponent>().each(
+            [&](const WorldTransformComponent& transform, const MeshComponent& mesh) {
+                sum += transform.Matrix[3][0] + static_cast<f32>(mesh.MeshHandle);
+            });
+        s_Sink = sum;
+    });
+
+    f32 meshGroup = Measure([&]() {
+        f32 sum = 0.0f;
+        groupECS->GetGroup<const WorldTransformComponent, const MeshComponent>().each(
+            [&](const WorldTransformComponent& transform, const MeshComponent& mesh) {
+                sum += transform.Matrix[3][0] + static_cast<f32>(mesh.MeshHandle);
+            });
+        s_Sink = sum;
+    });
+
+    f32 lightView = Measure([&]() {
+        f32 sum = 0.0f;
+        viewECS->GetEntitiesWithComponents<const WorldTransformComponent, const PointLightComponent>().each(
+            [&](const WorldTransformComponent& transform, const PointLightComponent& light) {
+                sum += transform.Position.x + light.Radius;
+            });
+        s_Sink = sum;
+    });
+
+    f32 lightGroup = Measure([&]() {
+        f32 sum = 0.0f;
+        groupECS->GetGroup<const PointLightComponent>(entt::get<const WorldTransformComponent>).each(
+            [&](const PointLightComponent& light, const WorldTransformComponent& transform) {
+                sum += transform.Position.x + light.Radius;
+            });
+        s_Sink = sum;
+    });
+
+    f32 rigidBodyView = Measure([&]() {
+        f32 sum = 0.0f;
+        viewECS->GetEntitiesWithComponents<const TransformComponent, const RigidBodyComponent, const BoxColliderComponent>().each(
+            [&](const TransformComponent& transform, const RigidBodyComponent& rigidbody, const BoxColliderComponent& collider) {
+                sum += transform.Position.x + rigidbody.Friction + collider.Scale.x;
+            });
+        s_Sink = sum;
+    });
+
+    f32 rigidBodyGroup = Measure([&]() {
+        f32 sum = 0.0f;
+        auto& colliders = groupECS->GetPool<const BoxColliderComponent>();
+
+        groupECS->GetGroup<const RigidBodyComponent>(entt::get<const TransformComponent>).each(
+            [&](entt::entity entity, const RigidBodyComponent& rigidbody, const TransformComponent& transform) {
+                if (colliders.contains(entity)) {
+                    sum += transform.Position.x + rigidbody.Friction + colliders.get(entity).Scale.x;
+                }
+            });
+        s_Sink = sum;
+    });
+
+    std::printf("%u entities, average of %u iterations (ms)\n", count, s_Iterations);
+    std::printf("%-28s %10s %10s %10s\n", "", "view", "group", "speedup");
+    Print("WorldTransform + Mesh", meshView, meshGroup);
+    Print("PointLight + WorldTransform", lightView, lightGroup);
+    Print("Transform + RigidBody + Box", rigidBodyView, rigidBodyGroup);
+
+    delete viewECS;
+    delete groupECS;
+}
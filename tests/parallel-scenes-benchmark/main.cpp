@@ -0,0 +1,141 @@
+// Headless benchmark for Scene::StepParallel
+// Copies one scene (a hierarchy of transforms plus a pile of falling physics bodies) into many independent
+// single threaded scenes and steps all of them at once with more and more threads, ideally the throughput
+// (scene frames per second) grows linearly with the amount of threads
+// Usage: parallel-scenes-benchmark [scene count] [frames] (defaults to 64 scenes and 300 frames)
+
+#include "blackberry/scene/scene.hpp"
+#include "blackberry/core/thread_pool.hpp"
+#include "blackberry/core/timer.hpp"
+#include "blackberry/core/log.hpp"
+#include "blackberry/physics/physics_engine.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+using namespace Blackberry;
+
+static constexpr u32 s_RootCount = 100; // every root has 9 children
+static constexpr u32 s_ChildrenPerRoot = 9;
+static constexpr u32 s_BodyCount = 100;
+
+static SceneSpecification GetSpecification() {
+    SceneSpecification spec;
+    spec.Headless = true;
+    spec.SingleThreaded = true;
+
+    return spec;
+}
+
+static Ref<Scene> BuildTemplateScene() {
+    Ref<Scene> scene(new Scene(GetSpecification()));
+    ECS* ecs = scene->GetECS();
+
+    for (u32 r = 0; r < s_RootCount; r++) {
+        EntityID root = scene->CreateEntity("Root");
+        ecs->AddComponent<TransformComponent>(root, TransformComponent{});
+
+        u64 rootUUID = ecs->GetComponent<const TagComponent>(root).UUID;
+
+        for (u32 c = 0; c < s_ChildrenPerRoot; c++) {
+            EntityID child = scene->CreateEntity("Child");
+
+            TransformComponent transform;
+            transform.Position = BlVec3(1.0f, 0.0f, 0.0f);
+            ecs->AddComponent<TransformComponent>(child, transform);
+
+            scene->SetEntityParent(ecs->GetComponent<const TagComponent>(child).UUID, rootUUID);
+        }
+    }
+
+    EntityID ground = scene->CreateEntity("Ground");
+    TransformComponent groundTransform;
+    groundTransform.Scale = BlVec3(50.0f, 1.0f, 50.0f);
+    ecs->AddComponent<TransformComponent>(ground, groundTransform);
+    ecs->AddComponent<RigidBodyComponent>(ground, RigidBodyComponent{ RigidBodyType::Static });
+    ecs->AddComponent<BoxColliderComponent>(ground, BoxColliderComponent{});
+
+    for (u32 i = 0; i < s_BodyCount; i++) {
+        EntityID body = scene->CreateEntity("Body");
+
+        TransformComponent transform;
+        transform.Position = BlVec3(static_cast<f32>(i % 10) * 2.5f - 12.5f, 5.0f + static_cast<f32>(i / 10) * 2.5f, 0.0f);
+        transform.Scale = BlVec3(0.5f);
+
+        ecs->AddComponent<TransformComponent>(body, transform);
+        ecs->AddComponent<RigidBodyComponent>(body, RigidBodyComponent{ RigidBodyType::Dynamic });
+        ecs->AddComponent<SphereColliderComponent>(body, SphereColliderComponent{});
+    }
+
+    return scene;
+}
+
+// Returns how long (in milliseconds) stepping every scene frames times took
+static f32 RunBenchmark(Ref<Scene> templateScene, u32 sceneCount, u32 frames, u32 threadCount) {
+    std::vector<Ref<Scene>> scenes;
+    scenes.reserve(sceneCount);
+
+    for (u32 i = 0; i < sceneCount; i++) {
+        // NOTE: Copied into new scenes, Scene::Copy would share the physics world with the template
+        Ref<Scene> scene(new Scene(GetSpecification()));
+        Scene::CopyTo(scene, templateScene);
+        scene->OnRuntimeStart();
+
+        scenes.push_back(scene);
+    }
+
+    ThreadPool pool(threadCount - 1); // - 1 since the calling thread works as well
+
+    Timer timer;
+    timer.Start();
+
+    Scene::StepParallel(scenes, frames, pool);
+
+    f32 ms = timer.ElapsedMilliseconds();
+
+    for (Ref<Scene>& scene : scenes) {
+        scene->OnRuntimeStop();
+        scene->Delete();
+    }
+
+    return ms;
+}
+
+int main(int argc, char** argv) {
+    Logger::GetCoreLogger()->set_level(spdlog::level::warn); // contacts get traced
+
+    PhysicsEngine::Initialize();
+
+    u32 sceneCount = argc > 1 ? static_cast<u32>(std::strtoul(argv[1], nullptr, 10)) : 64;
+    u32 frames = argc > 2 ? static_cast<u32>(std::strtoul(argv[2], nullptr, 10)) : 300;
+
+    u32 maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    std::vector<u32> threadCounts;
+    for (u32 threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    Ref<Scene> templateScene = BuildTemplateScene();
+
+    std::printf("%u scenes, %u entities each, %u frames\n", sceneCount, static_cast<u32>(templateScene->GetEntities().size()), frames);
+    std::printf("%8s %12s %16s %10s %11s\n", "threads", "ms", "scene frames/s", "speedup", "efficiency");
+
+    f32 baseline = 0.0f;
+    for (u32 threads : threadCounts) {
+        f32 ms = RunBenchmark(templateScene, sceneCount, frames, threads);
+        if (threads == 1) baseline = ms;
+
+        f64 throughput = static_cast<f64>(sceneCount) * frames / (ms * 0.001);
+        f32 speedup = baseline / ms;
+
+        std::printf("%8u %12.1f %16.0f %9.2fx %10.0f%%\n", threads, ms, throughput, speedup, speedup / threads * 100.0f);
+    }
+
+    templateScene->Delete();
+
+    PhysicsEngine::Shutdown();
+}
@@ -17,4 +17,175 @@ project "stress-test"
     links { BlackberryLinks }
 
     filter "system:windows"
-        buildoptions { "/utf-8" }
\ No newline at end of file
+        buildoptions { "/utf-8" }
+
+project "transform-benchmark"
+    language "C++"
+    cppdialect "C++20"
+    kind "ConsoleApp"
+    staticruntime "On"
+
+    targetdir ( "../build/bin/" .. OutputDir .. "/%{prj.name}" )
+    objdir ( "../build/obj/" .. OutputDir .. "/%{prj.name}" )
+
+    files { "transform-benchmark/**.cpp", "transform-benchmark/**.hpp" }
+
+    includedirs { "../Blackberry/src/",
+                  "%{BlackberryIncludes.spdlog}",
+                  "%{BlackberryIncludes.glm}",
+                  "%{BlackberryIncludes.entt}"}
+    
+    links { BlackberryLinks }
+
+    filter "system:windows"
+        buildoptions { "/utf-8" }
+
+project "entity-index-benchmark"
+    language "C++"
+    cppdialect "C++20"
+    kind "ConsoleApp"
+    staticruntime "On"
+
+    targetdir ( "../build/bin/" .. OutputDir .. "/%{prj.name}" )
+    objdir ( "../build/obj/" .. OutputDir .. "/%{prj.name}" )
+
+    files { "entity-index-benchmark/**.cpp", "entity-index-benchmark/**.hpp" }
+
+    includedirs { "../Blackberry/src/",
+                  "%{BlackberryIncludes.spdlog}",
+                  "%{BlackberryIncludes.glm}",
+                  "%{BlackberryIncludes.entt}"}
+    
+    links { BlackberryLinks }
+
+    filter "system:windows"
+        buildoptions { "/utf-8" }
+
+project "group-benchmark"
+    language "C++"
+    cppdialect "C++20"
+    kind "ConsoleApp"
+    staticruntime "On"
+
+    targetdir ( "../build/bin/" .. OutputDir .. "/%{prj.name}" )
+    objdir ( "../build/obj/" .. OutputDir .. "/%{prj.name}" )
+
+    files { "group-benchmark/**.cpp", "group-benchmark/**.hpp" }
+
+    includedirs { "../Blackberry/src/",
+                  "%{BlackberryIncludes.spdlog}",
+                  "%{BlackberryIncludes.glm}",
+                  "%{BlackberryIncludes.entt}"}
+    
+    links { BlackberryLinks }
+
+    filter "system:windows"
+        buildoptions { "/utf-8" }
+
+project "component-copy-benchmark"
+    language "C++"
+    cppdialect "C++20"
+    kind "ConsoleApp"
+    staticruntime "On"
+
+    targetdir ( "../build/bin/" .. OutputDir .. "/%{prj.name}" )
+    objdir ( "../build/obj/" .. OutputDir .. "/%{prj.name}" )
+
+    files { "component-copy-benchmark/**.cpp", "component-copy-benchmark/**.hpp" }
+
+    includedirs { "../Blackberry/src/",
+                  "%{BlackberryIncludes.spdlog}",
+                  "%{BlackberryIncludes.glm}",
+                  "%{BlackberryIncludes.entt}"}
+    
+    links { BlackberryLinks }
+
+    filter "system:windows"
+        buildoptions { "/utf-8" }
+
+project "ecs-benchmark"
+    language "C++"
+    cppdialect "C++20"
+    kind "ConsoleApp"
+    staticruntime "On"
+
+    targetdir ( "../build/bin/" .. OutputDir .. "/%{prj.name}" )
+    objdir ( "../build/obj/" .. OutputDir .. "/%{prj.name}" )
+
+    files { "ecs-benchmark/**.cpp", "ecs-benchmark/**.hpp" }
+
+    includedirs { "../Blackberry/src/",
+                  "%{BlackberryIncludes.spdlog}",
+                  "%{BlackberryIncludes.glm}",
+                  "%{BlackberryIncludes.entt}",
+                  "%{BlackberryIncludes.json}"}
+    
+    -- NOTE: Scenes are created headless, so nothing ever opens a window or creates a GL context
+    -- (the libraries still get linked since the engine is a single static library)
+    links { BlackberryLinks }
+
+    filter "system:windows"
+        buildoptions { "/utf-8" }
+
+project "parallel-scenes-benchmark"
+    language "C++"
+    cppdialect "C++20"
+    kind "ConsoleApp"
+    staticruntime "On"
+
+    targetdir ( "../build/bin/" .. OutputDir .. "/%{prj.name}" )
+    objdir ( "../build/obj/" .. OutputDir .. "/%{prj.name}" )
+
+    files { "parallel-scenes-benchmark/**.cpp", "parallel-scenes-benchmark/**.hpp" }
+
+    includedirs { "../Blackberry/src/",
+                  "%{BlackberryIncludes.spdlog}",
+                  "%{BlackberryIncludes.glm}",
+                  "%{BlackberryIncludes.entt}"}
+    
+    links { BlackberryLinks }
+
+    filter "system:windows"
+        buildoptions { "/utf-8" }
+
+project "world-partition-benchmark"
+    language "C++"
+    cppdialect "C++20"
+    kind "ConsoleApp"
+    staticruntime "On"
+
+    targetdir ( "../build/bin/" .. OutputDir .. "/%{prj.name}" )
+    objdir ( "../build/obj/" .. OutputDir .. "/%{prj.name}" )
+
+    files { "world-partition-benchmark/**.cpp", "world-partition-benchmark/**.hpp" }
+
+    includedirs { "../Blackberry/src/",
+                  "%{BlackberryIncludes.spdlog}",
+                  "%{BlackberryIncludes.glm}",
+                  "%{BlackberryIncludes.entt}"}
+    
+    links { BlackberryLinks }
+
+    filter "system:windows"
+        buildoptions { "/utf-8" }
+
+project "culling-benchmark"
+    language "C++"
+    cppdialect "C++20"
+    kind "ConsoleApp"
+    staticruntime "On"
+
+    targetdir ( "../build/bin/" .. OutputDir .. "/%{prj.name}" )
+    objdir ( "../build/obj/" .. OutputDir .. "/%{prj.name}" )
+
+    files { "culling-benchmark/**.cpp", "culling-benchmark/**.hpp" }
+
+    includedirs { "../Blackberry/src/",
+                  "%{BlackberryIncludes.spdlog}",
+                  "%{BlackberryIncludes.glm}",
+                  "%{BlackberryIncludes.entt}"}
+    
+    links { BlackberryLinks }
+
+    filter "system:windows"
+        buildoptions { "/utf-8" }
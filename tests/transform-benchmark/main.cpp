@@ -0,0 +1,133 @@
+// Headless benchmark for Scene::UpdateWorldTransforms
+// Builds scenes of 10k, 100k and 1M entities (or whatever counts get passed on the command line),
+// animates every root each iteration (so every world transform has to be recomputed)
+// and reports how the update time scales with the amount of threads
+
+#include "blackberry/scene/scene.hpp"
+#include "blackberry/core/thread_pool.hpp"
+#include "blackberry/core/timer.hpp"
+#include "blackberry/physics/physics_engine.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+using namespace Blackberry;
+
+// Every root has 9 children which each have 10 children of their own, so a subtree is 100 entities
+static constexpr u32 s_ChildrenPerRoot = 9;
+static constexpr u32 s_LeavesPerChild = 10;
+static constexpr u32 s_SubtreeSize = 1 + s_ChildrenPerRoot + s_ChildrenPerRoot * s_LeavesPerChild;
+
+static u64 CreateTransformEntity(Scene* scene, u64 parent) {
+    u64 uuid = UUID();
+    EntityID entity = scene->CreateEntityWithUUID(uuid);
+
+    TransformComponent transform;
+    transform.Position = BlVec3(1.0f, 0.0f, 0.0f);
+    scene->GetECS()->AddComponent<TransformComponent>(entity, transform);
+
+    if (parent != 0) {
+        scene->SetEntityParent(uuid, parent); // NOTE: This already moves the entity in the hierarchy, no FinishEntityEdit needed
+    }
+
+    return uuid;
+}
+
+static Scene* BuildScene(u32 entityCount) {
+    SceneSpecification spec;
+    spec.Headless = true;
+
+    Scene* scene = new Scene(spec);
+
+    u32 rootCount = (entityCount + s_SubtreeSize - 1) / s_SubtreeSize;
+    for (u32 r = 0; r < rootCount; r++) {
+        u64 root = CreateTransformEntity(scene, 0);
+
+        for (u32 c = 0; c < s_ChildrenPerRoot; c++) {
+            u64 child = CreateTransformEntity(scene, root);
+
+            for (u32 l = 0; l < s_LeavesPerChild; l++) {
+                CreateTransformEntity(scene, child);
+            }
+        }
+    }
+
+    scene->UpdateWorldTransforms(); // first update computes everything, we don't want that in the results
+
+    return scene;
+}
+
+static void AnimateRoots(Scene* scene, f32 time) {
+    ECS* ecs = scene->GetECS();
+
+    for (u64 root : scene->GetRootEntities()) {
+        auto& transform = ecs->GetComponent<TransformComponent>(scene->GetEntityFromUUID(root));
+        transform.Rotation = glm::angleAxis(time, BlVec3(0.0f, 1.0f, 0.0f));
+
+        ecs->MarkChanged<TransformComponent>(scene->GetEntityFromUUID(root));
+    }
+}
+
+// Returns the average time (in milliseconds) of a single UpdateWorldTransforms call
+static f32 RunBenchmark(Scene* scene, u32 threadCount, u32 iterations) {
+    ThreadPool pool(threadCount - 1); // - 1 since the calling thread works as well
+    scene->SetThreadPool(&pool);
+
+    f32 total = 0.0f;
+    for (u32 i = 0; i < iterations; i++) {
+        AnimateRoots(scene, static_cast<f32>(i) * 0.01f + static_cast<f32>(threadCount)); // NOTE: not timed
+
+        Timer timer;
+        timer.Start();
+        scene->UpdateWorldTransforms();
+        total += timer.ElapsedMilliseconds();
+    }
+
+    scene->SetThreadPool(nullptr);
+
+    return total / static_cast<f32>(iterations);
+}
+
+int main(int argc, char** argv) {
+    PhysicsEngine::Initialize(); // every scene owns a physics world
+
+    std::vector<u32> entityCounts = { 10'000, 100'000, 1'000'000 };
+    if (argc > 1) {
+        entityCounts.clear();
+        for (int i = 1; i < argc; i++) {
+            entityCounts.push_back(static_cast<u32>(std::strtoul(argv[i], nullptr, 10)));
+        }
+    }
+
+    u32 maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    std::vector<u32> threadCounts;
+    for (u32 threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    std::printf("%12s %8s %12s %10s\n", "entities", "threads", "ms/update", "speedup");
+
+    for (u32 entityCount : entityCounts) {
+        Scene* scene = BuildScene(entityCount);
+        u32 iterations = std::max(10'000'000u / std::max(entityCount, 1u), 10u);
+
+        f32 baseline = 0.0f;
+        for (u32 threads : threadCounts) {
+            f32 ms = RunBenchmark(scene, threads, iterations);
+            if (threads == 1) baseline = ms;
+
+            std::printf("%12u %8u %12.3f %9.2fx\n", entityCount, threads, ms, baseline / ms);
+        }
+
+        // NOTE: Scene doesn't free its ECS on destruction (see Scene::~Scene)
+        delete scene->GetECS();
+        delete scene->GetPhysicsEngine();
+        delete scene;
+    }
+
+    PhysicsEngine::Shutdown();
+}
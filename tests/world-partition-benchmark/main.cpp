@@ -0,0 +1,190 @@
+// Headless stress test for WorldPartition
+// Builds a grid of entities, splits it into cells with WorldPartition::Build, reopens the persistent scene
+// (which streams the cells in around its camera, see Scene::Create) and flies the camera across the whole map and back,
+// every frame checks that the scene has exactly the entities of the loaded cells and that the memory budget holds
+// Usage: world-partition-benchmark [grid size] [frames] (defaults to a 96x96 grid of roots and 600 frames)
+
+#include "blackberry/scene/scene.hpp"
+#include "blackberry/scene/world_partition.hpp"
+#include "blackberry/core/timer.hpp"
+#include "blackberry/core/log.hpp"
+#include "blackberry/physics/physics_engine.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <filesystem>
+#include <algorithm>
+
+using namespace Blackberry;
+
+static constexpr u32 s_ChildrenPerRoot = 3;
+static constexpr f32 s_Spacing = 4.0f; // between two roots
+static constexpr f32 s_CellSize = 32.0f;
+
+static SceneSpecification GetSpecification() {
+    SceneSpecification spec;
+    spec.Headless = true;
+
+    return spec;
+}
+
+static Ref<Scene> BuildWorld(u32 gridSize) {
+    Ref<Scene> scene(new Scene(GetSpecification()));
+    ECS* ecs = scene->GetECS();
+
+    for (u32 x = 0; x < gridSize; x++) {
+        for (u32 z = 0; z < gridSize; z++) {
+            EntityID root = scene->CreateEntity("Root");
+
+            TransformComponent transform;
+            transform.Position = BlVec3(static_cast<f32>(x) * s_Spacing, 0.0f, static_cast<f32>(z) * s_Spacing);
+            ecs->AddComponent<TransformComponent>(root, transform);
+
+            u64 rootUUID = ecs->GetComponent<const TagComponent>(root).UUID;
+
+            for (u32 c = 0; c < s_ChildrenPerRoot; c++) {
+                EntityID child = scene->CreateEntity("Child");
+
+                TransformComponent childTransform;
+                childTransform.Position = BlVec3(0.0f, 1.0f + static_cast<f32>(c), 0.0f);
+                ecs->AddComponent<TransformComponent>(child, childTransform);
+
+                scene->SetEntityParent(ecs->GetComponent<const TagComponent>(child).UUID, rootUUID);
+            }
+        }
+    }
+
+    // Cameras always go into the persistent scene
+    EntityID camera = scene->CreateEntity("Camera");
+    ecs->AddComponent<TransformComponent>(camera, TransformComponent{});
+    ecs->AddComponent<CameraComponent>(camera, CameraComponent{});
+
+    return scene;
+}
+
+int main(int argc, char** argv) {
+    Logger::GetCoreLogger()->set_level(spdlog::level::warn);
+
+    PhysicsEngine::Initialize();
+
+    u32 gridSize = argc > 1 ? static_cast<u32>(std::strtoul(argv[1], nullptr, 10)) : 96;
+    u32 frames = argc > 2 ? static_cast<u32>(std::strtoul(argv[2], nullptr, 10)) : 600;
+
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "world-partition-benchmark";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    FS::Path partitionDirectory = directory.string();
+
+    Ref<Scene> world = BuildWorld(gridSize);
+
+    Timer buildTimer;
+    buildTimer.Start();
+    WorldPartition::Build(world, partitionDirectory, s_CellSize);
+    f32 buildMs = buildTimer.ElapsedMilliseconds();
+
+    world->Delete();
+
+    Ref<Scene> scene = Scene::Create(partitionDirectory / WorldPartition::s_PersistentFileName, GetSpecification());
+
+    // NOTE: Scene::Create already set up the partition, this only makes the budget small enough to matter
+    // and turns off the asset streaming (there is no project)
+    WorldPartitionSpecification spec;
+    spec.Directory = partitionDirectory;
+    spec.LoadRadius = 48.0f;
+    spec.UnloadRadius = 72.0f;
+    spec.MemoryBudget = 512ull * 1024;
+    spec.StreamAssets = false;
+
+    scene->SetWorldPartition(spec);
+    scene->OnRuntimeStart();
+
+    WorldPartition* partition = scene->GetWorldPartition();
+    ECS* ecs = scene->GetECS();
+
+    u32 persistentCount = static_cast<u32>(ecs->GetPool<const TagComponent>().size());
+    EntityID camera = scene->GetEntity("Camera");
+
+    std::printf("%u cells, %u entities, built in %.1f ms\n", static_cast<u32>(partition->GetCells().size()), gridSize * gridSize * (1 + s_ChildrenPerRoot), buildMs);
+
+    std::vector<WorldPartition::CellState> states(partition->GetCells().size(), WorldPartition::CellState::Unloaded);
+    u32 loads = 0;
+    u32 unloads = 0;
+    u32 peakCells = 0;
+    u64 peakBytes = 0;
+    f32 totalMs = 0.0f;
+    f32 maxMs = 0.0f;
+    u32 errors = 0;
+
+    f32 worldSize = static_cast<f32>(gridSize) * s_Spacing;
+
+    for (u32 frame = 0; frame < frames; frame++) {
+        // Diagonally across the map and back again
+        f32 t = static_cast<f32>(frame) / static_cast<f32>(std::max(frames - 1, 1u));
+        f32 along = (t < 0.5f ? t * 2.0f : 2.0f - t * 2.0f) * worldSize;
+        ecs->GetComponent<TransformComponent>(camera).Position = BlVec3(along, 10.0f, along);
+        ecs->MarkChanged<TransformComponent>(camera);
+
+        Timer timer;
+        timer.Start();
+
+        scene->Step();
+
+        f32 ms = timer.ElapsedMilliseconds();
+        totalMs += ms;
+        maxMs = std::max(maxMs, ms);
+
+        const std::vector<WorldPartition::Cell>& cells = partition->GetCells();
+        u32 expected = persistentCount;
+
+        for (u32 i = 0; i < cells.size(); i++) {
+            if (states[i] != WorldPartition::CellState::Loaded && cells[i].State == WorldPartition::CellState::Loaded) loads++;
+            if (states[i] == WorldPartition::CellState::Loaded && cells[i].State != WorldPartition::CellState::Loaded) unloads++;
+
+            states[i] = cells[i].State;
+
+            if (cells[i].State == WorldPartition::CellState::Loaded) {
+                expected += static_cast<u32>(cells[i].Roots.size()) * (1 + s_ChildrenPerRoot);
+            }
+        }
+
+        u32 entityCount = static_cast<u32>(ecs->GetPool<const TagComponent>().size());
+        if (entityCount != expected) {
+            std::printf("frame %u: the scene has %u entities, the loaded cells add up to %u\n", frame, entityCount, expected);
+            errors++;
+        }
+
+        if (partition->GetLoadedBytes() > spec.MemoryBudget) {
+            std::printf("frame %u: %llu bytes loaded, the budget is %llu\n", frame, static_cast<unsigned long long>(partition->GetLoadedBytes()), static_cast<unsigned long long>(spec.MemoryBudget));
+            errors++;
+        }
+
+        peakCells = std::max(peakCells, partition->GetLoadedCellCount());
+        peakBytes = std::max(peakBytes, partition->GetLoadedBytes());
+    }
+
+    std::printf("%u frames: %.3f ms average, %.3f ms worst\n", frames, totalMs / static_cast<f32>(frames), maxMs);
+    std::printf("%u cell loads, %u cell unloads, at most %u cells (%.1f KB) loaded at once\n", loads, unloads, peakCells, static_cast<f32>(peakBytes) / 1024.0f);
+
+    if (loads == 0 || unloads == 0) {
+        std::printf("the camera never made the partition load and unload cells\n");
+        errors++;
+    }
+
+    scene->OnRuntimeStop();
+    scene->Delete();
+
+    std::filesystem::remove_all(directory);
+
+    PhysicsEngine::Shutdown();
+
+    if (errors != 0) {
+        std::printf("FAILED (%u errors)\n", errors);
+        return 1;
+    }
+
+    std::printf("OK\n");
+    return 0;
+}